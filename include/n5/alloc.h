@@ -16,6 +16,7 @@ typedef struct Block Block;
 typedef struct DebugInfo DebugInfo;
 typedef struct AllocInfo AllocInfo;
 typedef struct FreeInfo FreeInfo;
+typedef struct ResizeInfo ResizeInfo;
 
 typedef struct Arena Arena;
 
@@ -25,6 +26,8 @@ typedef struct TestAllocHeader TestAllocHeader;
 struct IAllocator {
     Block (*alloc)(Allocator* self, const AllocInfo* info);
     void (*free)(Allocator* self, const FreeInfo* info);
+    // optional: resizes 'memory' in place, returning false if it would need to move.
+    bool (*resize)(Allocator* self, const ResizeInfo* info);
 };
 
 struct Block {
@@ -48,6 +51,12 @@ struct FreeInfo {
     DebugInfo debugInfo;
 };
 
+struct ResizeInfo {
+    Block memory;
+    size_t size;
+    DebugInfo debugInfo;
+};
+
 #define Allocator_alloc(self, type, count) ( \
     assert((self) != NULL), \
     assert(*(self) != NULL), \
@@ -71,6 +80,17 @@ struct FreeInfo {
     }) \
 )
 
+#define Allocator_resize(self, mem, type, count) ( \
+    assert((self) != NULL), \
+    assert((*(self)) != NULL), \
+    assert((mem).data != NULL), \
+    ((*(self))->resize != NULL) && (*(self))->resize((self), &(ResizeInfo) { \
+        .memory = (mem), \
+        .size = sizeof(type) * (count), \
+        .debugInfo = { .file = __FILE__, .line = __LINE__ } \
+    }) \
+)
+
 #define Allocator_createItem(self, type) Allocator_alloc((self), type, 1).data
 
 #define Allocator_destroyItem(self, item) Allocator_free((self), ((Block) { \
@@ -104,6 +124,7 @@ void Arena_deinit(Arena* self);
 void Arena_reset(Arena* self);
 Block Arena_alloc(Allocator* self, const AllocInfo* info);
 void Arena_free(Allocator* self, const FreeInfo* info);
+bool Arena_resize(Allocator* self, const ResizeInfo* info);
 
 struct TestAlloc {
     Allocator base;
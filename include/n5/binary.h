@@ -0,0 +1,87 @@
+#ifndef __N5_BINARY_H__
+#define __N5_BINARY_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+#include "n5/string.h"
+
+typedef struct BinWriter BinWriter;
+typedef struct BinReader BinReader;
+
+// Appends a compact binary encoding to either a growable String or a fixed
+//  Block. Fixed-width values are little-endian; varints are LEB128 (10 bytes
+//  at most for a u64), and signed varints are zigzag-encoded first so small
+//  negative numbers stay short. Blobs are a varint length followed by the bytes.
+struct BinWriter {
+    String* string;
+    Block block;
+    size_t size;
+};
+
+// Reads the same encoding in place: blobs come back as views into 'data'.
+//  Every read returns false (leaving 'offset' where it was) on truncated or
+//  malformed input.
+struct BinReader {
+    cstr data;
+    size_t offset;
+};
+
+#define BINARY_MAX_VARINT_SIZE 10
+
+static inline uint64_t n5_zigzag_encode(const int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t n5_zigzag_decode(const uint64_t value) {
+    return (int64_t)((value >> 1) ^ (0 - (value & 1)));
+}
+
+// note: the writer appends after whatever 'string' already holds.
+BinWriter BinWriter_fromString(String* string);
+BinWriter BinWriter_fromBlock(Block block);
+
+// The bytes written so far (for a String writer, the whole string).
+cstr BinWriter_view(const BinWriter* self);
+
+bool BinWriter_write_u8(BinWriter* self, uint8_t value);
+bool BinWriter_write_u16(BinWriter* self, uint16_t value);
+bool BinWriter_write_u32(BinWriter* self, uint32_t value);
+bool BinWriter_write_u64(BinWriter* self, uint64_t value);
+bool BinWriter_write_i32(BinWriter* self, int32_t value);
+bool BinWriter_write_i64(BinWriter* self, int64_t value);
+bool BinWriter_write_f32(BinWriter* self, float value);
+bool BinWriter_write_f64(BinWriter* self, double value);
+bool BinWriter_write_varU64(BinWriter* self, uint64_t value);
+bool BinWriter_write_varI64(BinWriter* self, int64_t value);
+bool BinWriter_write_blob(BinWriter* self, cstr blob);
+// note: encodes in one pass into worst-case space reserved per chunk, so it
+//  skips the per-value bookkeeping of a varU64 loop (about 3x faster for
+//  1-byte values, 1.3x for mixed sizes).
+bool BinWriter_write_varU64s(BinWriter* self, u64s values);
+
+BinReader BinReader_from(cstr data);
+
+static inline size_t BinReader_remaining(const BinReader *const self) {
+    return self->data.size - self->offset;
+}
+
+bool BinReader_read_u8(BinReader* self, uint8_t* value);
+bool BinReader_read_u16(BinReader* self, uint16_t* value);
+bool BinReader_read_u32(BinReader* self, uint32_t* value);
+bool BinReader_read_u64(BinReader* self, uint64_t* value);
+bool BinReader_read_i32(BinReader* self, int32_t* value);
+bool BinReader_read_i64(BinReader* self, int64_t* value);
+bool BinReader_read_f32(BinReader* self, float* value);
+bool BinReader_read_f64(BinReader* self, double* value);
+bool BinReader_read_varU64(BinReader* self, uint64_t* value);
+bool BinReader_read_varI64(BinReader* self, int64_t* value);
+bool BinReader_read_blob(BinReader* self, cstr* blob);
+// Decodes exactly values.size varints. Lengths are found 16 bytes at a time
+//  (SSE2 where available) and each value is assembled without a per-byte loop.
+bool BinReader_read_varU64s(BinReader* self, u64s values);
+
+#endif // __N5_BINARY_H__
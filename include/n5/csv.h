@@ -0,0 +1,78 @@
+#ifndef __N5_CSV_H__
+#define __N5_CSV_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+#include "n5/string.h"
+
+typedef struct CsvScanner CsvScanner;
+typedef struct CsvReader CsvReader;
+typedef struct CsvRecord CsvRecord;
+
+// Bitmask state for one pass over the input, 64 bytes at a time: every
+//  delimiter and newline outside quotes ends a field.
+struct CsvScanner {
+    size_t base;
+    bool loaded;
+    uint64_t separators;
+    uint64_t newlines;
+    uint64_t inQuotes;
+};
+
+// Splits delimited text (CSV, TSV) into records, fed one chunk at a time
+//  (e.g. an mmap'd file, or successive buffers from a read loop). Fields are
+//  views into the chunk; the only copies are of fields containing escaped
+//  quotes (unescaped into 'arena') and of records that straddle two chunks
+//  (stitched together in an internal buffer).
+//  Quoting follows RFC 4180: a field may be wrapped in quotes to hold
+//  delimiters and newlines, and "" inside it stands for one quote. Both \n
+//  and \r\n end a record, and blank lines are skipped. Malformed quoting is
+//  passed through rather than rejected.
+struct CsvReader {
+    Allocator* owner;
+    Arena* arena;
+    char delimiter;
+    bool quoting;
+    cstr chunk;
+    bool last;
+    size_t position;
+    CsvScanner scanner;
+    cstrs fields;
+    String carry;
+    uint64_t carryQuotes;
+    bool carryReady;
+    bool carryEmitted;
+    // note: set when the arena runs out; CsvReader_next returns false from then on.
+    bool failed;
+};
+
+// One record; the fields are valid until the next call to CsvReader_next or
+//  CsvReader_feed, and for as long as the chunk (and the arena) they came from.
+struct CsvRecord {
+    cstrs fields;
+};
+
+// note: pass quoting = false for TSV-style input where quotes are ordinary bytes.
+bool CsvReader_init(CsvReader* self, Allocator* owner, Arena* arena, char delimiter, bool quoting);
+void CsvReader_deinit(CsvReader* self);
+
+// Hands the reader its next chunk; call it once CsvReader_next has returned
+//  false. 'last' marks the end of the input, so a final record without a
+//  trailing newline is still returned.
+void CsvReader_feed(CsvReader* self, cstr chunk, bool last);
+
+// Returns false once the chunk has no complete record left: feed the next
+//  one, or stop if that was the last.
+bool CsvReader_next(CsvReader* self, CsvRecord* record);
+
+// note: a missing field reads as empty.
+cstr CsvRecord_field(const CsvRecord* self, size_t index);
+// note: both fail on missing or empty fields as well as on bad numbers.
+bool CsvRecord_tryParse_u64(const CsvRecord* self, size_t index, uint64_t* val);
+bool CsvRecord_tryParse_i64(const CsvRecord* self, size_t index, int64_t* val);
+
+#endif // __N5_CSV_H__
@@ -0,0 +1,81 @@
+#ifndef __N5_ENCODING_H__
+#define __N5_ENCODING_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+#include "n5/string.h"
+
+typedef struct DecodeResult DecodeResult;
+
+typedef enum Base64Alphabet {
+    // RFC 4648 with '+' and '/', padded with '=' to a multiple of 4 chars.
+    base64_standard,
+    // The URL- and filename-safe variant with '-' and '_', unpadded.
+    base64_url,
+} Base64Alphabet;
+
+typedef enum DecodeError {
+    decode_ok,
+    // A char outside the alphabet (including whitespace and '=' before the end).
+    decode_invalid_char,
+    // The text stops partway through a byte: an odd number of hex digits, or a
+    //  single base64 char after the last full group.
+    decode_truncated,
+    // Too many '=' or padding that doesn't complete the last group.
+    decode_bad_padding,
+    // The destination is smaller than the decoded size; nothing was written.
+    decode_no_space,
+} DecodeError;
+
+// Where and why decoding stopped. On failure the bytes before the error are
+//  still written: 'size' counts them, and 'offset' is the position in the text
+//  of the char that was rejected (or where the text ran out).
+struct DecodeResult {
+    DecodeError error;
+    size_t size;
+    size_t offset;
+};
+
+static inline size_t Hex_encodedSize(const size_t size) {
+    return size * 2;
+}
+
+static inline size_t Hex_decodedSize(const size_t textSize) {
+    return textSize / 2;
+}
+
+static inline size_t Base64_encodedSize(const size_t size, const Base64Alphabet alphabet) {
+    if (alphabet == base64_standard) {
+        return ((size + 2) / 3) * 4;
+    }
+    // note: unpadded, a trailing 1 or 2 bytes take 2 or 3 chars.
+    return (size / 3) * 4 + ((size % 3 != 0) ? size % 3 + 1 : 0);
+}
+
+// note: an upper bound, exact for unpadded text; padding only makes it smaller.
+static inline size_t Base64_decodedSize(const size_t textSize) {
+    return (textSize / 4) * 3 + (textSize % 4) * 3 / 4;
+}
+
+// Appends 'bytes' as hex digits (two per byte) to 'out', reserving space once.
+//  Returns false if 'out' can't grow, leaving it unchanged.
+bool Hex_encode(String* out, cstr bytes, bool upper);
+// Decodes hex digits in either case into 'dest'.
+DecodeResult Hex_decode(cstr text, Block dest);
+
+// Appends 'bytes' as base64 to 'out', reserving space once.
+bool Base64_encode(String* out, cstr bytes, Base64Alphabet alphabet);
+// Decodes base64 in 'alphabet' into 'dest'. Padding is optional in either
+//  alphabet, but must be complete when present; the unused low bits of the
+//  last char aren't checked.
+DecodeResult Base64_decode(cstr text, Block dest, Base64Alphabet alphabet);
+
+// The decoders, writing into a str (e.g. a String's buffer) instead of a Block.
+#define Hex_decodeTo(text, dest) Hex_decode((text), ((Block) { .data = (dest).data, .size = (dest).size }))
+#define Base64_decodeTo(text, dest, alphabet) Base64_decode((text), ((Block) { .data = (dest).data, .size = (dest).size }), (alphabet))
+
+#endif // __N5_ENCODING_H__
@@ -6,6 +6,25 @@
 typedef struct FormatArg FormatArg;
 typedef Slice(const FormatArg) FormatArgs;
 
+typedef struct FormatCustom FormatCustom;
+typedef struct FormatSlice FormatSlice;
+
+// Appends a user-defined value to 'self'; 'ctx' is passed through unchanged.
+typedef bool (*FormatFn)(String* self, const void* ctx);
+
+struct FormatCustom {
+    FormatFn fn;
+    const void* ctx;
+};
+
+struct FormatSlice {
+    const void* data;
+    size_t size;
+    size_t stride;
+    FormatFn item;
+    cstr separator;
+};
+
 struct FormatArg {
     enum {
         fmt_str,
@@ -14,6 +33,7 @@ struct FormatArg {
         fmt_u64,
         fmt_f64,
         fmt_boolean,
+        fmt_custom,
     } type;
     union {
         cstr str;
@@ -22,6 +42,7 @@ struct FormatArg {
         uint64_t u64;
         double f64;
         bool boolean;
+        FormatCustom custom;
     };
 };
 
@@ -40,6 +61,19 @@ static inline FormatArg FormatArg_i64(int64_t val) { return (FormatArg) { .type
 static inline FormatArg FormatArg_u64(uint64_t val) { return (FormatArg) { .type = fmt_u64, .u64 = val }; }
 static inline FormatArg FormatArg_f64(double val) { return (FormatArg) { .type = fmt_f64, .f64 = val }; }
 static inline FormatArg FormatArg_bool(bool val) { return (FormatArg) { .type = fmt_boolean, .boolean = val }; }
+static inline FormatArg FormatArg_custom(FormatFn fn, const void* ctx) {
+    return (FormatArg) { .type = fmt_custom, .custom = { .fn = fn, .ctx = ctx } };
+}
+
+// Formats each item of 'slice' with 'fn' (which receives a pointer to the item),
+//  separated by 'sep'. The FormatSlice lives until the end of the enclosing block.
+#define FormatArg_slice(slice, fn, sep) FormatArg_custom(Format_slice, &(FormatSlice) { \
+    .data = (slice).data, \
+    .size = (slice).size, \
+    .stride = sizeof((slice).data[0]), \
+    .item = (fn), \
+    .separator = (sep) \
+})
 
 #define String_format(self, format, ...) String_format_raw( \
     (self), \
@@ -49,4 +83,12 @@ static inline FormatArg FormatArg_bool(bool val) { return (FormatArg) { .type =
 
 bool String_format_raw(String* self, cstr format, FormatArgs args);
 
+bool Format_slice(String* self, const void* ctx);
+bool Format_str(String* self, const void* item);
+bool Format_char(String* self, const void* item);
+bool Format_i64(String* self, const void* item);
+bool Format_u64(String* self, const void* item);
+bool Format_f64(String* self, const void* item);
+bool Format_bool(String* self, const void* item);
+
 #endif // __N5_FORMAT_H__
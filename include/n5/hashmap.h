@@ -0,0 +1,68 @@
+#ifndef __N5_HASHMAP_H__
+#define __N5_HASHMAP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+
+typedef struct HashMap HashMap;
+
+typedef enum HashKey {
+    hash_key_u64,
+    hash_key_cstr,
+} HashKey;
+
+// An open-addressing hash table with one control byte per slot, probed 16 slots
+//  at a time (SSE2 where available). Probing is linear, so removal shifts later
+//  entries back instead of leaving tombstones.
+//  cstr keys are copied into the owner allocator; values are stored inline
+//  (aligned to 8 bytes) and are zeroed on insertion.
+struct HashMap {
+    Allocator* owner;
+    HashKey keyKind;
+    size_t valueSize;
+    size_t slotSize;
+    size_t capacity;
+    size_t size;
+    size_t growthLeft;
+    Block memory;
+    uint8_t* slots;
+    int8_t* ctrl;
+};
+
+#define HashMap_get(self, key) _Generic((key), \
+    uint64_t: HashMap_get_u64, \
+    cstr: HashMap_get_cstr \
+)((self), (key))
+
+#define HashMap_insert(self, key) _Generic((key), \
+    uint64_t: HashMap_insert_u64, \
+    cstr: HashMap_insert_cstr \
+)((self), (key))
+
+#define HashMap_remove(self, key) _Generic((key), \
+    uint64_t: HashMap_remove_u64, \
+    cstr: HashMap_remove_cstr \
+)((self), (key))
+
+void HashMap_init(HashMap* self, Allocator* owner, HashKey keyKind, size_t valueSize);
+void HashMap_deinit(HashMap* self);
+void HashMap_clear(HashMap* self);
+
+bool HashMap_reserve(HashMap* self, size_t count);
+
+void* HashMap_get_u64(const HashMap* self, uint64_t key);
+void* HashMap_get_cstr(const HashMap* self, cstr key);
+
+// Returns the value for 'key', inserting a zeroed value if it isn't present
+//  (or NULL if allocation fails).
+void* HashMap_insert_u64(HashMap* self, uint64_t key);
+void* HashMap_insert_cstr(HashMap* self, cstr key);
+
+bool HashMap_remove_u64(HashMap* self, uint64_t key);
+bool HashMap_remove_cstr(HashMap* self, cstr key);
+
+#endif // __N5_HASHMAP_H__
@@ -0,0 +1,46 @@
+#ifndef __N5_IO_H__
+#define __N5_IO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+
+typedef struct LineReader LineReader;
+
+typedef enum FileAdvice {
+    file_advice_normal = 0,
+    // the view will be read front to back, so read ahead aggressively.
+    file_advice_sequential = 1 << 0,
+    // the whole view will be needed soon, so start paging it in now.
+    file_advice_willneed = 1 << 1,
+} FileAdvice;
+
+// Maps 'path' read-only into memory, returning a view with data == NULL on failure.
+//  advice is a combination of FileAdvice flags; it's only a hint.
+cstr n5_file_map(const char* path, int advice);
+void n5_file_unmap(cstr view);
+
+// Yields delimiter-separated records from 'file' as views into an internal
+//  buffer; a view is only valid until the next call. The buffer grows (from
+//  'owner') when a record is longer than it, so any record length works.
+struct LineReader {
+    Allocator* owner;
+    FILE* file;
+    Block buffer;
+    size_t start;
+    size_t end;
+    char delimiter;
+    bool eof;
+};
+
+bool LineReader_init(LineReader* self, Allocator* owner, FILE* file, size_t bufferSize, char delimiter);
+void LineReader_deinit(LineReader* self);
+
+// Returns false once the input is exhausted (or a read fails); the final record
+//  doesn't need a trailing delimiter.
+bool LineReader_next(LineReader* self, cstr* record);
+
+#endif // __N5_IO_H__
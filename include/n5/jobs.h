@@ -0,0 +1,93 @@
+#ifndef __N5_JOBS_H__
+#define __N5_JOBS_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "n5/alloc.h"
+#include "n5/slice.h"
+#include "n5/utils.h"
+
+typedef struct Job Job;
+typedef struct JobDeque JobDeque;
+typedef struct JobWorker JobWorker;
+typedef struct JobSystem JobSystem;
+typedef struct WaitGroup WaitGroup;
+
+// 'begin' and 'end' are only meaningful for parallel-for chunks.
+typedef void (*JobFn)(JobWorker* worker, void* ctx, size_t begin, size_t end);
+
+struct Job {
+    JobFn fn;
+    void* ctx;
+    size_t begin;
+    size_t end;
+    WaitGroup* group;
+};
+
+struct WaitGroup {
+    atomic_size_t pending;
+};
+
+// A fixed-capacity Chase-Lev deque: the owning worker pushes and pops at the
+//  bottom, while other workers steal from the top.
+struct JobDeque {
+    _Atomic(int64_t) top;
+    uint8_t padTop[N5_CACHE_LINE_SIZE - sizeof(_Atomic(int64_t))];
+    _Atomic(int64_t) bottom;
+    uint8_t padBottom[N5_CACHE_LINE_SIZE - sizeof(_Atomic(int64_t))];
+    _Atomic(Job*)* buffer;
+    int64_t mask;
+};
+
+// Worker 0 is the thread that called JobSystem_init; it runs jobs while it waits.
+//  'arena' is private to the worker and can be used for job-local temporaries
+//  until the next JobSystem_resetArenas.
+struct JobWorker {
+    JobSystem* system;
+    size_t index;
+    JobDeque deque;
+    Arena arena;
+    uint64_t rng;
+    thrd_t thread;
+};
+
+// note: the owner allocator is only used by init/deinit.
+struct JobSystem {
+    Allocator* owner;
+    Slice(JobWorker) workers;
+    atomic_size_t queued;
+    atomic_size_t sleeping;
+    atomic_bool running;
+    mtx_t lock;
+    cnd_t wake;
+};
+
+static inline void WaitGroup_init(WaitGroup* self) { atomic_init(&self->pending, 0); }
+
+bool JobSystem_init(JobSystem* self, Allocator* owner, size_t threadCount, size_t arenaSize);
+void JobSystem_deinit(JobSystem* self);
+
+// Returns the worker running on the calling thread, or NULL if it isn't part of 'self'.
+JobWorker* JobSystem_currentWorker(const JobSystem* self);
+
+// Queues 'job' on the calling worker; 'job' must stay alive until its group is waited on.
+void JobSystem_submit(JobSystem* self, Job* job, WaitGroup* group);
+
+// Runs (or steals) other jobs until every job in 'group' has finished.
+void JobSystem_wait(JobSystem* self, WaitGroup* group);
+
+// Splits [0, count) into chunks of at least 'grain' items and runs them across all
+//  workers, returning once every chunk has finished.
+void JobSystem_parallelFor(JobSystem* self, size_t count, size_t grain, JobFn fn, void* ctx);
+
+#define JobSystem_parallelForSlice(self, slice, grain, fn, ctx) \
+    JobSystem_parallelFor((self), (slice).size, (grain), (fn), (ctx))
+
+// Resets every worker arena; only valid while no jobs are in flight.
+void JobSystem_resetArenas(JobSystem* self);
+
+#endif // __N5_JOBS_H__
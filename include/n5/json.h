@@ -0,0 +1,113 @@
+#ifndef __N5_JSON_H__
+#define __N5_JSON_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+#include "n5/string.h"
+
+typedef struct JsonNode JsonNode;
+typedef struct JsonDoc JsonDoc;
+typedef struct JsonWriter JsonWriter;
+
+typedef enum JsonType {
+    json_null,
+    json_bool,
+    json_i64,
+    // note: only integers above INT64_MAX; everything that fits is json_i64.
+    json_u64,
+    json_f64,
+    json_string,
+    json_array,
+    json_object,
+} JsonType;
+
+// One entry of the tape: values are laid out in document order, so the first
+//  child of a container is the node right after it and 'next' skips a whole
+//  subtree. Object members are a string node (the key) followed by the value.
+struct JsonNode {
+    uint8_t type;
+    // note: set for strings that had escapes; they live in the doc's string buffer.
+    bool unescaped;
+    uint32_t next;
+    union {
+        bool boolean;
+        int64_t i64;
+        uint64_t u64;
+        double f64;
+        struct {
+            uint32_t offset;
+            uint32_t size;
+        } string;
+        // note: elements of an array, members of an object.
+        uint32_t count;
+    };
+};
+
+// A parsed document. Parsing is two passes: a SIMD pass classifies 64 bytes
+//  at a time into bitmasks and records the position of every structural
+//  character, then a scalar pass walks those positions and builds the tape.
+//  Everything is allocated from the arena; strings without escapes point
+//  straight into 'input', which must outlive the document.
+//  Limits: documents up to 4GB, nesting up to JSON_MAX_DEPTH. UTF-8 isn't
+//  validated and control characters inside strings are accepted.
+//  note: this isn't a GB/s parser. On the 3.4MB log-style bench document the
+//  first pass runs at about 1.7-2.5GB/s (AVX-512), but the full parse
+//  reaches about 550-850MB/s: roughly 0.95x, i.e. still slower than, a byte
+//  loop that only counts structurals and builds nothing. Two thirds of the
+//  time is the second pass, and dispatching on each index alone is half of that.
+struct JsonDoc {
+    cstr input;
+    const JsonNode* nodes;
+    size_t count;
+    const char* strings;
+};
+
+// Builds JSON text into a String. Separators are inserted automatically; the
+//  caller is responsible for balancing begin/end and pairing keys with values.
+struct JsonWriter {
+    String* out;
+    bool needsComma;
+};
+
+#define JSON_MAX_DEPTH 1024
+
+// An arena of this size can hold any document of 'inputSize' bytes; typical
+//  documents need well under half of it.
+size_t JsonDoc_arenaSize(size_t inputSize);
+bool JsonDoc_parse(JsonDoc* self, Arena* arena, cstr input);
+
+static inline const JsonNode* JsonDoc_root(const JsonDoc *const self) {
+    return &self->nodes[0];
+}
+
+static inline const JsonNode* JsonDoc_next(const JsonDoc *const self, const JsonNode *const node) {
+    return &self->nodes[node->next];
+}
+
+cstr JsonDoc_string(const JsonDoc* self, const JsonNode* node);
+// note: both return NULL if there's no such member/element (or 'node' is the wrong type).
+const JsonNode* JsonDoc_find(const JsonDoc* self, const JsonNode* object, cstr key);
+const JsonNode* JsonDoc_at(const JsonDoc* self, const JsonNode* array, size_t index);
+
+// note: the writer appends after whatever 'out' already holds.
+JsonWriter JsonWriter_from(String* out);
+
+bool JsonWriter_beginObject(JsonWriter* self);
+bool JsonWriter_endObject(JsonWriter* self);
+bool JsonWriter_beginArray(JsonWriter* self);
+bool JsonWriter_endArray(JsonWriter* self);
+bool JsonWriter_key(JsonWriter* self, cstr key);
+
+bool JsonWriter_write_str(JsonWriter* self, cstr value);
+bool JsonWriter_write_i64(JsonWriter* self, int64_t value);
+bool JsonWriter_write_u64(JsonWriter* self, uint64_t value);
+// note: always reads back as the same double; NaN and infinities are written as null.
+bool JsonWriter_write_f64(JsonWriter* self, double value);
+bool JsonWriter_write_bool(JsonWriter* self, bool value);
+bool JsonWriter_write_null(JsonWriter* self);
+
+#endif // __N5_JSON_H__
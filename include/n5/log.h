@@ -0,0 +1,79 @@
+#ifndef __N5_LOG_H__
+#define __N5_LOG_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <threads.h>
+
+#include "n5/alloc.h"
+#include "n5/format.h"
+#include "n5/utils.h"
+
+typedef struct Logger Logger;
+typedef struct LogProducer LogProducer;
+typedef struct LogRecord LogRecord;
+
+typedef enum LogOverflow {
+    // spin until the consumer frees enough space.
+    log_overflow_block,
+    // silently discard the record.
+    log_overflow_drop,
+    // discard the record, but report the number of dropped records in the output.
+    log_overflow_count,
+} LogOverflow;
+
+// note: the logger's allocator is only ever touched by the consumer thread
+//  (and by init/deinit), so it doesn't need to be thread-safe.
+struct Logger {
+    Allocator* owner;
+    FILE* file;
+    LogOverflow overflow;
+    size_t batchSize;
+    String line;
+    String batch;
+    mtx_t lock;
+    LogProducer* producers;
+    thrd_t thread;
+    atomic_bool running;
+};
+
+// A single-producer/single-consumer byte ring owned by one logging thread.
+//  Records are written as a LogRecord header followed by the FormatArg array
+//  and any copied fmt_str payloads, so the caller never formats anything.
+struct LogProducer {
+    Logger* logger;
+    Allocator* owner;
+    Block buffer;
+    size_t mask;
+    LogProducer* next;
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t head;
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t tail;
+    atomic_size_t dropped;
+};
+
+struct LogRecord {
+    size_t size;
+    cstr format;
+    size_t argCount;
+};
+
+#define Log_write(self, format, ...) Log_write_raw( \
+    (self), \
+    (format), \
+    (FormatArgs)Slice_fromArray(((FormatArg[]) { __VA_ARGS__ })) \
+)
+
+bool Logger_init(Logger* self, Allocator* owner, FILE* file, LogOverflow overflow);
+void Logger_deinit(Logger* self);
+
+bool LogProducer_init(LogProducer* self, Logger* logger, Allocator* owner, size_t capacity);
+void LogProducer_deinit(LogProducer* self);
+
+// note: only the format pointer is captured, so it must outlive the record
+//  (i.e. a literal); fmt_str payloads are copied into the ring.
+//  fmt_custom arguments are rejected, since their context isn't copyable.
+bool Log_write_raw(LogProducer* self, cstr format, FormatArgs args);
+
+#endif // __N5_LOG_H__
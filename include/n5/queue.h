@@ -0,0 +1,94 @@
+#ifndef __N5_QUEUE_H__
+#define __N5_QUEUE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "n5/alloc.h"
+#include "n5/utils.h"
+
+typedef struct SpscQueue SpscQueue;
+typedef struct MpmcQueue MpmcQueue;
+
+// A bounded single-producer/single-consumer ring of fixed-size items. Both
+//  sides are wait-free: each owns one index and only reads the other's when
+//  its cached copy says the ring looks full (or empty).
+struct SpscQueue {
+    Allocator* owner;
+    Block buffer;
+    size_t itemSize;
+    size_t mask;
+    // note: written by the producer.
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t head;
+    size_t cachedTail;
+    // note: written by the consumer.
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t cachedHead;
+};
+
+// A bounded multi-producer/multi-consumer ring (Dmitry Vyukov's design): every
+//  cell carries a sequence number saying whose turn it is, so producers and
+//  consumers only contend on their own index, with one CAS per operation (or
+//  per batch). Items are copied in and out of the cells.
+struct MpmcQueue {
+    Allocator* owner;
+    Block buffer;
+    size_t itemSize;
+    size_t cellSize;
+    size_t mask;
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t head;
+    alignas(N5_CACHE_LINE_SIZE) atomic_size_t tail;
+};
+
+#define SpscQueue_pushSlice(self, slice) ( \
+    assert(sizeof((slice).data[0]) == (self)->itemSize), \
+    SpscQueue_pushBatch((self), (slice).data, (slice).size) \
+)
+#define SpscQueue_popSlice(self, slice) ( \
+    assert(sizeof((slice).data[0]) == (self)->itemSize), \
+    SpscQueue_popBatch((self), (slice).data, (slice).size) \
+)
+#define MpmcQueue_pushSlice(self, slice) ( \
+    assert(sizeof((slice).data[0]) == (self)->itemSize), \
+    MpmcQueue_pushBatch((self), (slice).data, (slice).size) \
+)
+#define MpmcQueue_popSlice(self, slice) ( \
+    assert(sizeof((slice).data[0]) == (self)->itemSize), \
+    MpmcQueue_popBatch((self), (slice).data, (slice).size) \
+)
+
+// note: 'capacity' is rounded up to a power of two.
+bool SpscQueue_init(SpscQueue* self, Allocator* owner, size_t capacity, size_t itemSize);
+void SpscQueue_deinit(SpscQueue* self);
+
+// note: both return false (without waiting) if the queue is full / empty.
+bool SpscQueue_push(SpscQueue* self, const void* item);
+bool SpscQueue_pop(SpscQueue* self, void* item);
+
+// Push or pop up to 'count' contiguous items with a single index update,
+//  returning how many were moved.
+size_t SpscQueue_pushBatch(SpscQueue* self, const void* items, size_t count);
+size_t SpscQueue_popBatch(SpscQueue* self, void* items, size_t count);
+
+// note: a snapshot; only exact when called from the producer or consumer thread.
+size_t SpscQueue_size(SpscQueue* self);
+
+// note: 'capacity' is rounded up to a power of two (at least 2).
+bool MpmcQueue_init(MpmcQueue* self, Allocator* owner, size_t capacity, size_t itemSize);
+void MpmcQueue_deinit(MpmcQueue* self);
+
+bool MpmcQueue_push(MpmcQueue* self, const void* item);
+bool MpmcQueue_pop(MpmcQueue* self, void* item);
+
+// Claim up to 'count' cells with one CAS, returning how many were moved.
+//  note: a claimed cell may still be in use by a thread from the previous lap
+//  (a consumer still copying out, or a producer still copying in); the batch
+//  waits for it, so these aren't lock-free the way single push/pop are.
+size_t MpmcQueue_pushBatch(MpmcQueue* self, const void* items, size_t count);
+size_t MpmcQueue_popBatch(MpmcQueue* self, void* items, size_t count);
+
+// note: a snapshot, which may be stale by the time it returns.
+size_t MpmcQueue_size(MpmcQueue* self);
+
+#endif // __N5_QUEUE_H__
@@ -0,0 +1,61 @@
+#ifndef __N5_RADIX_H__
+#define __N5_RADIX_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+
+typedef struct RadixNode RadixNode;
+typedef struct RadixTree RadixTree;
+
+// Called for each key in order; return false to stop early.
+//  note: 'key' stays valid until that key is removed.
+typedef bool (*RadixVisitFn)(void* ctx, cstr key, void* value);
+
+// An adaptive radix tree (ART) over cstr keys: inner nodes grow and shrink
+//  between 4, 16, 48 and 256 children as keys come and go, and runs of bytes
+//  without a branch are collapsed into the node below. Unlike a hash table it
+//  keeps keys in order, so it answers prefix and range queries directly.
+//  Keys are copied into leaves alongside their value (inline, aligned to 8
+//  bytes and zeroed on insertion); nodes and leaves come from 'owner', which
+//  can be an Arena when keys are never removed.
+//  note: the ordering costs lookup speed. On route-like keys with decimal ids
+//  (the radix bench) a get walks one node per digit: about 2.4x slower than
+//  HashMap at 16K keys (~150 vs ~60ns) and 1.8x at 1M (~900 vs ~500ns), and
+//  longestPrefix is slower than probing a HashMap once per '/' prefix. In
+//  exchange it takes ~83 bytes/key against ~118. Prefer HashMap unless the
+//  order or the prefix queries are needed.
+struct RadixTree {
+    Allocator* owner;
+    size_t valueSize;
+    size_t size;
+    RadixNode* root;
+};
+
+void RadixTree_init(RadixTree* self, Allocator* owner, size_t valueSize);
+void RadixTree_deinit(RadixTree* self);
+
+void* RadixTree_get(const RadixTree* self, cstr key);
+
+// Returns the value for 'key', inserting a zeroed value if it isn't present
+//  (or NULL if allocation fails).
+void* RadixTree_insert(RadixTree* self, cstr key);
+
+bool RadixTree_remove(RadixTree* self, cstr key);
+
+// Returns the value of the longest key that is a prefix of 'key' (e.g. the
+//  most specific route), or NULL if there is none. 'matched' (optional) is
+//  set to that key's size.
+void* RadixTree_longestPrefix(const RadixTree* self, cstr key, size_t* matched);
+
+// Visits every key in [lower, upper) in byte order.
+void RadixTree_range(const RadixTree* self, cstr lower, cstr upper, RadixVisitFn fn, void* ctx);
+// Visits every key >= 'lower' in byte order; pass "" to visit the whole tree.
+void RadixTree_rangeFrom(const RadixTree* self, cstr lower, RadixVisitFn fn, void* ctx);
+// Visits every key starting with 'prefix' in byte order.
+void RadixTree_withPrefix(const RadixTree* self, cstr prefix, RadixVisitFn fn, void* ctx);
+
+#endif // __N5_RADIX_H__
@@ -0,0 +1,66 @@
+#ifndef __N5_SIMD_H__
+#define __N5_SIMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct SimdKernels SimdKernels;
+
+typedef enum SimdLevel {
+    simd_scalar,
+    simd_sse2,
+    simd_avx2,
+    simd_avx512,
+} SimdLevel;
+
+// Byte-oriented kernels behind the Slice/str primitives. The best supported
+//  level is picked once at startup (overridable with N5_SIMD=scalar|sse2|avx2|avx512),
+//  so callers get vector code without building with -march flags.
+struct SimdKernels {
+    SimdLevel level;
+    bool (*equal)(const void* a, const void* b, size_t size);
+    // note: returns -1, 0 or 1, comparing bytes as unsigned (like memcmp).
+    int (*compare)(const void* a, const void* b, size_t size);
+    // note: 'value' is one item of 'width' bytes, repeated 'count' times.
+    void (*fill)(void* dest, size_t count, const void* value, size_t width);
+    void (*reverse)(void* data, size_t size);
+    // note: returns 'size' if 'byte' isn't found.
+    size_t (*findByte)(const void* data, size_t size, uint8_t byte);
+    size_t (*countByte)(const void* data, size_t size, uint8_t byte);
+    // Classifies one 64-byte block: bit i of masks[n] is set if byte i equals needles[n].
+    //  The building block for bitmask-driven parsers (JSON, CSV).
+    void (*matchBlock)(const void* block, const uint8_t* needles, size_t count, uint64_t* masks);
+    // Classifies one 64-byte block through two 16-byte nibble tables ('tables' holds
+    //  the low-nibble one, then the high): byte b's class is low[b & 15] & high[b >> 4],
+    //  and bit i of masks[n] is set if byte i's class shares a bit with classes[n].
+    //  Any set of bytes that is all the pairs of a few low and high nibbles fits
+    //  in one class bit, so a few sets cost two lookups instead of a compare per byte.
+    void (*classifyBlock)(const void* block, const uint8_t* tables, const uint8_t* classes, size_t count, uint64_t* masks);
+    // Flips the ASCII case bit (0x20) of every byte in ['first', 'first' + 25], in place:
+    //  'A' lowers, 'a' uppers. Other bytes (including UTF-8) are left alone.
+    void (*flipCase)(void* data, size_t size, uint8_t first);
+    // note: returns the first index where the bytes differ ignoring ASCII case, or 'size'.
+    size_t (*mismatchIgnoreCase)(const void* a, const void* b, size_t size);
+    // Writes two hex digits per byte ('size' * 2 chars), high nibble first.
+    void (*hexEncode)(void* dest, const void* src, size_t size, bool upper);
+    // Decodes pairs of hex digits (either case) from 'size' chars into 'size' / 2 bytes,
+    //  stopping before the first pair with a bad digit; returns the chars decoded.
+    size_t (*hexDecode)(void* dest, const void* src, size_t size);
+    // Encodes whole 3-byte groups ('size' is a multiple of 3) as 4 base64 chars
+    //  each; 'url' picks '-' and '_' over '+' and '/'. Padding is left to the caller.
+    void (*base64Encode)(void* dest, const void* src, size_t size, bool url);
+    // Decodes whole 4-char groups ('size' is a multiple of 4, no padding), stopping
+    //  before the first group with a char outside the alphabet; returns the chars decoded.
+    size_t (*base64Decode)(void* dest, const void* src, size_t size, bool url);
+};
+
+extern const SimdKernels* n5_simd;
+
+SimdLevel n5_simd_detect(void);
+
+// Switches every kernel to 'level', returning false if the CPU doesn't support it.
+//  note: not thread-safe; intended for startup, tests and benchmarks.
+bool n5_simd_select(SimdLevel level);
+
+#endif // __N5_SIMD_H__
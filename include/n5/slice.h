@@ -2,7 +2,10 @@
 #define __N5_SLICE_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
+#include "n5/simd.h"
 #include "n5/utils.h"
 
 #ifndef assert
@@ -11,6 +14,9 @@
 
 #define Slice(T) struct { T* data; size_t size; }
 
+typedef Slice(uint64_t) u64s;
+typedef Slice(int64_t) i64s;
+
 #define Slice_start(self) (self).data
 #define Slice_end(self) ((self).data + (self).size)
 #define Slice_rawSize(self) ((self).size * sizeof((self).data[0]))
@@ -20,7 +26,6 @@
 #define Slice_fromArray(arr) Slice_from((arr), n5_arraySize(arr))
 
 #define Slice_slice(self, offset, len) Slice_from(( \
-    assert((offset) >= 0), \
     assert((self).size >= ((len) + (offset))), \
     (self).data + (offset)), \
     (len) \
@@ -33,10 +38,20 @@
     memcpy((dest).data, (src).data, Slice_rawSize(src)) \
 )
 
+#define Slice_equals(a, b) ( \
+    ((a).size == (b).size) && n5_simd->equal((a).data, (b).data, Slice_rawSize(a)) \
+)
+
+// note: slices of different sizes are ordered by size, not contents.
 #define Slice_compare(a, b) ( \
     ((a).size == (b).size) \
-        ? memcmp((a).data, (b).data, Slice_rawSize(a)) \
-        : ((int)(a).size - (int)(b).size) \
+        ? n5_simd->compare((a).data, (b).data, Slice_rawSize(a)) \
+        : (((a).size < (b).size) ? -1 : 1) \
+)
+
+#define Slice_fill(self, value) ( \
+    assert((self).data != NULL || (self).size == 0), \
+    n5_simd->fill((self).data, (self).size, &(value), sizeof((self).data[0])) \
 )
 
 #endif // __N5_SLICE_H__
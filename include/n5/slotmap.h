@@ -0,0 +1,107 @@
+#ifndef __N5_SLOTMAP_H__
+#define __N5_SLOTMAP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/slice.h"
+#include "n5/vec.h"
+
+typedef struct SlotHandle SlotHandle;
+typedef struct SlotMapSlot SlotMapSlot;
+typedef struct SlotMapRaw SlotMapRaw;
+
+// Refers to one value in a SlotMap. The generation makes a handle go stale once
+//  its value is removed, even if the slot is reused; the zero handle is never valid.
+//  note: a slot's generation wraps after 2^31 reuses.
+struct SlotHandle {
+    uint32_t index;
+    uint32_t generation;
+};
+
+// note: an odd generation means the slot is in use and 'index' is the value's
+//  position in 'items'; otherwise 'index' links to the next free slot.
+struct SlotMapSlot {
+    uint32_t generation;
+    uint32_t index;
+};
+
+// Values live packed in 'items' (a regular Slice, so scans are contiguous) and
+//  are found through a sparse array of slots, giving O(1) insert, lookup and
+//  remove by handle. Removal moves the last value into the gap, so pointers
+//  into 'items' and positions in it don't survive an insert or remove; handles do.
+//  note: the macros below evaluate 'self' more than once.
+#define SlotMap(T) struct { \
+    Allocator* owner; \
+    size_t capacity; \
+    Slice(T) items; \
+    Vec(uint32_t) itemSlots; \
+    Vec(SlotMapSlot) slots; \
+    uint32_t freeSlot; \
+}
+
+struct SlotMapRaw {
+    Allocator* owner;
+    size_t capacity;
+    Slice(void) items;
+    VecRaw itemSlots;
+    VecRaw slots;
+    uint32_t freeSlot;
+};
+
+#define SLOT_NONE UINT32_MAX
+
+#define SlotMap_new(allocator) { \
+    .owner = (allocator), \
+    .itemSlots = Vec_new(allocator), \
+    .slots = Vec_new(allocator), \
+    .freeSlot = SLOT_NONE, \
+}
+
+#define SlotMap_itemSize(self) sizeof((self)->items.data[0])
+#define SlotMap_raw(self) ((SlotMapRaw*)(self))
+
+#define SlotMap_free(self) SlotMapRaw_free(SlotMap_raw(self), SlotMap_itemSize(self), Vec_debugInfo())
+
+#define SlotMap_reserve(self, additional) SlotMapRaw_reserve( \
+    SlotMap_raw(self), \
+    SlotMap_itemSize(self), \
+    (self)->items.size + (additional), \
+    Vec_debugInfo() \
+)
+
+// Stores 'value' and sets '*handle' to it, returning false if allocation fails.
+#define SlotMap_insert(self, value, handle) ( \
+    SlotMapRaw_insert(SlotMap_raw(self), SlotMap_itemSize(self), (handle), Vec_debugInfo()) \
+        ? ((self)->items.data[(self)->items.size - 1] = (value), true) \
+        : false \
+)
+
+// Returns a pointer to the value, or NULL if 'handle' is stale.
+#define SlotMap_get(self, handle) SlotMapRaw_get(SlotMap_raw(self), SlotMap_itemSize(self), (handle))
+
+#define SlotMap_contains(self, handle) (SlotMapRaw_find(SlotMap_raw(self), (handle)) != SIZE_MAX)
+
+// note: returns false if 'handle' is stale.
+#define SlotMap_remove(self, handle) SlotMapRaw_remove(SlotMap_raw(self), SlotMap_itemSize(self), (handle))
+
+// The handle of the value at 'index' in 'items', e.g. while iterating.
+#define SlotMap_handleAt(self, index) SlotMapRaw_handleAt(SlotMap_raw(self), (index))
+
+// Removes every value, invalidating all outstanding handles.
+#define SlotMap_clear(self) SlotMapRaw_clear(SlotMap_raw(self))
+
+void SlotMapRaw_free(SlotMapRaw* self, size_t itemSize, DebugInfo debugInfo);
+bool SlotMapRaw_reserve(SlotMapRaw* self, size_t itemSize, size_t minCapacity, DebugInfo debugInfo);
+// note: appends an uninitialised value at the end of 'items'.
+bool SlotMapRaw_insert(SlotMapRaw* self, size_t itemSize, SlotHandle* handle, DebugInfo debugInfo);
+// note: returns the value's index in 'items', or SIZE_MAX if 'handle' is stale.
+size_t SlotMapRaw_find(const SlotMapRaw* self, SlotHandle handle);
+void* SlotMapRaw_get(const SlotMapRaw* self, size_t itemSize, SlotHandle handle);
+bool SlotMapRaw_remove(SlotMapRaw* self, size_t itemSize, SlotHandle handle);
+SlotHandle SlotMapRaw_handleAt(const SlotMapRaw* self, size_t index);
+void SlotMapRaw_clear(SlotMapRaw* self);
+
+#endif // __N5_SLOTMAP_H__
@@ -0,0 +1,26 @@
+#ifndef __N5_SORT_H__
+#define __N5_SORT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+
+// Radix sorts 'self' in place, using a scratch buffer (the same size as 'self')
+//  from 'scratch'. With threadCount > 1, large inputs split their histogram
+//  and scatter passes across that many threads, which are started once per
+//  call. Returns false if the scratch allocation fails, in which case 'self'
+//  is unchanged.
+bool sort_radix_u64(u64s self, Allocator* scratch, size_t threadCount);
+bool sort_radix_i64(i64s self, Allocator* scratch, size_t threadCount);
+
+// MSD radix sort in byte-wise lexicographic order (shorter prefixes first),
+//  falling back to insertion sort for small buckets. Only the cstr views are
+//  moved; the underlying characters are never touched. With threads, buckets
+//  too big for one thread are partitioned in parallel again, so shared
+//  prefixes and skewed first bytes still spread across the workers.
+bool sort_radix_cstr(cstrs self, Allocator* scratch, size_t threadCount);
+
+#endif // __N5_SORT_H__
@@ -8,8 +8,9 @@
 
 typedef Slice(char) str;
 typedef Slice(const char) cstr;
+typedef Slice(cstr) cstrs;
 
-#define str_local(literal) ((str)Slice_from((char[]){ (literal) }, n5_arraySize(literal) - 1))
+#define str_local(literal) ((str)Slice_from((char[]){ literal }, n5_arraySize(literal) - 1))
 
 #define cstr_literal(literal) ((cstr)Slice_from((const char*)(literal), n5_arraySize(literal) - 1))
 #define cstr_cast(string) ((cstr)Slice_from((string).data, (string).size))
@@ -19,6 +20,33 @@ typedef Slice(const char) cstr;
 
 void str_reverse(str self);
 
+// note: both only touch ASCII letters, so UTF-8 text stays valid.
+void str_toLower(str self);
+void str_toUpper(str self);
+
+// Trim ASCII whitespace (space, \t, \n, \v, \f, \r), returning a sub-slice of 'self'.
+cstr cstr_trim(cstr self);
+cstr cstr_trimStart(cstr self);
+cstr cstr_trimEnd(cstr self);
+
+// note: returns self.size if 'character' isn't found.
+size_t cstr_findChar(cstr self, char character);
+size_t cstr_countChar(cstr self, char character);
+
+// Splits the next token off the front of 'self' at 'delimiter' (zero-copy),
+//  returning false once 'self' is empty.
+bool cstr_splitNext(cstr* self, char delimiter, cstr* token);
+
+uint64_t cstr_hash(cstr self);
+
+// ASCII case-insensitive counterparts of Slice_equals, Slice_compare and cstr_hash,
+//  for keys like header names and identifiers.
+bool cstr_equalsIgnoreCase(cstr a, cstr b);
+// note: unlike Slice_compare this is lexicographic (a prefix sorts first), comparing lowercased bytes.
+int cstr_compareIgnoreCase(cstr a, cstr b);
+// note: equals cstr_hash of the lowercased string, so the two can share a table.
+uint64_t cstr_hashIgnoreCase(cstr self);
+
 bool str_tryParse_u64(cstr self, uint64_t* val);
 bool str_tryParse_i64(cstr self, int64_t* val);
 
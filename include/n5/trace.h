@@ -0,0 +1,72 @@
+#ifndef __N5_TRACE_H__
+#define __N5_TRACE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "n5/alloc.h"
+#include "n5/slice.h"
+#include "n5/string.h"
+
+typedef struct TraceEvent TraceEvent;
+typedef struct TraceBuffer TraceBuffer;
+
+typedef enum TraceKind {
+    trace_begin,
+    trace_end,
+    trace_counter,
+} TraceKind;
+
+// note: 'name' must outlive the trace (in practice, a string literal).
+struct TraceEvent {
+    uint64_t timestamp;
+    const char* name;
+    int64_t value;
+    TraceKind kind;
+};
+
+// One thread's ring of events, carved from its own Arena. Only the owning
+//  thread writes to it; once full, the oldest events are overwritten.
+struct TraceBuffer {
+    Arena arena;
+    Slice(TraceEvent) events;
+    atomic_size_t head;
+    uint32_t threadId;
+    TraceBuffer* next;
+};
+
+// Starts collecting events; each thread gets a buffer of 'eventsPerThread'
+//  (rounded up to a power of two) on its first event. 'owner' must be
+//  thread-safe, since buffers are allocated from whichever thread traces.
+bool Trace_init(Allocator* owner, size_t eventsPerThread);
+// note: every traced thread must have stopped recording by now.
+void Trace_deinit(void);
+
+void Trace_record(TraceKind kind, const char* name, int64_t value);
+
+// Appends the collected events to 'out' as Chrome/Perfetto trace JSON. Call it
+//  while traced threads are idle; events recorded meanwhile may be torn.
+//  note: the first export with events in a process may wait up to 10ms to
+//  calibrate timestamps; later ones reuse the rate.
+bool Trace_export(String* out);
+
+// note: instrumentation is compiled out unless N5_TRACE is defined (see the
+//  N5_TRACE CMake option), so it costs nothing by default.
+#if defined(N5_TRACE)
+#define Trace_begin(name) Trace_record(trace_begin, (name), 0)
+#define Trace_end(name) Trace_record(trace_end, (name), 0)
+#define Trace_counter(name, value) Trace_record(trace_counter, (name), (int64_t)(value))
+#else
+#define Trace_begin(name) ((void)0)
+#define Trace_end(name) ((void)0)
+#define Trace_counter(name, value) ((void)0)
+#endif
+
+// Wraps the following statement in a span; leaving it early (return, break,
+//  goto) skips the end event, so use Trace_begin/Trace_end there instead.
+#define Trace_scope(name) \
+    for (bool trace_scope_ = (Trace_begin(name), true); trace_scope_; trace_scope_ = false, Trace_end(name))
+
+#endif // __N5_TRACE_H__
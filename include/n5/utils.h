@@ -5,12 +5,15 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#define N5_CACHE_LINE_SIZE 64
+
 #define n5_min(a, b) ((a) < (b) ? (a) : (b))
 #define n5_max(a, b) ((a) > (b) ? (a) : (b))
 #define n5_clamp(x, min, max) n5_min((max), n5_max((min), (x)))
 
 #define n5_arraySize(arr) (sizeof(arr) / sizeof((arr)[0]))
 
+#define n5_alignSize(size, align) ((((size) + (align) - 1) / (align)) * (align))
 #define n5_align_t(ptr) n5_align(ptr, alignof(*ptr))
 
 static inline void* n5_align(void* ptr, size_t align) {
@@ -28,4 +31,76 @@ static inline uint64_t n5_nextPow2(uint64_t x) {
     return ++x;
 }
 
+static inline uint32_t n5_ctz32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctz(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+static inline uint32_t n5_ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// note: x must be non-zero.
+static inline uint32_t n5_clz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_clzll(x);
+#else
+    uint32_t n = 0;
+    while ((x & (1ull << 63)) == 0) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Bit i of the result is the xor of bits 0..i: turns a mask of quote characters
+//  into a mask of the bytes between them.
+static inline uint64_t n5_prefixXor64(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// A spin-wait hint: lets the core back off (and a sibling hyperthread run)
+//  without giving up the time slice.
+static inline void n5_cpuRelax(void) {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+static inline uint64_t n5_hash_u64(uint64_t x) {
+    // note: splitmix64 finaliser.
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
 #endif // __N5_UTILS_H__
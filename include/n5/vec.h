@@ -0,0 +1,76 @@
+#ifndef __N5_VEC_H__
+#define __N5_VEC_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "n5/alloc.h"
+#include "n5/slice.h"
+
+typedef struct VecRaw VecRaw;
+
+// A growable array; 'items' is a regular Slice over the initialised elements.
+//  note: the macros below evaluate 'self' more than once.
+#define Vec(T) struct { Allocator* owner; size_t capacity; Slice(T) items; }
+
+struct VecRaw {
+    Allocator* owner;
+    size_t capacity;
+    Slice(void) items;
+};
+
+#define Vec_new(allocator) { .owner = (allocator) }
+
+#define Vec_itemSize(self) sizeof((self)->items.data[0])
+#define Vec_raw(self) ((VecRaw*)(self))
+#define Vec_debugInfo() ((DebugInfo) { .file = __FILE__, .line = __LINE__ })
+
+#define Vec_free(self) VecRaw_free(Vec_raw(self), Vec_itemSize(self), Vec_debugInfo())
+
+#define Vec_reserve(self, additional) VecRaw_reserve( \
+    Vec_raw(self), \
+    Vec_itemSize(self), \
+    (self)->items.size + (additional), \
+    Vec_debugInfo() \
+)
+
+#define Vec_shrinkToFit(self) VecRaw_shrinkToFit(Vec_raw(self), Vec_itemSize(self), Vec_debugInfo())
+
+#define Vec_clear(self) ((void)((self)->items.size = 0))
+
+#define Vec_push(self, value) ( \
+    Vec_reserve((self), 1) \
+        ? ((self)->items.data[(self)->items.size++] = (value), true) \
+        : false \
+)
+
+#define Vec_pop(self) ( \
+    assert((self)->items.size > 0), \
+    (self)->items.data[--(self)->items.size] \
+)
+
+#define Vec_insert(self, index, value) ( \
+    VecRaw_insertGap(Vec_raw(self), Vec_itemSize(self), (index), Vec_debugInfo()) \
+        ? ((self)->items.data[(index)] = (value), true) \
+        : false \
+)
+
+// Removes the item at 'index' in O(1) by moving the last item into its place.
+#define Vec_swapRemove(self, index) ( \
+    VecRaw_swapToBack(Vec_raw(self), Vec_itemSize(self), (index)), \
+    (self)->items.data[--(self)->items.size] \
+)
+
+#define Vec_extend(self, slice) ( \
+    assert(Vec_itemSize(self) == sizeof((slice).data[0])), \
+    VecRaw_extend(Vec_raw(self), Vec_itemSize(self), (slice).data, (slice).size, Vec_debugInfo()) \
+)
+
+void VecRaw_free(VecRaw* self, size_t itemSize, DebugInfo debugInfo);
+bool VecRaw_reserve(VecRaw* self, size_t itemSize, size_t minCapacity, DebugInfo debugInfo);
+bool VecRaw_shrinkToFit(VecRaw* self, size_t itemSize, DebugInfo debugInfo);
+bool VecRaw_insertGap(VecRaw* self, size_t itemSize, size_t index, DebugInfo debugInfo);
+void VecRaw_swapToBack(VecRaw* self, size_t itemSize, size_t index);
+bool VecRaw_extend(VecRaw* self, size_t itemSize, const void* items, size_t count, DebugInfo debugInfo);
+
+#endif // __N5_VEC_H__
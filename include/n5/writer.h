@@ -0,0 +1,79 @@
+#ifndef __N5_WRITER_H__
+#define __N5_WRITER_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <threads.h>
+
+#include "n5/alloc.h"
+#include "n5/str.h"
+#include "n5/string.h"
+
+typedef struct AsyncWrite AsyncWrite;
+typedef struct AsyncWriter AsyncWriter;
+typedef struct AsyncRing AsyncRing;
+
+typedef enum AsyncBackend {
+    async_backend_auto,
+    async_backend_uring,
+    async_backend_thread,
+} AsyncBackend;
+
+// A queued buffer; 'memory' is returned to 'owner' once it has been written
+//  (a NULL owner means the buffer is borrowed and must outlive the next flush).
+struct AsyncWrite {
+    cstr data;
+    Allocator* owner;
+    Block memory;
+    uint64_t offset;
+    size_t written;
+    bool done;
+};
+
+// Queues buffers and writes them in batches, through io_uring where available
+//  (Linux 5.1+, seekable non-append fds) and otherwise through a writev thread.
+//  Either way a batch of back-to-back buffers goes out as one writev. Buffers
+//  of up to 512 bytes are copied into a 64KB staging block (and released right
+//  away) instead, so small records cost a memcpy rather than a write each.
+//  Completed buffers are always released on the calling thread, so their
+//  allocators don't need to be thread-safe.
+struct AsyncWriter {
+    Allocator* owner;
+    int fd;
+    AsyncBackend backend;
+    Slice(AsyncWrite) entries;
+    size_t mask;
+    size_t batchSize;
+    size_t queued;
+    size_t submitted;
+    size_t completed;
+    size_t reaped;
+    uint64_t offset;
+    // note: small writes, copied here until the block fills or is flushed.
+    Block staging;
+    size_t stagingSize;
+    AsyncRing* ring;
+    atomic_bool failed;
+    atomic_size_t threadCompleted;
+    size_t threadSubmitted;
+    bool running;
+    thrd_t thread;
+    mtx_t lock;
+    cnd_t wake;
+    cnd_t progress;
+};
+
+bool AsyncWriter_init(AsyncWriter* self, Allocator* owner, int fd, size_t queueDepth, AsyncBackend backend);
+void AsyncWriter_deinit(AsyncWriter* self);
+
+bool AsyncWriter_write(AsyncWriter* self, cstr data, Allocator* owner, Block memory);
+
+// Takes ownership of the string's buffer, leaving 'string' empty.
+bool AsyncWriter_writeString(AsyncWriter* self, String* string);
+
+// Waits for every queued write, returning false if any of them failed.
+bool AsyncWriter_flush(AsyncWriter* self);
+
+#endif // __N5_WRITER_H__
@@ -0,0 +1,99 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define BATCH_COUNT 1024
+#define MAX_BLOCK_SIZE 256
+
+typedef struct AllocBench AllocBench;
+
+struct AllocBench {
+    Allocator* allocator;
+    Arena* arena;
+    Block blocks[BATCH_COUNT];
+    size_t sizes[BATCH_COUNT];
+};
+
+// Allocates a batch of mixed-size blocks, then frees them oldest first (the
+//  arena just resets instead).
+static uint64_t AllocBench_batch(void *const ctx) {
+    AllocBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < BATCH_COUNT; ++i) {
+        self->blocks[i] = Allocator_alloc(self->allocator, char, self->sizes[i]);
+        checksum += (uintptr_t)self->blocks[i].data;
+    }
+    if (self->arena != NULL) {
+        Arena_reset(self->arena);
+        return checksum;
+    }
+    for (size_t i = 0; i < BATCH_COUNT; ++i) {
+        Allocator_free(self->allocator, self->blocks[i]);
+    }
+    return checksum;
+}
+
+// Frees every block right after allocating it, the best case for any free list.
+static uint64_t AllocBench_churn(void *const ctx) {
+    AllocBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < BATCH_COUNT; ++i) {
+        const Block memory = Allocator_alloc(self->allocator, char, self->sizes[i]);
+        checksum += (uintptr_t)memory.data;
+        Allocator_free(self->allocator, memory);
+    }
+    if (self->arena != NULL) {
+        Arena_reset(self->arena);
+    }
+    return checksum;
+}
+
+static void bench_allocWith(const char *const name, AllocBench *const self) {
+    char caseName[64];
+
+    snprintf(caseName, sizeof(caseName), "alloc/%s/batch", name);
+    Bench_run(&(BenchCase) {
+        .name = caseName,
+        .items = BATCH_COUNT,
+        .run = AllocBench_batch,
+        .ctx = self,
+    });
+
+    snprintf(caseName, sizeof(caseName), "alloc/%s/churn", name);
+    Bench_run(&(BenchCase) {
+        .name = caseName,
+        .items = BATCH_COUNT,
+        .run = AllocBench_churn,
+        .ctx = self,
+    });
+}
+
+void bench_alloc(void) {
+    static AllocBench self;
+    for (size_t i = 0; i < BATCH_COUNT; ++i) {
+        self.sizes[i] = 16 + n5_hash_u64(i) % (MAX_BLOCK_SIZE - 16);
+    }
+
+    Allocator stdAlloc = StdAlloc_init();
+    self.allocator = &stdAlloc;
+    self.arena = NULL;
+    bench_allocWith("StdAlloc", &self);
+
+    Arena arena;
+    if (Arena_init(&arena, &stdAlloc, BATCH_COUNT * (MAX_BLOCK_SIZE + 16))) {
+        self.allocator = &arena.base;
+        self.arena = &arena;
+        bench_allocWith("Arena", &self);
+        Arena_deinit(&arena);
+    }
+
+    TestAlloc testAlloc = TestAlloc_init();
+    self.allocator = &testAlloc.base;
+    self.arena = NULL;
+    bench_allocWith("TestAlloc", &self);
+    TestAlloc_deinit(&testAlloc);
+}
@@ -0,0 +1,78 @@
+#ifndef __N5_BENCH_H__
+#define __N5_BENCH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "n5/alloc.h"
+
+typedef struct BenchCase BenchCase;
+typedef struct CountingAlloc CountingAlloc;
+
+typedef enum BenchFormat {
+    bench_format_text,
+    bench_format_json,
+    bench_format_csv,
+} BenchFormat;
+
+// Returns a checksum of the work done, which keeps it from being optimized away.
+typedef uint64_t (*BenchFn)(void* ctx);
+
+// One benchmark: 'run' is timed once per sample and does 'items' units of work;
+//  the optional 'setup' runs untimed before every call (e.g. to restore inputs).
+struct BenchCase {
+    const char* name;
+    size_t items;
+    BenchFn setup;
+    BenchFn run;
+    void* ctx;
+};
+
+static inline uint64_t bench_nowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Parses the command line (see main.c for the options); returns false on bad usage.
+bool Bench_init(int argc, char** argv);
+void Bench_deinit(void);
+
+// Warms up, then samples 'bench->run' until it has enough runs or hits the time
+//  budget. Returns false if the case was filtered out.
+bool Bench_run(const BenchCase* bench);
+
+// Reports samples timed by the caller, each covering 'items' units of work.
+void Bench_reportSamples(const char* name, size_t items, uint64_t* samples, size_t count);
+
+// Reports a single derived number, e.g. memory per entry.
+void Bench_metric(const char* name, const char* unit, double value);
+
+// Forwards to malloc and keeps a running total of the bytes it hands out, for
+//  memory-per-entry metrics.
+struct CountingAlloc {
+    Allocator base;
+    size_t bytes;
+};
+
+CountingAlloc CountingAlloc_init(void);
+
+void bench_alloc(void);
+void bench_binary(void);
+void bench_csv(void);
+void bench_encoding(void);
+void bench_hashmap(void);
+void bench_json(void);
+void bench_log(void);
+void bench_queue(void);
+void bench_radix(void);
+void bench_simd(void);
+void bench_slotmap(void);
+void bench_sort(void);
+void bench_string(void);
+void bench_trace(void);
+void bench_writer(void);
+
+#endif // __N5_BENCH_H__
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/binary.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define VALUE_COUNT (1 << 16)
+
+typedef struct BinaryBench BinaryBench;
+
+struct BinaryBench {
+    u64s values;
+    u64s decoded;
+    String encoded;
+    String scratch;
+};
+
+static uint64_t BinaryBench_writeLoop(void *const ctx) {
+    BinaryBench *const self = ctx;
+    self->scratch.str.size = 0;
+    BinWriter writer = BinWriter_fromString(&self->scratch);
+    for (size_t i = 0; i < self->values.size; ++i) {
+        BinWriter_write_varU64(&writer, self->values.data[i]);
+    }
+    return self->scratch.str.size;
+}
+
+static uint64_t BinaryBench_writeBulk(void *const ctx) {
+    BinaryBench *const self = ctx;
+    self->scratch.str.size = 0;
+    BinWriter writer = BinWriter_fromString(&self->scratch);
+    BinWriter_write_varU64s(&writer, self->values);
+    return self->scratch.str.size;
+}
+
+static uint64_t BinaryBench_readLoop(void *const ctx) {
+    BinaryBench *const self = ctx;
+    BinReader reader = BinReader_from(cstr_cast(self->encoded.str));
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < self->decoded.size; ++i) {
+        uint64_t value = 0;
+        BinReader_read_varU64(&reader, &value);
+        checksum += value;
+    }
+    return checksum;
+}
+
+static uint64_t BinaryBench_readBulk(void *const ctx) {
+    BinaryBench *const self = ctx;
+    BinReader reader = BinReader_from(cstr_cast(self->encoded.str));
+    BinReader_read_varU64s(&reader, self->decoded);
+    return self->decoded.data[self->decoded.size - 1];
+}
+
+// The text baseline the binary format replaces: decimal digits and a separator.
+static uint64_t BinaryBench_writeText(void *const ctx) {
+    BinaryBench *const self = ctx;
+    self->scratch.str.size = 0;
+    for (size_t i = 0; i < self->values.size; ++i) {
+        String_append_u64(&self->scratch, self->values.data[i], false);
+        String_append_char(&self->scratch, ',');
+    }
+    return self->scratch.str.size;
+}
+
+static void bench_binaryValues(const char *const distribution, BinaryBench *const self) {
+    self->encoded.str.size = 0;
+    BinWriter writer = BinWriter_fromString(&self->encoded);
+    BinWriter_write_varU64s(&writer, self->values);
+
+    static const struct {
+        const char* name;
+        BenchFn run;
+    } cases[] = {
+        { "write varU64 loop", BinaryBench_writeLoop },
+        { "write varU64s", BinaryBench_writeBulk },
+        { "read varU64 loop", BinaryBench_readLoop },
+        { "read varU64s", BinaryBench_readBulk },
+        { "write decimal text", BinaryBench_writeText },
+    };
+    for (size_t i = 0; i < n5_arraySize(cases); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "binary/%s/%s", distribution, cases[i].name);
+        Bench_run(&(BenchCase) {
+            .name = name,
+            .items = VALUE_COUNT,
+            .run = cases[i].run,
+            .ctx = self,
+        });
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "binary/%s/varint size", distribution);
+    Bench_metric(name, "bytes/value", (double)self->encoded.str.size / VALUE_COUNT);
+    BinaryBench_writeText(self);
+    snprintf(name, sizeof(name), "binary/%s/text size", distribution);
+    Bench_metric(name, "bytes/value", (double)self->scratch.str.size / VALUE_COUNT);
+}
+
+void bench_binary(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    static BinaryBench self;
+    self.values = (u64s)Allocator_createItems(&stdAlloc, uint64_t, VALUE_COUNT);
+    self.decoded = (u64s)Allocator_createItems(&stdAlloc, uint64_t, VALUE_COUNT);
+    self.encoded = String_new(&stdAlloc, VALUE_COUNT * BINARY_MAX_VARINT_SIZE);
+    self.scratch = String_new(&stdAlloc, VALUE_COUNT * 21);
+
+    // small values (ids, counts and deltas) are the case varints are built for.
+    for (size_t i = 0; i < VALUE_COUNT; ++i) {
+        self.values.data[i] = n5_hash_u64(i) % 100;
+    }
+    bench_binaryValues("small", &self);
+
+    for (size_t i = 0; i < VALUE_COUNT; ++i) {
+        self.values.data[i] = n5_hash_u64(i) >> (n5_hash_u64(i + VALUE_COUNT) % 64);
+    }
+    bench_binaryValues("mixed", &self);
+
+    String_free(&self.scratch);
+    String_free(&self.encoded);
+    Allocator_destroyItems(&stdAlloc, self.decoded);
+    Allocator_destroyItems(&stdAlloc, self.values);
+}
@@ -0,0 +1,129 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/csv.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define RECORD_COUNT 200000
+#define CHUNK_SIZE (64 * 1024)
+
+typedef struct CsvBench CsvBench;
+
+struct CsvBench {
+    Allocator stdAlloc;
+    String document;
+    Arena arena;
+};
+
+// Export-style rows: ids and counters, a decimal, short names, and a free
+//  text column that is sometimes quoted (embedded delimiters, escaped quotes).
+static void CsvBench_generate(String *const out) {
+    out->str.size = 0;
+    String_append_str(out, cstr_literal("id,user,score,delta,comment\n"));
+    for (size_t i = 0; i < RECORD_COUNT; ++i) {
+        const uint64_t hash = n5_hash_u64(i);
+        String_append_u64(out, i, false);
+        String_append_str(out, cstr_literal(",user_"));
+        String_append_u64(out, hash % 10000, false);
+        String_append_char(out, ',');
+        String_append_u64(out, hash % 1000, false);
+        String_append_char(out, '.');
+        String_append_u64(out, hash % 10, false);
+        String_append_char(out, ',');
+        String_append_i64(out, (int64_t)(hash % 2001) - 1000, false);
+        switch (hash % 16) {
+            case 0:
+                String_append_str(out, cstr_literal(",\"said \"\"hello\"\", then left\"\n"));
+                break;
+            case 1:
+                String_append_str(out, cstr_literal(",\"multi, part, comment\"\n"));
+                break;
+            default:
+                String_append_str(out, cstr_literal(",request completed in the expected time\n"));
+                break;
+        }
+    }
+}
+
+static uint64_t CsvBench_parse(CsvBench *const self, const size_t chunkSize, const bool typed) {
+    Arena_reset(&self->arena);
+    CsvReader reader;
+    if (!CsvReader_init(&reader, &self->stdAlloc, &self->arena, ',', true)) {
+        return 0;
+    }
+
+    const cstr document = cstr_cast(self->document.str);
+    uint64_t checksum = 0;
+    for (size_t offset = 0; offset < document.size; offset += chunkSize) {
+        const size_t size = n5_min(chunkSize, document.size - offset);
+        CsvReader_feed(&reader, cstr_slice(document, offset, size), offset + size == document.size);
+        CsvRecord record;
+        while (CsvReader_next(&reader, &record)) {
+            if (typed) {
+                uint64_t id = 0;
+                int64_t delta = 0;
+                CsvRecord_tryParse_u64(&record, 0, &id);
+                CsvRecord_tryParse_i64(&record, 3, &delta);
+                checksum += id + (uint64_t)delta;
+            } else {
+                checksum += record.fields.size;
+            }
+        }
+    }
+
+    CsvReader_deinit(&reader);
+    return checksum;
+}
+
+static uint64_t CsvBench_parseWhole(void *const ctx) {
+    CsvBench *const self = ctx;
+    return CsvBench_parse(self, self->document.str.size, false);
+}
+
+static uint64_t CsvBench_parseChunks(void *const ctx) {
+    return CsvBench_parse(ctx, CHUNK_SIZE, false);
+}
+
+static uint64_t CsvBench_parseTyped(void *const ctx) {
+    CsvBench *const self = ctx;
+    return CsvBench_parse(self, self->document.str.size, true);
+}
+
+// The byte-at-a-time baseline: the same field boundaries from a quote-aware
+//  state machine, without building any views.
+static uint64_t CsvBench_naiveSplit(void *const ctx) {
+    const CsvBench *const self = ctx;
+    const cstr document = cstr_cast(self->document.str);
+    uint64_t fields = 0;
+    bool quoted = false;
+    for (size_t i = 0; i < document.size; ++i) {
+        const char c = document.data[i];
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (c == ',' || c == '\n')) {
+            ++fields;
+        }
+    }
+    return fields;
+}
+
+void bench_csv(void) {
+    static CsvBench self;
+    self.stdAlloc = StdAlloc_init();
+    self.document = String_new(&self.stdAlloc, 1 << 20);
+    CsvBench_generate(&self.document);
+    Arena_init(&self.arena, &self.stdAlloc, self.document.str.size);
+
+    const size_t bytes = self.document.str.size;
+    Bench_run(&(BenchCase) { .name = "csv/parse (items = bytes)", .items = bytes, .run = CsvBench_parseWhole, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "csv/parse 64KB chunks (items = bytes)", .items = bytes, .run = CsvBench_parseChunks, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "csv/parse + tryParse (items = bytes)", .items = bytes, .run = CsvBench_parseTyped, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "csv/naive split (items = bytes)", .items = bytes, .run = CsvBench_naiveSplit, .ctx = &self });
+
+    Arena_deinit(&self.arena);
+    String_free(&self.document);
+}
@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/encoding.h"
+#include "n5/simd.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define BUFFER_SIZE (1 << 20)
+
+typedef struct EncodingBench EncodingBench;
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct EncodingBench {
+    Slice(char) bytes;
+    String hex;
+    String base64;
+    String out;
+    Block decoded;
+};
+
+static uint64_t EncodingBench_hexEncode(void *const ctx) {
+    EncodingBench *const self = ctx;
+    self->out.str.size = 0;
+    Hex_encode(&self->out, cstr_cast(self->bytes), false);
+    return self->out.str.size;
+}
+
+static uint64_t EncodingBench_hexDecode(void *const ctx) {
+    EncodingBench *const self = ctx;
+    return Hex_decode(cstr_cast(self->hex.str), self->decoded).size;
+}
+
+static uint64_t EncodingBench_base64Encode(void *const ctx) {
+    EncodingBench *const self = ctx;
+    self->out.str.size = 0;
+    Base64_encode(&self->out, cstr_cast(self->bytes), base64_standard);
+    return self->out.str.size;
+}
+
+static uint64_t EncodingBench_base64Decode(void *const ctx) {
+    EncodingBench *const self = ctx;
+    return Base64_decode(cstr_cast(self->base64.str), self->decoded, base64_standard).size;
+}
+
+// The baselines: one byte (or char) at a time, the way it's usually written.
+static uint64_t EncodingBench_hexEncodeLoop(void *const ctx) {
+    EncodingBench *const self = ctx;
+    self->out.str.size = 0;
+    for (size_t i = 0; i < self->bytes.size; ++i) {
+        const uint8_t byte = (uint8_t)self->bytes.data[i];
+        String_append_char(&self->out, "0123456789abcdef"[byte >> 4]);
+        String_append_char(&self->out, "0123456789abcdef"[byte & 0x0f]);
+    }
+    return self->out.str.size;
+}
+
+static int32_t EncodingBench_hexValue(const char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static uint64_t EncodingBench_hexDecodeLoop(void *const ctx) {
+    EncodingBench *const self = ctx;
+    uint8_t *const out = self->decoded.data;
+    const cstr text = cstr_cast(self->hex.str);
+    size_t size = 0;
+    for (size_t i = 0; i + 2 <= text.size; i += 2) {
+        const int32_t high = EncodingBench_hexValue(text.data[i]);
+        const int32_t low = EncodingBench_hexValue(text.data[i + 1]);
+        if (high < 0 || low < 0) {
+            break;
+        }
+        out[size++] = (uint8_t)((high << 4) | low);
+    }
+    return size;
+}
+
+static uint64_t EncodingBench_base64EncodeLoop(void *const ctx) {
+    EncodingBench *const self = ctx;
+    self->out.str.size = 0;
+    uint32_t bits = 0;
+    uint32_t count = 0;
+    for (size_t i = 0; i < self->bytes.size; ++i) {
+        bits = (bits << 8) | (uint8_t)self->bytes.data[i];
+        count += 8;
+        while (count >= 6) {
+            count -= 6;
+            String_append_char(&self->out, base64Chars[(bits >> count) & 0x3f]);
+        }
+    }
+    if (count > 0) {
+        String_append_char(&self->out, base64Chars[(bits << (6 - count)) & 0x3f]);
+    }
+    while (self->out.str.size % 4 != 0) {
+        String_append_char(&self->out, '=');
+    }
+    return self->out.str.size;
+}
+
+static uint64_t EncodingBench_base64DecodeLoop(void *const ctx) {
+    EncodingBench *const self = ctx;
+    uint8_t *const out = self->decoded.data;
+    const cstr text = cstr_cast(self->base64.str);
+    size_t size = 0;
+    uint32_t bits = 0;
+    uint32_t count = 0;
+    for (size_t i = 0; i < text.size && text.data[i] != '='; ++i) {
+        const char *const found = strchr(base64Chars, text.data[i]);
+        if (found == NULL) {
+            break;
+        }
+        bits = (bits << 6) | (uint32_t)(found - base64Chars);
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out[size++] = (uint8_t)(bits >> count);
+        }
+    }
+    return size;
+}
+
+void bench_encoding(void) {
+    static const char *const names[] = { "scalar", "sse2", "avx2", "avx512" };
+    static const struct {
+        const char* name;
+        BenchFn run;
+    } kernels[] = {
+        { "Hex_encode", EncodingBench_hexEncode },
+        { "Hex_decode", EncodingBench_hexDecode },
+        { "Base64_encode", EncodingBench_base64Encode },
+        { "Base64_decode", EncodingBench_base64Decode },
+    };
+    static const struct {
+        const char* name;
+        BenchFn run;
+    } loops[] = {
+        { "encoding/hex encode loop baseline", EncodingBench_hexEncodeLoop },
+        { "encoding/hex decode loop baseline", EncodingBench_hexDecodeLoop },
+        { "encoding/base64 encode loop baseline", EncodingBench_base64EncodeLoop },
+        { "encoding/base64 decode loop baseline", EncodingBench_base64DecodeLoop },
+    };
+    Allocator stdAlloc = StdAlloc_init();
+
+    EncodingBench self = {
+        .bytes = Allocator_createItems(&stdAlloc, char, BUFFER_SIZE),
+        .hex = String_new(&stdAlloc, Hex_encodedSize(BUFFER_SIZE)),
+        .base64 = String_new(&stdAlloc, Base64_encodedSize(BUFFER_SIZE, base64_standard)),
+        .out = String_new(&stdAlloc, Hex_encodedSize(BUFFER_SIZE)),
+        .decoded = Allocator_alloc(&stdAlloc, uint8_t, BUFFER_SIZE),
+    };
+    for (size_t i = 0; i < self.bytes.size; ++i) {
+        self.bytes.data[i] = (char)n5_hash_u64(i);
+    }
+    Hex_encode(&self.hex, cstr_cast(self.bytes), false);
+    Base64_encode(&self.base64, cstr_cast(self.bytes), base64_standard);
+
+    // note: items are the raw (decoded) bytes, so M items/s reads as MB/s of binary data.
+    const SimdLevel startLevel = n5_simd->level;
+    for (SimdLevel level = simd_scalar; level <= simd_avx512; ++level) {
+        if (!n5_simd_select(level)) {
+            continue;
+        }
+        for (size_t i = 0; i < n5_arraySize(kernels); ++i) {
+            char name[64];
+            snprintf(name, sizeof(name), "encoding/%s/%s", names[level], kernels[i].name);
+            Bench_run(&(BenchCase) { .name = name, .items = BUFFER_SIZE, .run = kernels[i].run, .ctx = &self });
+        }
+    }
+    n5_simd_select(startLevel);
+    for (size_t i = 0; i < n5_arraySize(loops); ++i) {
+        Bench_run(&(BenchCase) { .name = loops[i].name, .items = BUFFER_SIZE, .run = loops[i].run, .ctx = &self });
+    }
+
+    Allocator_free(&stdAlloc, self.decoded);
+    String_free(&self.out);
+    String_free(&self.base64);
+    String_free(&self.hex);
+    Allocator_destroyItems(&stdAlloc, self.bytes);
+}
@@ -0,0 +1,378 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_COUNTERS 1
+#else
+#define BENCH_COUNTERS 0
+#endif
+
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define MAX_RUNS 1000
+#define COUNTER_COUNT 4
+
+typedef struct BenchStats BenchStats;
+typedef struct BenchState BenchState;
+
+struct BenchStats {
+    double medianNs;
+    double p99Ns;
+    double minNs;
+    double meanNs;
+};
+
+struct BenchState {
+    BenchFormat format;
+    size_t warmup;
+    size_t runs;
+    uint64_t budgetNs;
+    const char* filter;
+    bool counters;
+    int counterFds[COUNTER_COUNT];
+    size_t records;
+    uint64_t samples[MAX_RUNS];
+};
+
+static BenchState bench = {
+    .format = bench_format_text,
+    .warmup = 2,
+    .runs = 15,
+    .budgetNs = 1000000000ull,
+    .counterFds = { -1, -1, -1, -1 },
+};
+
+// Results are folded into this so no benchmark's work is dead code.
+volatile uint64_t bench_sink;
+
+static const char *const counterNames[COUNTER_COUNT] = {
+    "cycles",
+    "instructions",
+    "cache_misses",
+    "branch_misses",
+};
+
+#if BENCH_COUNTERS
+static bool Bench_openCounters(void) {
+    static const uint64_t configs[COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        struct perf_event_attr attr = {
+            .type = PERF_TYPE_HARDWARE,
+            .size = sizeof(attr),
+            .config = configs[i],
+            .read_format = PERF_FORMAT_GROUP,
+            .disabled = (i == 0),
+            .exclude_kernel = 1,
+            .exclude_hv = 1,
+        };
+        const int groupFd = (i == 0) ? -1 : bench.counterFds[0];
+        const long fd = syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+        if (fd < 0) {
+            for (size_t j = 0; j < i; ++j) {
+                close(bench.counterFds[j]);
+                bench.counterFds[j] = -1;
+            }
+            return false;
+        }
+        bench.counterFds[i] = (int)fd;
+    }
+    return true;
+}
+
+static void Bench_startCounters(void) {
+    ioctl(bench.counterFds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(bench.counterFds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static void Bench_stopCounters(uint64_t *const totals) {
+    ioctl(bench.counterFds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // note: PERF_FORMAT_GROUP reads back { count, values[count] }.
+    uint64_t values[1 + COUNTER_COUNT];
+    if (read(bench.counterFds[0], values, sizeof(values)) == (ssize_t)sizeof(values)) {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            totals[i] += values[1 + i];
+        }
+    }
+}
+#endif
+
+static bool Bench_matches(const char *const name) {
+    return bench.filter == NULL || strstr(name, bench.filter) != NULL;
+}
+
+static int compareU64(const void *const a, const void *const b) {
+    const uint64_t x = *(const uint64_t*)a;
+    const uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static BenchStats Bench_stats(uint64_t *const samples, const size_t count) {
+    qsort(samples, count, sizeof(samples[0]), compareU64);
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += samples[i];
+    }
+    return (BenchStats) {
+        .medianNs = (double)samples[count / 2],
+        .p99Ns = (double)samples[n5_min((count * 99) / 100, count - 1)],
+        .minNs = (double)samples[0],
+        .meanNs = (double)total / (double)count,
+    };
+}
+
+static void Bench_beginRecord(const char *const name) {
+    switch (bench.format) {
+        case bench_format_json:
+            printf("%s\n  {\"name\": \"%s\"", (bench.records == 0) ? "" : ",", name);
+            break;
+        case bench_format_csv:
+        case bench_format_text:
+            break;
+    }
+    ++bench.records;
+}
+
+static void Bench_field(const char *const name, const char *const key, const double value) {
+    switch (bench.format) {
+        case bench_format_json:
+            printf(", \"%s\": %.15g", key, value);
+            break;
+        case bench_format_csv:
+            printf("%s,%s,%.15g\n", name, key, value);
+            break;
+        case bench_format_text:
+            break;
+    }
+}
+
+static void Bench_endRecord(void) {
+    if (bench.format == bench_format_json) {
+        printf("}");
+    }
+}
+
+static void Bench_report(const char *const name, const size_t items, const size_t runs, const BenchStats stats, const uint64_t *const counters) {
+    const double perItem = (double)n5_max(items, (size_t)1) * (double)runs;
+
+    if (bench.format == bench_format_text) {
+        printf(
+            "%-40s median %11.3f us | p99 %11.3f us | %9.2f ns/item | %9.2f M items/s",
+            name,
+            stats.medianNs / 1e3,
+            stats.p99Ns / 1e3,
+            stats.medianNs / (double)n5_max(items, (size_t)1),
+            (double)items * 1e3 / stats.medianNs
+        );
+        if (counters != NULL) {
+            printf(
+                " | %.2f cyc/item, IPC %.2f, %.3f miss/item, %.3f br-miss/item",
+                (double)counters[0] / perItem,
+                (double)counters[1] / (double)n5_max(counters[0], (uint64_t)1),
+                (double)counters[2] / perItem,
+                (double)counters[3] / perItem
+            );
+        }
+        printf("\n");
+        return;
+    }
+
+    Bench_beginRecord(name);
+    Bench_field(name, "items", (double)items);
+    Bench_field(name, "runs", (double)runs);
+    Bench_field(name, "median_ns", stats.medianNs);
+    Bench_field(name, "p99_ns", stats.p99Ns);
+    Bench_field(name, "min_ns", stats.minNs);
+    Bench_field(name, "mean_ns", stats.meanNs);
+    Bench_field(name, "ns_per_item", stats.medianNs / (double)n5_max(items, (size_t)1));
+    if (counters != NULL) {
+        for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+            char key[32];
+            snprintf(key, sizeof(key), "%s_per_item", counterNames[i]);
+            Bench_field(name, key, (double)counters[i] / perItem);
+        }
+    }
+    Bench_endRecord();
+}
+
+static bool Bench_parseSize(const char *const text, size_t *const value) {
+    char* end = NULL;
+    const unsigned long long parsed = strtoull(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+    *value = (size_t)parsed;
+    return true;
+}
+
+bool Bench_init(const int argc, char **const argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char *const arg = argv[i];
+        size_t value = 0;
+        if (strcmp(arg, "--json") == 0) {
+            bench.format = bench_format_json;
+        } else if (strcmp(arg, "--csv") == 0) {
+            bench.format = bench_format_csv;
+        } else if (strcmp(arg, "--counters") == 0) {
+            bench.counters = true;
+        } else if (strncmp(arg, "--filter=", 9) == 0) {
+            bench.filter = arg + 9;
+        } else if (strncmp(arg, "--runs=", 7) == 0 && Bench_parseSize(arg + 7, &value) && value > 0) {
+            bench.runs = n5_min(value, (size_t)MAX_RUNS);
+        } else if (strncmp(arg, "--warmup=", 9) == 0 && Bench_parseSize(arg + 9, &value)) {
+            bench.warmup = value;
+        } else if (strncmp(arg, "--budget-ms=", 12) == 0 && Bench_parseSize(arg + 12, &value)) {
+            bench.budgetNs = (uint64_t)value * 1000000ull;
+        } else {
+            fprintf(stderr, "[Bench] error: unknown option '%s'.\n", arg);
+            return false;
+        }
+    }
+
+    if (bench.counters) {
+#if BENCH_COUNTERS
+        bench.counters = Bench_openCounters();
+#else
+        bench.counters = false;
+#endif
+        if (!bench.counters) {
+            fprintf(stderr, "[Bench] warning: hardware counters are unavailable, continuing without them.\n");
+        }
+    }
+
+    switch (bench.format) {
+        case bench_format_json:
+            printf("[");
+            break;
+        case bench_format_csv:
+            printf("name,stat,value\n");
+            break;
+        case bench_format_text:
+            break;
+    }
+    return true;
+}
+
+void Bench_deinit(void) {
+    if (bench.format == bench_format_json) {
+        printf("\n]\n");
+    }
+#if BENCH_COUNTERS
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        if (bench.counterFds[i] >= 0) {
+            close(bench.counterFds[i]);
+            bench.counterFds[i] = -1;
+        }
+    }
+#endif
+}
+
+bool Bench_run(const BenchCase *const self) {
+    if (!Bench_matches(self->name)) {
+        return false;
+    }
+
+    uint64_t checksum = 0;
+
+    // note: a single slow warmup run is enough; its cost usually dwarfs cold-cache effects.
+    for (size_t i = 0; i < bench.warmup; ++i) {
+        if (self->setup != NULL) {
+            checksum += self->setup(self->ctx);
+        }
+        const uint64_t start = bench_nowNs();
+        checksum += self->run(self->ctx);
+        if (bench_nowNs() - start > bench.budgetNs / 10) {
+            break;
+        }
+    }
+
+    uint64_t counters[COUNTER_COUNT] = { 0 };
+    size_t runs = 0;
+    uint64_t elapsed = 0;
+    while (runs < bench.runs && (runs < 3 || elapsed < bench.budgetNs)) {
+        if (self->setup != NULL) {
+            checksum += self->setup(self->ctx);
+        }
+
+#if BENCH_COUNTERS
+        if (bench.counters) {
+            Bench_startCounters();
+        }
+#endif
+        const uint64_t start = bench_nowNs();
+        checksum += self->run(self->ctx);
+        const uint64_t sample = bench_nowNs() - start;
+#if BENCH_COUNTERS
+        if (bench.counters) {
+            Bench_stopCounters(counters);
+        }
+#endif
+
+        bench.samples[runs++] = sample;
+        elapsed += sample;
+    }
+    bench_sink += checksum;
+
+    const BenchStats stats = Bench_stats(bench.samples, runs);
+    Bench_report(self->name, self->items, runs, stats, bench.counters ? counters : NULL);
+    return true;
+}
+
+void Bench_reportSamples(const char *const name, const size_t items, uint64_t *const samples, const size_t count) {
+    if (!Bench_matches(name) || count == 0) {
+        return;
+    }
+    const BenchStats stats = Bench_stats(samples, count);
+    Bench_report(name, items, count, stats, NULL);
+}
+
+void Bench_metric(const char *const name, const char *const unit, const double value) {
+    if (!Bench_matches(name)) {
+        return;
+    }
+
+    if (bench.format == bench_format_text) {
+        printf("%-40s %11.2f %s\n", name, value, unit);
+        return;
+    }
+
+    Bench_beginRecord(name);
+    Bench_field(name, unit, value);
+    Bench_endRecord();
+}
+
+static Block CountingAlloc_alloc(Allocator *const base, const AllocInfo *const info) {
+    CountingAlloc *const self = (CountingAlloc*)base;
+    const Block memory = StdAlloc_alloc(NULL, info);
+    self->bytes += memory.size;
+    return memory;
+}
+
+static void CountingAlloc_free(Allocator *const base, const FreeInfo *const info) {
+    CountingAlloc *const self = (CountingAlloc*)base;
+    self->bytes -= info->memory.size;
+    StdAlloc_free(NULL, info);
+}
+
+static const IAllocator CountingAllocVtbl = {
+    .alloc = CountingAlloc_alloc,
+    .free = CountingAlloc_free,
+};
+
+CountingAlloc CountingAlloc_init(void) {
+    return (CountingAlloc) { .base = &CountingAllocVtbl };
+}
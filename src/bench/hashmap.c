@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/hashmap.h"
+#include "n5/str.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define LOOKUP_COUNT (1 << 20)
+
+typedef struct ChainNode ChainNode;
+typedef struct ChainTable ChainTable;
+typedef Slice(ChainNode*) ChainBuckets;
+
+// The baseline: separate chaining with one node allocation per entry.
+struct ChainNode {
+    ChainNode* next;
+    uint64_t hash;
+    cstr key;
+    uint64_t value;
+};
+
+struct ChainTable {
+    Allocator* owner;
+    ChainBuckets buckets;
+};
+
+static void ChainTable_insert(ChainTable *const self, const cstr key, const uint64_t value) {
+    const uint64_t hash = cstr_hash(key);
+    ChainNode** bucket = &self->buckets.data[hash & (self->buckets.size - 1)];
+    ChainNode *const node = Allocator_createItem(self->owner, ChainNode);
+    char *const copy = Allocator_alloc(self->owner, char, key.size).data;
+    memcpy(copy, key.data, key.size);
+    *node = (ChainNode) {
+        .next = *bucket,
+        .hash = hash,
+        .key = Slice_from(copy, key.size),
+        .value = value,
+    };
+    *bucket = node;
+}
+
+static const uint64_t* ChainTable_get(const ChainTable *const self, const cstr key) {
+    const uint64_t hash = cstr_hash(key);
+    for (const ChainNode* node = self->buckets.data[hash & (self->buckets.size - 1)]; node != NULL; node = node->next) {
+        if (node->hash == hash && node->key.size == key.size && memcmp(node->key.data, key.data, key.size) == 0) {
+            return &node->value;
+        }
+    }
+    return NULL;
+}
+
+static void ChainTable_deinit(ChainTable *const self) {
+    for (size_t i = 0; i < self->buckets.size; ++i) {
+        ChainNode* node = self->buckets.data[i];
+        while (node != NULL) {
+            ChainNode *const next = node->next;
+            Allocator_free(self->owner, ((Block) { .data = (void*)node->key.data, .size = node->key.size }));
+            Allocator_destroyItem(self->owner, node);
+            node = next;
+        }
+    }
+    Allocator_destroyItems(self->owner, self->buckets);
+}
+
+typedef struct LookupBench LookupBench;
+
+struct LookupBench {
+    const HashMap* map;
+    const ChainTable* table;
+    Slice(cstr) keys;
+    size_t keyCount;
+};
+
+static uint64_t LookupBench_u64(void *const ctx) {
+    const LookupBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += *(const uint64_t*)HashMap_get(self->map, n5_hash_u64(i) % self->keyCount * 7919);
+    }
+    return checksum;
+}
+
+static uint64_t LookupBench_cstr(void *const ctx) {
+    const LookupBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += *(const uint64_t*)HashMap_get(self->map, self->keys.data[n5_hash_u64(i) % self->keyCount]);
+    }
+    return checksum;
+}
+
+static uint64_t LookupBench_chained(void *const ctx) {
+    const LookupBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += *ChainTable_get(self->table, self->keys.data[n5_hash_u64(i) % self->keyCount]);
+    }
+    return checksum;
+}
+
+static void runLookups(const char *const kind, LookupBench *const self, const BenchFn fn, const size_t bytes) {
+    char name[64];
+    snprintf(name, sizeof(name), "hashmap/%s/%zu keys", kind, self->keyCount);
+    Bench_run(&(BenchCase) {
+        .name = name,
+        .items = LOOKUP_COUNT,
+        .run = fn,
+        .ctx = self,
+    });
+    Bench_metric(name, "bytes/entry", (double)bytes / (double)self->keyCount);
+}
+
+static void bench_hashmapKeys(const size_t keyCount) {
+    Allocator stdAlloc = StdAlloc_init();
+
+    // keys are "key-<n>" in one contiguous buffer.
+    Slice(char) keyText = Allocator_createItems(&stdAlloc, char, keyCount * 16);
+    LookupBench lookups = {
+        .keys = Allocator_createItems(&stdAlloc, cstr, keyCount),
+        .keyCount = keyCount,
+    };
+    {
+        char* cursor = keyText.data;
+        for (size_t i = 0; i < lookups.keys.size; ++i) {
+            const int length = snprintf(cursor, 16, "key-%zu", i * 7919);
+            lookups.keys.data[i] = (cstr)Slice_from(cursor, (size_t)length);
+            cursor += length;
+        }
+    }
+
+    {
+        CountingAlloc counter = CountingAlloc_init();
+        HashMap map;
+        HashMap_init(&map, &counter.base, hash_key_u64, sizeof(uint64_t));
+        HashMap_reserve(&map, keyCount);
+        for (uint64_t i = 0; i < keyCount; ++i) {
+            *(uint64_t*)HashMap_insert(&map, i * 7919) = i;
+        }
+        lookups.map = &map;
+        runLookups("u64", &lookups, LookupBench_u64, counter.bytes);
+        HashMap_deinit(&map);
+    }
+
+    {
+        CountingAlloc counter = CountingAlloc_init();
+        HashMap map;
+        HashMap_init(&map, &counter.base, hash_key_cstr, sizeof(uint64_t));
+        HashMap_reserve(&map, keyCount);
+        for (size_t i = 0; i < lookups.keys.size; ++i) {
+            *(uint64_t*)HashMap_insert(&map, lookups.keys.data[i]) = i;
+        }
+        lookups.map = &map;
+        runLookups("cstr", &lookups, LookupBench_cstr, counter.bytes);
+        HashMap_deinit(&map);
+    }
+
+    {
+        // note: bytes/entry excludes malloc's own per-node overhead.
+        CountingAlloc counter = CountingAlloc_init();
+        ChainTable table = { .owner = &counter.base };
+        table.buckets = (ChainBuckets)Allocator_createItems(&counter.base, ChainNode*, n5_nextPow2(keyCount));
+        memset(table.buckets.data, 0, Slice_rawSize(table.buckets));
+        for (size_t i = 0; i < lookups.keys.size; ++i) {
+            ChainTable_insert(&table, lookups.keys.data[i], i);
+        }
+        lookups.table = &table;
+        runLookups("chained cstr", &lookups, LookupBench_chained, counter.bytes);
+        ChainTable_deinit(&table);
+    }
+
+    Allocator_destroyItems(&stdAlloc, lookups.keys);
+    Allocator_destroyItems(&stdAlloc, keyText);
+}
+
+void bench_hashmap(void) {
+    bench_hashmapKeys(1 << 14);
+    bench_hashmapKeys(1 << 20);
+}
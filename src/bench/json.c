@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/json.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define RECORD_COUNT 20000
+
+typedef struct JsonBench JsonBench;
+
+struct JsonBench {
+    String document;
+    String scratch;
+    Arena arena;
+};
+
+// Log-like records: a mix of short keys, integers, decimals, nested arrays
+//  and the occasional string that needs escaping.
+static void JsonBench_generate(String *const out) {
+    out->str.size = 0;
+    JsonWriter writer = JsonWriter_from(out);
+    JsonWriter_beginArray(&writer);
+    for (size_t i = 0; i < RECORD_COUNT; ++i) {
+        const uint64_t hash = n5_hash_u64(i);
+        char name[32];
+        const int nameSize = snprintf(name, sizeof(name), (hash % 8 == 0) ? "user \"%zu\"" : "user_%zu", i);
+
+        JsonWriter_beginObject(&writer);
+        JsonWriter_key(&writer, cstr_literal("id"));
+        JsonWriter_write_u64(&writer, i);
+        JsonWriter_key(&writer, cstr_literal("name"));
+        JsonWriter_write_str(&writer, (cstr)Slice_from((const char*)name, (size_t)nameSize));
+        JsonWriter_key(&writer, cstr_literal("score"));
+        JsonWriter_write_f64(&writer, (double)(hash % 100000) / 100.0);
+        JsonWriter_key(&writer, cstr_literal("delta"));
+        JsonWriter_write_i64(&writer, (int64_t)(hash % 2001) - 1000);
+        JsonWriter_key(&writer, cstr_literal("active"));
+        JsonWriter_write_bool(&writer, (hash & 1) != 0);
+        JsonWriter_key(&writer, cstr_literal("parent"));
+        JsonWriter_write_null(&writer);
+        JsonWriter_key(&writer, cstr_literal("tags"));
+        JsonWriter_beginArray(&writer);
+        for (size_t t = 0; t < hash % 4; ++t) {
+            JsonWriter_write_str(&writer, cstr_literal("tag"));
+        }
+        JsonWriter_endArray(&writer);
+        JsonWriter_key(&writer, cstr_literal("message"));
+        JsonWriter_write_str(&writer, cstr_literal("request completed without errors in the expected time"));
+        JsonWriter_endObject(&writer);
+    }
+    JsonWriter_endArray(&writer);
+}
+
+static uint64_t JsonBench_parse(void *const ctx) {
+    JsonBench *const self = ctx;
+    Arena_reset(&self->arena);
+    JsonDoc doc;
+    if (!JsonDoc_parse(&doc, &self->arena, cstr_cast(self->document.str))) {
+        return 0;
+    }
+    return doc.count;
+}
+
+// The byte-at-a-time baseline: just finding the structurals, with the string
+//  and escape state a scalar parser has to carry, before any values are built.
+static uint64_t JsonBench_naiveScan(void *const ctx) {
+    const JsonBench *const self = ctx;
+    const cstr document = cstr_cast(self->document.str);
+    uint64_t structurals = 0;
+    bool inString = false;
+    for (size_t i = 0; i < document.size; ++i) {
+        const char c = document.data[i];
+        if (inString) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+        switch (c) {
+            case '"':
+                inString = true;
+                ++structurals;
+                break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                ++structurals;
+                break;
+            default:
+                break;
+        }
+    }
+    return structurals;
+}
+
+static uint64_t JsonBench_write(void *const ctx) {
+    JsonBench *const self = ctx;
+    JsonBench_generate(&self->scratch);
+    return self->scratch.str.size;
+}
+
+void bench_json(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    static JsonBench self;
+    self.document = String_new(&stdAlloc, 1 << 20);
+    self.scratch = String_new(&stdAlloc, 1 << 20);
+    JsonBench_generate(&self.document);
+    Arena_init(&self.arena, &stdAlloc, JsonDoc_arenaSize(self.document.str.size));
+
+    const size_t bytes = self.document.str.size;
+    Bench_run(&(BenchCase) { .name = "json/parse (items = bytes)", .items = bytes, .run = JsonBench_parse, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "json/naive scan (items = bytes)", .items = bytes, .run = JsonBench_naiveScan, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "json/write (items = bytes)", .items = bytes, .run = JsonBench_write, .ctx = &self });
+
+    JsonDoc doc;
+    Arena_reset(&self.arena);
+    if (JsonDoc_parse(&doc, &self.arena, cstr_cast(self.document.str))) {
+        Bench_metric("json/arena used", "bytes/input byte", (double)self.arena.offset / (double)bytes);
+    }
+
+    Arena_deinit(&self.arena);
+    String_free(&self.scratch);
+    String_free(&self.document);
+}
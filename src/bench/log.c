@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/format.h"
+#include "n5/log.h"
+
+#include "bench.h"
+
+#define ITERATIONS 100000
+
+void bench_log(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    Slice(uint64_t) samples = Allocator_createItems(&stdAlloc, uint64_t, ITERATIONS);
+    const cstr name = cstr_literal("request");
+
+    {
+        FILE *const file = tmpfile();
+        String line = String_new(&stdAlloc, 128);
+        for (size_t i = 0; i < samples.size; ++i) {
+            const uint64_t start = bench_nowNs();
+            String_format(
+                &line,
+                cstr_literal("[{}] handled {} #{} in {}ms ok={}\n"),
+                FormatArg_u64(i),
+                FormatArg_str(name),
+                FormatArg_i64(-(int64_t)i),
+                FormatArg_f64(1.25),
+                FormatArg_bool(true)
+            );
+            fwrite(line.str.data, 1, line.str.size, file);
+            samples.data[i] = bench_nowNs() - start;
+        }
+        Bench_reportSamples("log/String_format + fwrite", 1, samples.data, samples.size);
+        String_free(&line);
+        fclose(file);
+    }
+
+    {
+        FILE *const file = tmpfile();
+        Logger logger;
+        LogProducer producer;
+        if (Logger_init(&logger, &stdAlloc, file, log_overflow_block)) {
+            LogProducer_init(&producer, &logger, &stdAlloc, 1 << 20);
+            for (size_t i = 0; i < samples.size; ++i) {
+                const uint64_t start = bench_nowNs();
+                Log_write(
+                    &producer,
+                    cstr_literal("[{}] handled {} #{} in {}ms ok={}"),
+                    FormatArg_u64(i),
+                    FormatArg_str(name),
+                    FormatArg_i64(-(int64_t)i),
+                    FormatArg_f64(1.25),
+                    FormatArg_bool(true)
+                );
+                samples.data[i] = bench_nowNs() - start;
+            }
+            Bench_reportSamples("log/Log_write (deferred)", 1, samples.data, samples.size);
+            LogProducer_deinit(&producer);
+            Logger_deinit(&logger);
+        }
+        fclose(file);
+    }
+
+    Allocator_destroyItems(&stdAlloc, samples);
+}
@@ -0,0 +1,34 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "bench.h"
+
+// usage: n5_bench [--json | --csv] [--filter=<substring>] [--runs=N] [--warmup=N]
+//                 [--budget-ms=N] [--counters]
+int32_t main(const int32_t argc, char** const argv) {
+    if (!Bench_init(argc, argv)) {
+        fprintf(stderr, "usage: %s [--json | --csv] [--filter=<substring>] [--runs=N] [--warmup=N] [--budget-ms=N] [--counters]\n", argv[0]);
+        return 1;
+    }
+
+    bench_alloc();
+    bench_string();
+    bench_trace();
+    bench_binary();
+    bench_json();
+    bench_csv();
+    bench_encoding();
+    bench_log();
+    bench_queue();
+    bench_hashmap();
+    bench_slotmap();
+    bench_radix();
+    bench_simd();
+    bench_sort();
+#if !defined(_WIN32)
+    bench_writer();
+#endif
+
+    Bench_deinit();
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <threads.h>
+
+#include "n5/alloc.h"
+#include "n5/queue.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define ITEM_COUNT (1 << 20)
+#define QUEUE_CAPACITY 4096
+#define BATCH_SIZE 32
+#define MAX_THREADS 8
+
+typedef struct QueueBench QueueBench;
+
+// One producers -> consumers run: every item pushed is a distinct index, so
+//  the checksum of everything popped is the same whatever the interleaving.
+struct QueueBench {
+    SpscQueue spsc;
+    MpmcQueue mpmc;
+    bool multi;
+    size_t batch;
+    size_t threads;
+    atomic_size_t popped;
+    atomic_uint_fast64_t checksum;
+    atomic_size_t nextProducer;
+    // note: set if a thread didn't start, so the others stop instead of waiting on its items.
+    atomic_bool aborted;
+};
+
+static bool QueueBench_push(QueueBench *const self, const uint64_t *const items, const size_t count, size_t *const pushed) {
+    size_t moved;
+    if (self->batch > 1) {
+        moved = self->multi
+            ? MpmcQueue_pushBatch(&self->mpmc, items, count)
+            : SpscQueue_pushBatch(&self->spsc, items, count);
+    } else {
+        moved = (self->multi ? MpmcQueue_push(&self->mpmc, items) : SpscQueue_push(&self->spsc, items)) ? 1 : 0;
+    }
+    *pushed += moved;
+    return moved > 0;
+}
+
+static size_t QueueBench_pop(QueueBench *const self, uint64_t *const items) {
+    if (self->batch > 1) {
+        return self->multi
+            ? MpmcQueue_popBatch(&self->mpmc, items, self->batch)
+            : SpscQueue_popBatch(&self->spsc, items, self->batch);
+    }
+    return (self->multi ? MpmcQueue_pop(&self->mpmc, items) : SpscQueue_pop(&self->spsc, items)) ? 1 : 0;
+}
+
+static int QueueBench_producer(void *const ctx) {
+    QueueBench *const self = ctx;
+    const size_t index = atomic_fetch_add_explicit(&self->nextProducer, 1, memory_order_relaxed);
+    const size_t begin = ITEM_COUNT / self->threads * index;
+    const size_t end = (index + 1 == self->threads) ? ITEM_COUNT : begin + ITEM_COUNT / self->threads;
+
+    uint64_t items[BATCH_SIZE];
+    size_t next = begin;
+    while (next < end) {
+        const size_t count = n5_min(self->batch, end - next);
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = next + i;
+        }
+        size_t pushed = 0;
+        while (pushed < count) {
+            if (!QueueBench_push(self, items + pushed, count - pushed, &pushed)) {
+                if (atomic_load_explicit(&self->aborted, memory_order_relaxed)) {
+                    return 0;
+                }
+                thrd_yield();
+            }
+        }
+        next += count;
+    }
+    return 0;
+}
+
+static int QueueBench_consumer(void *const ctx) {
+    QueueBench *const self = ctx;
+    uint64_t items[BATCH_SIZE];
+    uint64_t checksum = 0;
+    while (atomic_load_explicit(&self->popped, memory_order_relaxed) < ITEM_COUNT) {
+        const size_t count = QueueBench_pop(self, items);
+        if (count == 0) {
+            if (atomic_load_explicit(&self->aborted, memory_order_relaxed)) {
+                break;
+            }
+            thrd_yield();
+            continue;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            checksum += items[i];
+        }
+        atomic_fetch_add_explicit(&self->popped, count, memory_order_relaxed);
+    }
+    atomic_fetch_add_explicit(&self->checksum, checksum, memory_order_relaxed);
+    return 0;
+}
+
+static uint64_t QueueBench_run(void *const ctx) {
+    QueueBench *const self = ctx;
+    atomic_store(&self->popped, 0);
+    atomic_store(&self->checksum, 0);
+    atomic_store(&self->nextProducer, 0);
+    atomic_store(&self->aborted, false);
+
+    thrd_t threads[MAX_THREADS * 2];
+    size_t started = 0;
+    for (; started < self->threads * 2; ++started) {
+        const thrd_start_t fn = (started < self->threads) ? QueueBench_consumer : QueueBench_producer;
+        if (thrd_create(&threads[started], fn, self) != thrd_success) {
+            atomic_store(&self->aborted, true);
+            break;
+        }
+    }
+    for (size_t i = 0; i < started; ++i) {
+        thrd_join(threads[i], NULL);
+    }
+
+    if (atomic_load(&self->aborted)) {
+        fprintf(stderr, "[bench_queue] error: failed to start %zu threads.\n", self->threads * 2);
+        return 0;
+    }
+    return atomic_load(&self->checksum);
+}
+
+// Items per second through the queue, end to end, with 'threads' producers
+//  and as many consumers; a full (or empty) queue yields the thread.
+void bench_queue(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    static QueueBench self;
+    if (!SpscQueue_init(&self.spsc, &stdAlloc, QUEUE_CAPACITY, sizeof(uint64_t))) {
+        return;
+    }
+    if (!MpmcQueue_init(&self.mpmc, &stdAlloc, QUEUE_CAPACITY, sizeof(uint64_t))) {
+        SpscQueue_deinit(&self.spsc);
+        return;
+    }
+
+    static const struct {
+        const char* name;
+        bool multi;
+        size_t batch;
+        size_t threads;
+    } cases[] = {
+        { "queue/spsc 1:1", false, 1, 1 },
+        { "queue/spsc 1:1 batch 32", false, BATCH_SIZE, 1 },
+        { "queue/mpmc 1:1", true, 1, 1 },
+        { "queue/mpmc 1:1 batch 32", true, BATCH_SIZE, 1 },
+        { "queue/mpmc 2:2", true, 1, 2 },
+        { "queue/mpmc 2:2 batch 32", true, BATCH_SIZE, 2 },
+        { "queue/mpmc 4:4", true, 1, 4 },
+        { "queue/mpmc 4:4 batch 32", true, BATCH_SIZE, 4 },
+        { "queue/mpmc 8:8", true, 1, 8 },
+        { "queue/mpmc 8:8 batch 32", true, BATCH_SIZE, 8 },
+    };
+    for (size_t i = 0; i < n5_arraySize(cases); ++i) {
+        self.multi = cases[i].multi;
+        self.batch = cases[i].batch;
+        self.threads = cases[i].threads;
+        Bench_run(&(BenchCase) {
+            .name = cases[i].name,
+            .items = ITEM_COUNT,
+            .run = QueueBench_run,
+            .ctx = &self,
+        });
+    }
+
+    MpmcQueue_deinit(&self.mpmc);
+    SpscQueue_deinit(&self.spsc);
+}
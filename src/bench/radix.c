@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/hashmap.h"
+#include "n5/radix.h"
+#include "n5/str.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define LOOKUP_COUNT (1 << 20)
+#define KEY_MAX 64
+
+typedef struct RadixBench RadixBench;
+
+struct RadixBench {
+    const RadixTree* tree;
+    const HashMap* map;
+    Slice(cstr) keys;
+    // note: each key with a "/<n>" suffix, for longest-prefix lookups.
+    Slice(cstr) paths;
+};
+
+static const char *const resources[] = { "users", "orders", "invoices", "products", "sessions", "teams", "projects", "files" };
+static const char *const actions[] = { "", "/profile", "/settings", "/history" };
+
+static uint64_t RadixBench_get(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += *(const uint64_t*)RadixTree_get(self->tree, self->keys.data[n5_hash_u64(i) % self->keys.size]);
+    }
+    return checksum;
+}
+
+static uint64_t RadixBench_hashMapGet(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        checksum += *(const uint64_t*)HashMap_get(self->map, self->keys.data[n5_hash_u64(i) % self->keys.size]);
+    }
+    return checksum;
+}
+
+static uint64_t RadixBench_longestPrefix(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        size_t matched = 0;
+        checksum += *(const uint64_t*)RadixTree_longestPrefix(self->tree, self->paths.data[n5_hash_u64(i) % self->paths.size], &matched);
+        checksum += matched;
+    }
+    return checksum;
+}
+
+// The baseline for longest-prefix: what a hash map has to do, probing each
+//  '/'-separated prefix from the longest down.
+static uint64_t RadixBench_hashMapLongestPrefix(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < LOOKUP_COUNT; ++i) {
+        cstr path = self->paths.data[n5_hash_u64(i) % self->paths.size];
+        for (;;) {
+            const uint64_t *const value = HashMap_get(self->map, path);
+            if (value != NULL) {
+                checksum += *value + path.size;
+                break;
+            }
+            while (path.size > 0 && path.data[--path.size] != '/') {
+            }
+            if (path.size == 0) {
+                break;
+            }
+        }
+    }
+    return checksum;
+}
+
+static bool RadixBench_sum(void *const ctx, const cstr key, void *const value) {
+    *(uint64_t*)ctx += *(const uint64_t*)value + key.size;
+    return true;
+}
+
+static uint64_t RadixBench_scan(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    RadixTree_rangeFrom(self->tree, cstr_literal(""), RadixBench_sum, &checksum);
+    return checksum;
+}
+
+static uint64_t RadixBench_withPrefix(void *const ctx) {
+    const RadixBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < n5_arraySize(resources); ++i) {
+        char prefix[KEY_MAX];
+        const int length = snprintf(prefix, sizeof(prefix), "/api/v2/%s/", resources[i]);
+        RadixTree_withPrefix(self->tree, (cstr)Slice_from(prefix, (size_t)length), RadixBench_sum, &checksum);
+    }
+    return checksum;
+}
+
+static void bench_radixKeys(const size_t keyCount) {
+    Allocator stdAlloc = StdAlloc_init();
+    RadixBench self = {
+        .keys = Allocator_createItems(&stdAlloc, cstr, keyCount),
+        .paths = Allocator_createItems(&stdAlloc, cstr, keyCount),
+    };
+
+    // keys look like routes: "/api/v<n>/<resource>/<id><action>", in one buffer.
+    Slice(char) keyText = Allocator_createItems(&stdAlloc, char, keyCount * KEY_MAX * 2);
+    size_t keyBytes = 0;
+    {
+        char* cursor = keyText.data;
+        for (size_t i = 0; i < keyCount; ++i) {
+            const uint64_t hash = n5_hash_u64(i);
+            const int length = snprintf(cursor, KEY_MAX, "/api/v%u/%s/%zu%s", (uint32_t)(hash % 3) + 1,
+                resources[(hash >> 8) % n5_arraySize(resources)], i, actions[(hash >> 16) % n5_arraySize(actions)]);
+            self.keys.data[i] = (cstr)Slice_from(cursor, (size_t)length);
+            keyBytes += (size_t)length;
+            cursor += length;
+
+            memcpy(cursor, self.keys.data[i].data, (size_t)length);
+            const int suffixLength = snprintf(cursor + length, KEY_MAX, "/%u", (uint32_t)(hash >> 32) % 1000);
+            self.paths.data[i] = (cstr)Slice_from(cursor, (size_t)(length + suffixLength));
+            cursor += length + suffixLength;
+        }
+    }
+
+    char name[64];
+    CountingAlloc treeCounter = CountingAlloc_init();
+    RadixTree tree;
+    RadixTree_init(&tree, &treeCounter.base, sizeof(uint64_t));
+    for (size_t i = 0; i < keyCount; ++i) {
+        *(uint64_t*)RadixTree_insert(&tree, self.keys.data[i]) = i;
+    }
+    self.tree = &tree;
+
+    CountingAlloc mapCounter = CountingAlloc_init();
+    HashMap map;
+    HashMap_init(&map, &mapCounter.base, hash_key_cstr, sizeof(uint64_t));
+    for (size_t i = 0; i < keyCount; ++i) {
+        *(uint64_t*)HashMap_insert(&map, self.keys.data[i]) = i;
+    }
+    self.map = &map;
+
+    snprintf(name, sizeof(name), "radix/get/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = LOOKUP_COUNT, .run = RadixBench_get, .ctx = &self });
+    // note: keys are copied into the tree's leaves, but the map only points at them.
+    Bench_metric(name, "bytes/key", (double)treeCounter.bytes / (double)keyCount);
+    snprintf(name, sizeof(name), "radix/HashMap_get baseline/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = LOOKUP_COUNT, .run = RadixBench_hashMapGet, .ctx = &self });
+    Bench_metric(name, "bytes/key", (double)(mapCounter.bytes + keyBytes) / (double)keyCount);
+
+    snprintf(name, sizeof(name), "radix/longestPrefix/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = LOOKUP_COUNT, .run = RadixBench_longestPrefix, .ctx = &self });
+    snprintf(name, sizeof(name), "radix/HashMap longest prefix baseline/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = LOOKUP_COUNT, .run = RadixBench_hashMapLongestPrefix, .ctx = &self });
+
+    snprintf(name, sizeof(name), "radix/ordered scan/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = keyCount, .run = RadixBench_scan, .ctx = &self });
+    snprintf(name, sizeof(name), "radix/withPrefix/%zu keys", keyCount);
+    Bench_run(&(BenchCase) { .name = name, .items = keyCount / 3, .run = RadixBench_withPrefix, .ctx = &self });
+
+    // The same tree built in an Arena: no per-allocation overhead, and nodes
+    //  end up next to each other.
+    Arena arena;
+    if (Arena_init(&arena, &stdAlloc, treeCounter.bytes * 2)) {
+        RadixTree arenaTree;
+        RadixTree_init(&arenaTree, &arena.base, sizeof(uint64_t));
+        bool filled = true;
+        for (size_t i = 0; filled && i < keyCount; ++i) {
+            uint64_t *const value = RadixTree_insert(&arenaTree, self.keys.data[i]);
+            filled = (value != NULL);
+            if (filled) {
+                *value = i;
+            }
+        }
+        if (filled) {
+            self.tree = &arenaTree;
+            snprintf(name, sizeof(name), "radix/get (arena)/%zu keys", keyCount);
+            Bench_run(&(BenchCase) { .name = name, .items = LOOKUP_COUNT, .run = RadixBench_get, .ctx = &self });
+            // note: includes the nodes left behind when a node grows.
+            Bench_metric(name, "bytes/key", (double)arena.offset / (double)keyCount);
+        }
+        Arena_deinit(&arena);
+    }
+
+    HashMap_deinit(&map);
+    RadixTree_deinit(&tree);
+    Allocator_destroyItems(&stdAlloc, keyText);
+    Allocator_destroyItems(&stdAlloc, self.paths);
+    Allocator_destroyItems(&stdAlloc, self.keys);
+}
+
+void bench_radix(void) {
+    bench_radixKeys(1 << 14);
+    bench_radixKeys(1 << 20);
+}
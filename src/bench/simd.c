@@ -0,0 +1,89 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/simd.h"
+#include "n5/slice.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define BUFFER_SIZE (1 << 20)
+
+typedef struct SimdBench SimdBench;
+
+struct SimdBench {
+    Slice(uint8_t) a;
+    Slice(uint8_t) b;
+    Slice(uint8_t) scratch;
+};
+
+static uint64_t SimdBench_equal(void *const ctx) {
+    const SimdBench *const self = ctx;
+    return n5_simd->equal(self->a.data, self->b.data, self->a.size);
+}
+
+static uint64_t SimdBench_countByte(void *const ctx) {
+    const SimdBench *const self = ctx;
+    return n5_simd->countByte(self->a.data, self->a.size, 'e');
+}
+
+static uint64_t SimdBench_findByte(void *const ctx) {
+    const SimdBench *const self = ctx;
+    return n5_simd->findByte(self->a.data, self->a.size, '!');
+}
+
+static uint64_t SimdBench_reverse(void *const ctx) {
+    const SimdBench *const self = ctx;
+    n5_simd->reverse(self->scratch.data, self->scratch.size);
+    return self->scratch.data[0];
+}
+
+void bench_simd(void) {
+    static const char *const names[] = { "scalar", "sse2", "avx2", "avx512" };
+    static const struct {
+        const char* name;
+        BenchFn run;
+    } kernels[] = {
+        { "equal", SimdBench_equal },
+        { "countByte", SimdBench_countByte },
+        { "findByte", SimdBench_findByte },
+        { "reverse", SimdBench_reverse },
+    };
+    Allocator stdAlloc = StdAlloc_init();
+
+    SimdBench self = {
+        .a = Allocator_createItems(&stdAlloc, uint8_t, BUFFER_SIZE),
+        .b = Allocator_createItems(&stdAlloc, uint8_t, BUFFER_SIZE),
+        .scratch = Allocator_createItems(&stdAlloc, uint8_t, BUFFER_SIZE),
+    };
+    for (size_t i = 0; i < self.a.size; ++i) {
+        self.a.data[i] = (uint8_t)('a' + n5_hash_u64(i) % 26);
+    }
+    Slice_copyTo(self.b, self.a);
+    Slice_copyTo(self.scratch, self.a);
+
+    // note: items are bytes, so M items/s reads as MB/s.
+    const SimdLevel startLevel = n5_simd->level;
+    for (SimdLevel level = simd_scalar; level <= simd_avx512; ++level) {
+        if (!n5_simd_select(level)) {
+            continue;
+        }
+        for (size_t i = 0; i < n5_arraySize(kernels); ++i) {
+            char name[64];
+            snprintf(name, sizeof(name), "simd/%s/%s", names[level], kernels[i].name);
+            Bench_run(&(BenchCase) {
+                .name = name,
+                .items = BUFFER_SIZE,
+                .run = kernels[i].run,
+                .ctx = &self,
+            });
+        }
+    }
+    n5_simd_select(startLevel);
+
+    Allocator_destroyItems(&stdAlloc, self.scratch);
+    Allocator_destroyItems(&stdAlloc, self.b);
+    Allocator_destroyItems(&stdAlloc, self.a);
+}
@@ -0,0 +1,144 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/hashmap.h"
+#include "n5/slotmap.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define ENTITY_COUNT (1 << 16)
+#define LOOKUP_COUNT (1 << 18)
+
+typedef struct Entity Entity;
+typedef struct SlotMapBench SlotMapBench;
+
+struct Entity {
+    double position[3];
+    uint64_t flags;
+};
+
+typedef SlotMap(Entity) EntityMap;
+typedef Slice(Entity*) EntityPointers;
+typedef Slice(SlotHandle) SlotHandles;
+typedef Slice(uint32_t) u32s;
+
+// The same entities three ways: in a SlotMap, in a HashMap keyed by packed
+//  handle, and individually allocated behind a table of pointers.
+struct SlotMapBench {
+    Allocator stdAlloc;
+    EntityMap entities;
+    HashMap byId;
+    EntityPointers pointers;
+    SlotHandles handles;
+    u32s order;
+};
+
+static inline uint64_t SlotHandle_pack(const SlotHandle handle) {
+    return ((uint64_t)handle.generation << 32) | handle.index;
+}
+
+static uint64_t SlotMapBench_get(void *const ctx) {
+    const SlotMapBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < LOOKUP_COUNT; ++i) {
+        const Entity *const entity = SlotMap_get(&self->entities, self->handles.data[self->order.data[i]]);
+        checksum += entity->flags;
+    }
+    return checksum;
+}
+
+static uint64_t SlotMapBench_hashMapGet(void *const ctx) {
+    const SlotMapBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < LOOKUP_COUNT; ++i) {
+        const Entity *const entity = HashMap_get_u64(&self->byId, SlotHandle_pack(self->handles.data[self->order.data[i]]));
+        checksum += entity->flags;
+    }
+    return checksum;
+}
+
+static uint64_t SlotMapBench_scan(void *const ctx) {
+    const SlotMapBench *const self = ctx;
+    double sum = 0.0;
+    for (size_t i = 0; i < self->entities.items.size; ++i) {
+        sum += self->entities.items.data[i].position[1];
+    }
+    return (uint64_t)sum;
+}
+
+static uint64_t SlotMapBench_pointerScan(void *const ctx) {
+    const SlotMapBench *const self = ctx;
+    double sum = 0.0;
+    for (size_t i = 0; i < self->pointers.size; ++i) {
+        sum += self->pointers.data[i]->position[1];
+    }
+    return (uint64_t)sum;
+}
+
+// Removes and re-inserts entities in a random order, so the dense array keeps
+//  getting reshuffled and slots keep getting reused.
+static uint64_t SlotMapBench_churn(void *const ctx) {
+    SlotMapBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        SlotHandle *const handle = &self->handles.data[self->order.data[i]];
+        Entity entity = *(const Entity*)SlotMap_get(&self->entities, *handle);
+        SlotMap_remove(&self->entities, *handle);
+        ++entity.flags;
+        SlotMap_insert(&self->entities, entity, handle);
+        checksum += handle->generation;
+    }
+    return checksum;
+}
+
+void bench_slotmap(void) {
+    static SlotMapBench self;
+    self.stdAlloc = StdAlloc_init();
+    self.entities = (EntityMap)SlotMap_new(&self.stdAlloc);
+    HashMap_init(&self.byId, &self.stdAlloc, hash_key_u64, sizeof(Entity));
+    self.pointers = (EntityPointers)Allocator_createItems(&self.stdAlloc, Entity*, ENTITY_COUNT);
+    self.handles = (SlotHandles)Allocator_createItems(&self.stdAlloc, SlotHandle, ENTITY_COUNT);
+    self.order = (u32s)Allocator_createItems(&self.stdAlloc, uint32_t, LOOKUP_COUNT);
+
+    // note: the pointer table is interleaved with other allocations, like a
+    //  table built up over time.
+    Slice(Entity*) filler = Allocator_createItems(&self.stdAlloc, Entity*, ENTITY_COUNT);
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        const uint64_t hash = n5_hash_u64(i);
+        const Entity entity = {
+            .position = { (double)(hash % 1000), (double)(hash % 997), (double)(hash % 991) },
+            .flags = hash,
+        };
+        if (!SlotMap_insert(&self.entities, entity, &self.handles.data[i])) {
+            return;
+        }
+        *(Entity*)HashMap_insert_u64(&self.byId, SlotHandle_pack(self.handles.data[i])) = entity;
+        self.pointers.data[i] = Allocator_createItem(&self.stdAlloc, Entity);
+        *self.pointers.data[i] = entity;
+        filler.data[i] = Allocator_createItem(&self.stdAlloc, Entity);
+    }
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        Allocator_destroyItem(&self.stdAlloc, filler.data[i]);
+    }
+    Allocator_destroyItems(&self.stdAlloc, filler);
+    for (size_t i = 0; i < LOOKUP_COUNT; ++i) {
+        self.order.data[i] = (uint32_t)(n5_hash_u64(i + ENTITY_COUNT) % ENTITY_COUNT);
+    }
+
+    Bench_run(&(BenchCase) { .name = "slotmap/get (random handles)", .items = LOOKUP_COUNT, .run = SlotMapBench_get, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "slotmap/HashMap_get_u64 baseline", .items = LOOKUP_COUNT, .run = SlotMapBench_hashMapGet, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "slotmap/scan items", .items = ENTITY_COUNT, .run = SlotMapBench_scan, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "slotmap/pointer table scan baseline", .items = ENTITY_COUNT, .run = SlotMapBench_pointerScan, .ctx = &self });
+    Bench_run(&(BenchCase) { .name = "slotmap/remove + insert", .items = ENTITY_COUNT, .run = SlotMapBench_churn, .ctx = &self });
+
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        Allocator_destroyItem(&self.stdAlloc, self.pointers.data[i]);
+    }
+    Allocator_destroyItems(&self.stdAlloc, self.order);
+    Allocator_destroyItems(&self.stdAlloc, self.handles);
+    Allocator_destroyItems(&self.stdAlloc, self.pointers);
+    HashMap_deinit(&self.byId);
+    SlotMap_free(&self.entities);
+}
@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/sort.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+typedef struct SortBench SortBench;
+
+// Each run sorts a fresh copy of 'source', restored by the untimed setup.
+struct SortBench {
+    Allocator* scratch;
+    size_t threads;
+    u64s sourceU64;
+    u64s dataU64;
+    cstrs sourceCstr;
+    cstrs dataCstr;
+};
+
+static int compareU64(const void *const a, const void *const b) {
+    const uint64_t x = *(const uint64_t*)a;
+    const uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compareCstr(const void *const a, const void *const b) {
+    const cstr x = *(const cstr*)a;
+    const cstr y = *(const cstr*)b;
+    const int result = memcmp(x.data, y.data, n5_min(x.size, y.size));
+    return (result != 0) ? result : (x.size > y.size) - (x.size < y.size);
+}
+
+static uint64_t SortBench_resetU64(void *const ctx) {
+    SortBench *const self = ctx;
+    Slice_copyTo(self->dataU64, self->sourceU64);
+    return 0;
+}
+
+static uint64_t SortBench_resetCstr(void *const ctx) {
+    SortBench *const self = ctx;
+    Slice_copyTo(self->dataCstr, self->sourceCstr);
+    return 0;
+}
+
+static uint64_t SortBench_qsortU64(void *const ctx) {
+    SortBench *const self = ctx;
+    qsort(self->dataU64.data, self->dataU64.size, sizeof(uint64_t), compareU64);
+    return self->dataU64.data[0];
+}
+
+static uint64_t SortBench_radixU64(void *const ctx) {
+    SortBench *const self = ctx;
+    sort_radix_u64(self->dataU64, self->scratch, self->threads);
+    return self->dataU64.data[0];
+}
+
+static uint64_t SortBench_qsortCstr(void *const ctx) {
+    SortBench *const self = ctx;
+    qsort(self->dataCstr.data, self->dataCstr.size, sizeof(cstr), compareCstr);
+    return self->dataCstr.data[0].size;
+}
+
+static uint64_t SortBench_radixCstr(void *const ctx) {
+    SortBench *const self = ctx;
+    sort_radix_cstr(self->dataCstr, self->scratch, self->threads);
+    return self->dataCstr.data[0].size;
+}
+
+static void checkSortedU64(const char *const name, const u64s data) {
+    for (size_t i = 1; i < data.size; ++i) {
+        if (data.data[i - 1] > data.data[i]) {
+            fprintf(stderr, "[bench_sort] error: %s produced unsorted output.\n", name);
+            return;
+        }
+    }
+}
+
+static void checkSortedCstr(const char *const name, const cstrs data) {
+    for (size_t i = 1; i < data.size; ++i) {
+        if (compareCstr(&data.data[i - 1], &data.data[i]) > 0) {
+            fprintf(stderr, "[bench_sort] error: %s produced unsorted output.\n", name);
+            return;
+        }
+    }
+}
+
+static void bench_sortU64(const size_t count, const size_t threadCount) {
+    Allocator stdAlloc = StdAlloc_init();
+    SortBench self = {
+        .scratch = &stdAlloc,
+        .sourceU64 = Allocator_createItems(&stdAlloc, uint64_t, count),
+        .dataU64 = Allocator_createItems(&stdAlloc, uint64_t, count),
+    };
+    for (size_t i = 0; i < count; ++i) {
+        self.sourceU64.data[i] = n5_hash_u64(i);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "sort/qsort u64/%zu", count);
+    Bench_run(&(BenchCase) {
+        .name = name,
+        .items = count,
+        .setup = SortBench_resetU64,
+        .run = SortBench_qsortU64,
+        .ctx = &self,
+    });
+
+    for (size_t threads = 1; threads <= threadCount; threads *= 2) {
+        self.threads = threads;
+        snprintf(name, sizeof(name), "sort/sort_radix_u64 (%zu thr)/%zu", threads, count);
+        const bool ran = Bench_run(&(BenchCase) {
+            .name = name,
+            .items = count,
+            .setup = SortBench_resetU64,
+            .run = SortBench_radixU64,
+            .ctx = &self,
+        });
+        if (ran) {
+            SortBench_resetU64(&self);
+            SortBench_radixU64(&self);
+            checkSortedU64(name, self.dataU64);
+        }
+    }
+
+    Allocator_destroyItems(&stdAlloc, self.dataU64);
+    Allocator_destroyItems(&stdAlloc, self.sourceU64);
+}
+
+static void bench_sortCstr(const size_t count, const size_t threadCount) {
+    Allocator stdAlloc = StdAlloc_init();
+
+    // keys look like "user:<hex id>" to give the sort a shared prefix to skip.
+    Slice(char) text = Allocator_createItems(&stdAlloc, char, count * 24);
+    SortBench self = {
+        .scratch = &stdAlloc,
+        .sourceCstr = Allocator_createItems(&stdAlloc, cstr, count),
+        .dataCstr = Allocator_createItems(&stdAlloc, cstr, count),
+    };
+    char* cursor = text.data;
+    for (size_t i = 0; i < count; ++i) {
+        const int length = snprintf(cursor, 24, "user:%llx", (unsigned long long)(n5_hash_u64(i) >> 20));
+        self.sourceCstr.data[i] = (cstr)Slice_from(cursor, (size_t)length);
+        cursor += length;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "sort/qsort cstr/%zu", count);
+    Bench_run(&(BenchCase) {
+        .name = name,
+        .items = count,
+        .setup = SortBench_resetCstr,
+        .run = SortBench_qsortCstr,
+        .ctx = &self,
+    });
+
+    for (size_t threads = 1; threads <= threadCount; threads *= 2) {
+        self.threads = threads;
+        snprintf(name, sizeof(name), "sort/sort_radix_cstr (%zu thr)/%zu", threads, count);
+        const bool ran = Bench_run(&(BenchCase) {
+            .name = name,
+            .items = count,
+            .setup = SortBench_resetCstr,
+            .run = SortBench_radixCstr,
+            .ctx = &self,
+        });
+        if (ran) {
+            SortBench_resetCstr(&self);
+            SortBench_radixCstr(&self);
+            checkSortedCstr(name, self.dataCstr);
+        }
+    }
+
+    Allocator_destroyItems(&stdAlloc, self.dataCstr);
+    Allocator_destroyItems(&stdAlloc, self.sourceCstr);
+    Allocator_destroyItems(&stdAlloc, text);
+}
+
+void bench_sort(void) {
+    // note: 100M elements needs a few GiB, so it's opt-in.
+    const bool large = getenv("N5_BENCH_LARGE") != NULL;
+    const size_t threadCount = 4;
+
+    for (size_t count = 1000000; count <= (large ? 100000000u : 10000000u); count *= 10) {
+        bench_sortU64(count, threadCount);
+    }
+    for (size_t count = 1000000; count <= (large ? 100000000u : 1000000u); count *= 10) {
+        bench_sortCstr(count, threadCount);
+    }
+}
@@ -0,0 +1,276 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/format.h"
+#include "n5/sort.h"
+#include "n5/str.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+
+#include "bench.h"
+
+#define APPEND_COUNT 4096
+#define FORMAT_COUNT 1024
+#define PARSE_COUNT 4096
+#define CASE_SIZE (64 * 1024)
+
+typedef struct StringBench StringBench;
+
+struct StringBench {
+    String string;
+    char buffer[256];
+    cstrs numbers;
+    cstrs signedNumbers;
+    str text;
+    str upper;
+};
+
+static uint64_t StringBench_appendStr(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_str(&self->string, cstr_literal("key=value;"));
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendChar(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_char(&self->string, (char)('a' + i % 26));
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendU64(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_u64(&self->string, n5_hash_u64(i) >> (i % 64), false);
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendU64Hex(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_u64(&self->string, n5_hash_u64(i) >> (i % 64), true);
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendI64(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_i64(&self->string, (int64_t)(n5_hash_u64(i) >> (i % 64)) - 1000, false);
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendF64(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_f64(&self->string, (double)i * 0.37);
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_appendBool(void *const ctx) {
+    StringBench *const self = ctx;
+    self->string.str.size = 0;
+    for (size_t i = 0; i < APPEND_COUNT; ++i) {
+        String_append_bool(&self->string, (i & 1) != 0);
+    }
+    return self->string.str.size;
+}
+
+static uint64_t StringBench_format(void *const ctx) {
+    StringBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < FORMAT_COUNT; ++i) {
+        String_format(
+            &self->string,
+            cstr_literal("[{}] handled {} #{} in {}ms ok={}"),
+            FormatArg_u64(i),
+            FormatArg_str(cstr_literal("request")),
+            FormatArg_i64(-(int64_t)i),
+            FormatArg_f64(1.25),
+            FormatArg_bool(true)
+        );
+        checksum += self->string.str.size;
+    }
+    return checksum;
+}
+
+// The baseline for String_format_raw: libc's formatter into a fixed buffer.
+static uint64_t StringBench_snprintf(void *const ctx) {
+    StringBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < FORMAT_COUNT; ++i) {
+        checksum += (uint64_t)snprintf(
+            self->buffer,
+            sizeof(self->buffer),
+            "[%zu] handled %s #%lld in %gms ok=%s",
+            i,
+            "request",
+            -(long long)i,
+            1.25,
+            "true"
+        );
+    }
+    return checksum;
+}
+
+static uint64_t StringBench_parseU64(void *const ctx) {
+    const StringBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < self->numbers.size; ++i) {
+        uint64_t value;
+        if (str_tryParse_u64(self->numbers.data[i], &value)) {
+            checksum += value;
+        }
+    }
+    return checksum;
+}
+
+static uint64_t StringBench_parseI64(void *const ctx) {
+    const StringBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < self->signedNumbers.size; ++i) {
+        int64_t value;
+        if (str_tryParse_i64(self->signedNumbers.data[i], &value)) {
+            checksum += (uint64_t)value;
+        }
+    }
+    return checksum;
+}
+
+// The baseline for str_tryParse_u64; strtoull needs a terminator, so the views
+//  point into a buffer with one after every number.
+static uint64_t StringBench_strtoull(void *const ctx) {
+    const StringBench *const self = ctx;
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < self->numbers.size; ++i) {
+        checksum += strtoull(self->numbers.data[i].data, NULL, 10);
+    }
+    return checksum;
+}
+
+static uint64_t StringBench_toLower(void *const ctx) {
+    const StringBench *const self = ctx;
+    str_toLower(self->text);
+    str_toUpper(self->text);
+    return (uint8_t)self->text.data[0];
+}
+
+// The baseline for str_toLower: a byte loop, which compilers won't vectorize
+//  through the locale-aware tolower/toupper.
+static uint64_t StringBench_tolowerLoop(void *const ctx) {
+    const StringBench *const self = ctx;
+    for (size_t i = 0; i < self->text.size; ++i) {
+        self->text.data[i] = (char)tolower((unsigned char)self->text.data[i]);
+    }
+    for (size_t i = 0; i < self->text.size; ++i) {
+        self->text.data[i] = (char)toupper((unsigned char)self->text.data[i]);
+    }
+    return (uint8_t)self->text.data[0];
+}
+
+static uint64_t StringBench_equalsIgnoreCase(void *const ctx) {
+    const StringBench *const self = ctx;
+    return cstr_equalsIgnoreCase(cstr_cast(self->text), cstr_cast(self->upper));
+}
+
+static uint64_t StringBench_equalsIgnoreCaseLoop(void *const ctx) {
+    const StringBench *const self = ctx;
+    for (size_t i = 0; i < self->text.size; ++i) {
+        if (tolower((unsigned char)self->text.data[i]) != tolower((unsigned char)self->upper.data[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint64_t StringBench_hashIgnoreCase(void *const ctx) {
+    const StringBench *const self = ctx;
+    return cstr_hashIgnoreCase(cstr_cast(self->text));
+}
+
+void bench_string(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    static StringBench self;
+    self.string = String_new(&stdAlloc, APPEND_COUNT * 24);
+
+    // numbers have 1 to 20 digits, each followed by a '\0' for strtoull.
+    Slice(char) text = Allocator_createItems(&stdAlloc, char, PARSE_COUNT * 2 * 22);
+    self.numbers = (cstrs)Allocator_createItems(&stdAlloc, cstr, PARSE_COUNT);
+    self.signedNumbers = (cstrs)Allocator_createItems(&stdAlloc, cstr, PARSE_COUNT);
+    char* cursor = text.data;
+    for (size_t i = 0; i < PARSE_COUNT; ++i) {
+        const int length = snprintf(cursor, 22, "%llu", (unsigned long long)(n5_hash_u64(i) >> (i % 64)));
+        self.numbers.data[i] = (cstr)Slice_from(cursor, (size_t)length);
+        cursor += length + 1;
+    }
+    for (size_t i = 0; i < PARSE_COUNT; ++i) {
+        const int length = snprintf(cursor, 22, "%lld", (long long)(n5_hash_u64(i) >> (i % 64 + 1)) * ((i & 1) ? -1 : 1));
+        self.signedNumbers.data[i] = (cstr)Slice_from(cursor, (size_t)length);
+        cursor += length + 1;
+    }
+
+    // note: mixed-case prose; both buffers are left upper-cased by every run.
+    self.text = (str)Allocator_createItems(&stdAlloc, char, CASE_SIZE);
+    self.upper = (str)Allocator_createItems(&stdAlloc, char, CASE_SIZE);
+    for (size_t i = 0; i < CASE_SIZE; ++i) {
+        const uint64_t hash = n5_hash_u64(i);
+        self.text.data[i] = (hash % 6 == 0) ? ' ' : (char)(((hash & 1) ? 'a' : 'A') + (hash >> 8) % 26);
+    }
+    str_toUpper(self.text);
+    memcpy(self.upper.data, self.text.data, CASE_SIZE);
+
+    static const struct {
+        const char* name;
+        size_t items;
+        BenchFn run;
+    } cases[] = {
+        { "string/append_str", APPEND_COUNT, StringBench_appendStr },
+        { "string/append_char", APPEND_COUNT, StringBench_appendChar },
+        { "string/append_u64", APPEND_COUNT, StringBench_appendU64 },
+        { "string/append_u64 (hex)", APPEND_COUNT, StringBench_appendU64Hex },
+        { "string/append_i64", APPEND_COUNT, StringBench_appendI64 },
+        { "string/append_f64", APPEND_COUNT, StringBench_appendF64 },
+        { "string/append_bool", APPEND_COUNT, StringBench_appendBool },
+        { "format/String_format_raw", FORMAT_COUNT, StringBench_format },
+        { "format/snprintf", FORMAT_COUNT, StringBench_snprintf },
+        { "parse/str_tryParse_u64", PARSE_COUNT, StringBench_parseU64 },
+        { "parse/str_tryParse_i64", PARSE_COUNT, StringBench_parseI64 },
+        { "parse/strtoull", PARSE_COUNT, StringBench_strtoull },
+        { "case/str_toLower + toUpper (items = bytes)", CASE_SIZE * 2, StringBench_toLower },
+        { "case/tolower + toupper loop (items = bytes)", CASE_SIZE * 2, StringBench_tolowerLoop },
+        { "case/cstr_equalsIgnoreCase (items = bytes)", CASE_SIZE, StringBench_equalsIgnoreCase },
+        { "case/tolower compare loop (items = bytes)", CASE_SIZE, StringBench_equalsIgnoreCaseLoop },
+        { "case/cstr_hashIgnoreCase (items = bytes)", CASE_SIZE, StringBench_hashIgnoreCase },
+    };
+    for (size_t i = 0; i < n5_arraySize(cases); ++i) {
+        Bench_run(&(BenchCase) {
+            .name = cases[i].name,
+            .items = cases[i].items,
+            .run = cases[i].run,
+            .ctx = &self,
+        });
+    }
+
+    Allocator_destroyItems(&stdAlloc, self.upper);
+    Allocator_destroyItems(&stdAlloc, self.text);
+    Allocator_destroyItems(&stdAlloc, self.signedNumbers);
+    Allocator_destroyItems(&stdAlloc, self.numbers);
+    Allocator_destroyItems(&stdAlloc, text);
+    String_free(&self.string);
+}
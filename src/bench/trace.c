@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "n5/alloc.h"
+#include "n5/trace.h"
+
+#include "bench.h"
+
+#define RECORD_COUNT 4096
+
+static uint64_t TraceBench_record(void *const ctx) {
+    (void)ctx;
+    for (size_t i = 0; i < RECORD_COUNT / 2; ++i) {
+        Trace_record(trace_begin, "bench.span", 0);
+        Trace_record(trace_end, "bench.span", 0);
+    }
+    return RECORD_COUNT;
+}
+
+// Calls Trace_record directly, so this measures the per-event cost whether or
+//  not the library's own instrumentation is compiled in.
+void bench_trace(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    if (!Trace_init(&stdAlloc, RECORD_COUNT)) {
+        return;
+    }
+
+    Bench_run(&(BenchCase) {
+        .name = "trace/Trace_record",
+        .items = RECORD_COUNT,
+        .run = TraceBench_record,
+    });
+
+    Trace_deinit();
+}
@@ -0,0 +1,153 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "n5/alloc.h"
+#include "n5/string.h"
+#include "n5/utils.h"
+#include "n5/writer.h"
+
+#include "bench.h"
+
+#define RECORDS 100000
+#define CHUNK_SIZE (64 * 1024)
+#define QUEUE_DEPTH 64
+#define RECORD_MAX 32
+
+typedef struct WriterBench WriterBench;
+
+typedef enum WriterMode {
+    // Each record is a slice of one preallocated text buffer, written borrowed.
+    writer_record,
+    // Each record is its own String handed to the writer, so the allocation is timed too.
+    writer_string,
+    // Records are packed into 64KB Strings.
+    writer_chunk,
+} WriterMode;
+
+struct WriterBench {
+    Allocator* allocator;
+    FILE* file;
+    AsyncBackend backend;
+    WriterMode mode;
+    String text;
+};
+
+static void appendRecord(String *const line, const size_t i) {
+    String_append_str(line, cstr_literal("event "));
+    String_append_u64(line, i, false);
+    String_append_str(line, cstr_literal(" value="));
+    String_append_i64(line, -(int64_t)(i * 7), false);
+    String_append_char(line, '\n');
+}
+
+// Every run starts from an empty file, so the page cache footprint stays flat.
+static uint64_t WriterBench_reset(void *const ctx) {
+    WriterBench *const self = ctx;
+    rewind(self->file);
+    return (uint64_t)ftruncate(fileno(self->file), 0);
+}
+
+static uint64_t WriterBench_fwrite(void *const ctx) {
+    WriterBench *const self = ctx;
+    String line = String_new(self->allocator, 64);
+    size_t bytes = 0;
+    for (size_t i = 0; i < RECORDS; ++i) {
+        line.str.size = 0;
+        appendRecord(&line, i);
+        bytes += fwrite(line.str.data, 1, line.str.size, self->file);
+    }
+    fflush(self->file);
+    String_free(&line);
+    return bytes;
+}
+
+static uint64_t WriterBench_async(void *const ctx) {
+    WriterBench *const self = ctx;
+    AsyncWriter writer;
+    if (!AsyncWriter_init(&writer, self->allocator, fileno(self->file), QUEUE_DEPTH, self->backend)) {
+        return 0;
+    }
+
+    size_t bytes = 0;
+    if (self->mode == writer_record) {
+        // note: the text buffer is big enough up front, so records never move.
+        String *const text = &self->text;
+        text->str.size = 0;
+        for (size_t i = 0; i < RECORDS; ++i) {
+            const size_t start = text->str.size;
+            appendRecord(text, i);
+            const cstr record = (cstr)Slice_from(text->str.data + start, text->str.size - start);
+            bytes += record.size;
+            AsyncWriter_write(&writer, record, NULL, (Block) { 0 });
+        }
+    } else {
+        const bool chunked = self->mode == writer_chunk;
+        const size_t capacity = chunked ? CHUNK_SIZE : RECORD_MAX;
+        String chunk = String_new(self->allocator, capacity);
+        for (size_t i = 0; i < RECORDS; ++i) {
+            appendRecord(&chunk, i);
+            if (!chunked || chunk.str.size + 64 > CHUNK_SIZE) {
+                bytes += chunk.str.size;
+                AsyncWriter_writeString(&writer, &chunk);
+                chunk = String_new(self->allocator, capacity);
+            }
+        }
+        bytes += chunk.str.size;
+        AsyncWriter_writeString(&writer, &chunk);
+    }
+    if (!AsyncWriter_flush(&writer)) {
+        fprintf(stderr, "[bench_writer] error: async writes failed.\n");
+    }
+    AsyncWriter_deinit(&writer);
+    return bytes;
+}
+
+void bench_writer(void) {
+    Allocator stdAlloc = StdAlloc_init();
+    WriterBench self = {
+        .allocator = &stdAlloc,
+        .file = tmpfile(),
+        .text = String_new(&stdAlloc, RECORDS * RECORD_MAX),
+    };
+    if (self.file == NULL) {
+        fprintf(stderr, "[bench_writer] error: failed to create a temporary file.\n");
+        String_free(&self.text);
+        return;
+    }
+
+    Bench_run(&(BenchCase) {
+        .name = "writer/fwrite",
+        .items = RECORDS,
+        .setup = WriterBench_reset,
+        .run = WriterBench_fwrite,
+        .ctx = &self,
+    });
+
+    static const struct {
+        const char* name;
+        AsyncBackend backend;
+        WriterMode mode;
+    } cases[] = {
+        { "writer/AsyncWriter uring/record", async_backend_uring, writer_record },
+        { "writer/AsyncWriter uring/record + String alloc", async_backend_uring, writer_string },
+        { "writer/AsyncWriter uring/64KB", async_backend_uring, writer_chunk },
+        { "writer/AsyncWriter thread/record", async_backend_thread, writer_record },
+        { "writer/AsyncWriter thread/record + String alloc", async_backend_thread, writer_string },
+        { "writer/AsyncWriter thread/64KB", async_backend_thread, writer_chunk },
+    };
+    for (size_t i = 0; i < n5_arraySize(cases); ++i) {
+        self.backend = cases[i].backend;
+        self.mode = cases[i].mode;
+        Bench_run(&(BenchCase) {
+            .name = cases[i].name,
+            .items = RECORDS,
+            .setup = WriterBench_reset,
+            .run = WriterBench_async,
+            .ctx = &self,
+        });
+    }
+
+    String_free(&self.text);
+    fclose(self.file);
+}
@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "n5/trace.h"
 #include "n5/utils.h"
 
 const IAllocator StdAllocVtbl = {
@@ -18,7 +19,9 @@ Allocator StdAlloc_init(void) {
 
 Block StdAlloc_alloc(Allocator *const self, const AllocInfo *const info) {
     (void)self;
+    Trace_begin("StdAlloc_alloc");
     void *const data = malloc(info->size);
+    Trace_end("StdAlloc_alloc");
     return (Block) {
         .data = data,
         .size = (data != NULL) ? info->size : 0,
@@ -27,12 +30,15 @@ Block StdAlloc_alloc(Allocator *const self, const AllocInfo *const info) {
 
 void StdAlloc_free(Allocator *const self, const FreeInfo *const info) {
     (void)self;
+    Trace_begin("StdAlloc_free");
     free(info->memory.data);
+    Trace_end("StdAlloc_free");
 }
 
 const IAllocator ArenaVtbl = {
     .alloc = Arena_alloc,
     .free = Arena_free,
+    .resize = Arena_resize,
 };
 
 bool Arena_init(Arena *const self, Allocator *const owner, const size_t size) {
@@ -82,6 +88,8 @@ Block Arena_alloc(Allocator *const base, const AllocInfo *const info) {
     }
 
     self->offset = (uintptr_t)memoryEnd - (uintptr_t)self->pool.data;
+    // note: a bump is too cheap to be worth a span; the fill level is more telling.
+    Trace_counter("Arena.offset", self->offset);
 
     memory.data = memoryStart;
     memory.size = info->size;
@@ -99,6 +107,25 @@ void Arena_free(Allocator *const base, const FreeInfo *const info) {
     }
 }
 
+bool Arena_resize(Allocator *const base, const ResizeInfo *const info) {
+    Arena *const self = (Arena*)base;
+
+    // only the most recent allocation can be resized in place.
+    void *const poolStart = (uint8_t*)self->pool.data + self->offset;
+    void *const memoryEnd = (uint8_t*)info->memory.data + info->memory.size;
+    if (poolStart != memoryEnd) {
+        return false;
+    }
+
+    const size_t memoryOffset = (uintptr_t)info->memory.data - (uintptr_t)self->pool.data;
+    if (info->size > self->pool.size - memoryOffset) {
+        return false;
+    }
+
+    self->offset = memoryOffset + info->size;
+    return true;
+}
+
 const IAllocator TestAllocVtbl = {
     .alloc = TestAlloc_alloc,
     .free = TestAlloc_free,
@@ -139,12 +166,14 @@ void TestAlloc_deinit(TestAlloc *const self) {
 
 Block TestAlloc_alloc(Allocator *const base, const AllocInfo *const info) {
     TestAlloc *const self = (TestAlloc*)base;
+    Trace_begin("TestAlloc_alloc");
 
     Block memory = StdAlloc_alloc(NULL, &(AllocInfo) {
         .size = info->size + sizeof(TestAllocHeader),
     });
 
     if (memory.data == NULL) {
+        Trace_end("TestAlloc_alloc");
         return memory;
     }
 
@@ -158,6 +187,7 @@ Block TestAlloc_alloc(Allocator *const base, const AllocInfo *const info) {
     memory.data = header + 1;
     memory.size = info->size;
 
+    Trace_end("TestAlloc_alloc");
     return memory;
 }
 
@@ -165,6 +195,7 @@ void TestAlloc_free(Allocator *const base, const FreeInfo *const info) {
     TestAlloc *const self = (TestAlloc*)base;
 
     TestAllocHeader *const target = (TestAllocHeader*)info->memory.data - 1;
+    Trace_begin("TestAlloc_free");
 
     TestAllocHeader** node = &self->head;
     while (*node != NULL) {
@@ -176,6 +207,7 @@ void TestAlloc_free(Allocator *const base, const FreeInfo *const info) {
                     .size = target->size,
                 },
             });
+            Trace_end("TestAlloc_free");
             return;
         }
 
@@ -189,4 +221,5 @@ void TestAlloc_free(Allocator *const base, const FreeInfo *const info) {
         info->debugInfo.line,
         info->memory.data
     );
+    Trace_end("TestAlloc_free");
 }
@@ -0,0 +1,425 @@
+#include "n5/binary.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BINARY_SSE2 1
+#include <emmintrin.h>
+#else
+#define BINARY_SSE2 0
+#endif
+
+#define VARINT_CHUNK 16
+#define WRITE_CHUNK 64
+
+static inline size_t varintSize(const uint64_t value) {
+    return 1 + (63 - n5_clz64(value | 1)) / 7;
+}
+
+static inline uint8_t* varintEncode(uint8_t* dest, uint64_t value) {
+    while (value >= 0x80) {
+        *dest++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *dest++ = (uint8_t)value;
+    return dest;
+}
+
+static inline void storeLE(uint8_t *const dest, const uint64_t value, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        dest[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static inline uint64_t loadLE(const uint8_t *const src, const size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= (uint64_t)src[i] << (i * 8);
+    }
+    return value;
+}
+
+// Returns space for exactly 'size' more bytes, or NULL if it can't be had.
+static uint8_t* BinWriter_reserve(BinWriter *const self, const size_t size) {
+    if (self->string != NULL) {
+        String *const string = self->string;
+        if (!String_grow(string, string->str.size + size)) {
+            return NULL;
+        }
+        uint8_t *const dest = (uint8_t*)string->str.data + string->str.size;
+        string->str.size += size;
+        string->str.data[string->str.size] = '\0';
+        return dest;
+    }
+
+    if (size > self->block.size - self->size) {
+        return NULL;
+    }
+    uint8_t *const dest = (uint8_t*)self->block.data + self->size;
+    self->size += size;
+    return dest;
+}
+
+static size_t BinWriter_position(const BinWriter *const self) {
+    return (self->string != NULL) ? self->string->str.size : self->size;
+}
+
+// Gives back reserved bytes past 'position'.
+static void BinWriter_rewind(BinWriter *const self, const size_t position) {
+    if (self->string != NULL) {
+        self->string->str.size = position;
+        self->string->str.data[position] = '\0';
+    } else {
+        self->size = position;
+    }
+}
+
+BinWriter BinWriter_fromString(String *const string) {
+    assert(string != NULL);
+    return (BinWriter) { .string = string };
+}
+
+BinWriter BinWriter_fromBlock(const Block block) {
+    assert(block.data != NULL || block.size == 0);
+    return (BinWriter) { .block = block };
+}
+
+cstr BinWriter_view(const BinWriter *const self) {
+    assert(self != NULL);
+    if (self->string != NULL) {
+        return cstr_cast(self->string->str);
+    }
+    return (cstr)Slice_from((const char*)self->block.data, self->size);
+}
+
+static bool BinWriter_writeFixed(BinWriter *const self, const uint64_t value, const size_t size) {
+    uint8_t *const dest = BinWriter_reserve(self, size);
+    if (dest == NULL) {
+        return false;
+    }
+    storeLE(dest, value, size);
+    return true;
+}
+
+bool BinWriter_write_u8(BinWriter *const self, const uint8_t value) {
+    return BinWriter_writeFixed(self, value, sizeof(value));
+}
+
+bool BinWriter_write_u16(BinWriter *const self, const uint16_t value) {
+    return BinWriter_writeFixed(self, value, sizeof(value));
+}
+
+bool BinWriter_write_u32(BinWriter *const self, const uint32_t value) {
+    return BinWriter_writeFixed(self, value, sizeof(value));
+}
+
+bool BinWriter_write_u64(BinWriter *const self, const uint64_t value) {
+    return BinWriter_writeFixed(self, value, sizeof(value));
+}
+
+bool BinWriter_write_i32(BinWriter *const self, const int32_t value) {
+    return BinWriter_writeFixed(self, (uint32_t)value, sizeof(value));
+}
+
+bool BinWriter_write_i64(BinWriter *const self, const int64_t value) {
+    return BinWriter_writeFixed(self, (uint64_t)value, sizeof(value));
+}
+
+bool BinWriter_write_f32(BinWriter *const self, const float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return BinWriter_writeFixed(self, bits, sizeof(bits));
+}
+
+bool BinWriter_write_f64(BinWriter *const self, const double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return BinWriter_writeFixed(self, bits, sizeof(bits));
+}
+
+bool BinWriter_write_varU64(BinWriter *const self, const uint64_t value) {
+    uint8_t *const dest = BinWriter_reserve(self, varintSize(value));
+    if (dest == NULL) {
+        return false;
+    }
+    varintEncode(dest, value);
+    return true;
+}
+
+bool BinWriter_write_varI64(BinWriter *const self, const int64_t value) {
+    return BinWriter_write_varU64(self, n5_zigzag_encode(value));
+}
+
+bool BinWriter_write_blob(BinWriter *const self, const cstr blob) {
+    uint8_t *const dest = BinWriter_reserve(self, varintSize(blob.size) + blob.size);
+    if (dest == NULL) {
+        return false;
+    }
+    uint8_t *const payload = varintEncode(dest, blob.size);
+    if (blob.size > 0) {
+        memcpy(payload, blob.data, blob.size);
+    }
+    return true;
+}
+
+bool BinWriter_write_varU64s(BinWriter *const self, const u64s values) {
+    assert(self != NULL);
+    assert(values.data != NULL || values.size == 0);
+
+    // Each chunk reserves its worst case, is encoded in one pass and hands back
+    //  the slack, so values are neither sized first nor reserved one at a time.
+    const size_t start = BinWriter_position(self);
+    for (size_t i = 0; i < values.size; i += WRITE_CHUNK) {
+        const size_t count = n5_min(values.size - i, (size_t)WRITE_CHUNK);
+        const size_t position = BinWriter_position(self);
+        uint8_t* dest = BinWriter_reserve(self, count * BINARY_MAX_VARINT_SIZE);
+        if (dest == NULL) {
+            // note: near the end of a Block the worst case may not fit where the
+            //  real size does, so size the chunk exactly before giving up.
+            size_t size = 0;
+            for (size_t j = 0; j < count; ++j) {
+                size += varintSize(values.data[i + j]);
+            }
+            dest = BinWriter_reserve(self, size);
+            if (dest == NULL) {
+                BinWriter_rewind(self, start);
+                return false;
+            }
+        }
+
+        uint8_t *const begin = dest;
+        for (size_t j = 0; j < count; ++j) {
+            dest = varintEncode(dest, values.data[i + j]);
+        }
+        BinWriter_rewind(self, position + (size_t)(dest - begin));
+    }
+    return true;
+}
+
+BinReader BinReader_from(const cstr data) {
+    assert(data.data != NULL || data.size == 0);
+    return (BinReader) { .data = data };
+}
+
+static bool BinReader_readFixed(BinReader *const self, uint64_t *const value, const size_t size) {
+    assert(self != NULL);
+    assert(value != NULL);
+
+    if (BinReader_remaining(self) < size) {
+        return false;
+    }
+    *value = loadLE((const uint8_t*)self->data.data + self->offset, size);
+    self->offset += size;
+    return true;
+}
+
+bool BinReader_read_u8(BinReader *const self, uint8_t *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(*value))) {
+        return false;
+    }
+    *value = (uint8_t)bits;
+    return true;
+}
+
+bool BinReader_read_u16(BinReader *const self, uint16_t *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(*value))) {
+        return false;
+    }
+    *value = (uint16_t)bits;
+    return true;
+}
+
+bool BinReader_read_u32(BinReader *const self, uint32_t *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(*value))) {
+        return false;
+    }
+    *value = (uint32_t)bits;
+    return true;
+}
+
+bool BinReader_read_u64(BinReader *const self, uint64_t *const value) {
+    return BinReader_readFixed(self, value, sizeof(*value));
+}
+
+bool BinReader_read_i32(BinReader *const self, int32_t *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(*value))) {
+        return false;
+    }
+    *value = (int32_t)(uint32_t)bits;
+    return true;
+}
+
+bool BinReader_read_i64(BinReader *const self, int64_t *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(*value))) {
+        return false;
+    }
+    *value = (int64_t)bits;
+    return true;
+}
+
+bool BinReader_read_f32(BinReader *const self, float *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(uint32_t))) {
+        return false;
+    }
+    const uint32_t bits32 = (uint32_t)bits;
+    memcpy(value, &bits32, sizeof(*value));
+    return true;
+}
+
+bool BinReader_read_f64(BinReader *const self, double *const value) {
+    uint64_t bits;
+    if (!BinReader_readFixed(self, &bits, sizeof(bits))) {
+        return false;
+    }
+    memcpy(value, &bits, sizeof(*value));
+    return true;
+}
+
+// Decodes one varint from [src, end), returning its size (0 if it's truncated
+//  or doesn't fit in 64 bits).
+static inline size_t varintDecode(const uint8_t *const src, const uint8_t *const end, uint64_t *const value) {
+    uint64_t result = 0;
+    const size_t available = n5_min((size_t)(end - src), (size_t)BINARY_MAX_VARINT_SIZE);
+    for (size_t i = 0; i < available; ++i) {
+        const uint64_t byte = src[i];
+        result |= (byte & 0x7f) << (7 * i);
+        if (byte < 0x80) {
+            // note: the 10th byte only has room for the top bit.
+            if (i == BINARY_MAX_VARINT_SIZE - 1 && byte > 1) {
+                return 0;
+            }
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+bool BinReader_read_varU64(BinReader *const self, uint64_t *const value) {
+    assert(self != NULL);
+    assert(value != NULL);
+
+    const uint8_t *const start = (const uint8_t*)self->data.data;
+    const size_t size = varintDecode(start + self->offset, start + self->data.size, value);
+    self->offset += size;
+    return size > 0;
+}
+
+bool BinReader_read_varI64(BinReader *const self, int64_t *const value) {
+    uint64_t bits;
+    if (!BinReader_read_varU64(self, &bits)) {
+        return false;
+    }
+    *value = n5_zigzag_decode(bits);
+    return true;
+}
+
+bool BinReader_read_blob(BinReader *const self, cstr *const blob) {
+    assert(blob != NULL);
+
+    const size_t start = self->offset;
+    uint64_t size;
+    if (!BinReader_read_varU64(self, &size)) {
+        return false;
+    }
+    if (size > BinReader_remaining(self)) {
+        self->offset = start;
+        return false;
+    }
+
+    *blob = (cstr)Slice_from(self->data.data + self->offset, (size_t)size);
+    self->offset += (size_t)size;
+    return true;
+}
+
+// Gathers the 7-bit groups of a varint of up to 8 bytes (already loaded
+//  little-endian, with continuation bits set) into one value, SWAR style.
+static inline uint64_t varintCompact(uint64_t bits, const size_t size) {
+    bits &= 0x7f7f7f7f7f7f7f7full >> (64 - 8 * size);
+    bits = ((bits & 0x7f007f007f007f00ull) >> 1) | (bits & 0x007f007f007f007full);
+    bits = ((bits & 0x3fff00003fff0000ull) >> 2) | (bits & 0x00003fff00003fffull);
+    bits = ((bits & 0x0fffffff00000000ull) >> 4) | (bits & 0x000000000fffffffull);
+    return bits;
+}
+
+// Returns a 16-bit mask with bit i set if byte i ends a varint.
+static inline uint32_t varintEnds(const uint8_t *const src) {
+#if BINARY_SSE2
+    const __m128i chunk = _mm_loadu_si128((const __m128i*)src);
+    return ~(uint32_t)_mm_movemask_epi8(chunk) & 0xffff;
+#else
+    uint32_t ends = 0;
+    for (size_t i = 0; i < VARINT_CHUNK; ++i) {
+        ends |= (uint32_t)(src[i] < 0x80) << i;
+    }
+    return ends;
+#endif
+}
+
+bool BinReader_read_varU64s(BinReader *const self, const u64s values) {
+    assert(self != NULL);
+    assert(values.data != NULL || values.size == 0);
+
+    const uint8_t *const start = (const uint8_t*)self->data.data + self->offset;
+    const uint8_t *const end = (const uint8_t*)self->data.data + self->data.size;
+    const uint8_t* src = start;
+    size_t count = 0;
+
+    // note: the chunk is copied into a zero-padded buffer so 8-byte loads never leave it.
+    uint8_t chunk[VARINT_CHUNK + 8] = { 0 };
+    while (count < values.size && (size_t)(end - src) >= VARINT_CHUNK) {
+        uint32_t ends = varintEnds(src);
+        if (ends == 0xffff && values.size - count >= VARINT_CHUNK) {
+            // the common case for small values: sixteen 1-byte varints.
+            for (size_t i = 0; i < VARINT_CHUNK; ++i) {
+                values.data[count + i] = src[i];
+            }
+            count += VARINT_CHUNK;
+            src += VARINT_CHUNK;
+            continue;
+        }
+        if (ends == 0) {
+            // a 16-byte run without an end is malformed; let the scalar path reject it.
+            break;
+        }
+
+        memcpy(chunk, src, VARINT_CHUNK);
+        size_t position = 0;
+        while (ends != 0 && count < values.size) {
+            const size_t last = n5_ctz32(ends);
+            const size_t size = last + 1 - position;
+            if (size > 8) {
+                // note: 9 and 10 byte varints (values >= 2^56) are rare; decode them one byte at a time.
+                if (varintDecode(chunk + position, chunk + last + 1, &values.data[count]) == 0) {
+                    return false;
+                }
+            } else {
+                values.data[count] = varintCompact(loadLE(chunk + position, 8), size);
+            }
+            ++count;
+            position = last + 1;
+            ends &= ends - 1;
+        }
+        src += position;
+    }
+
+    for (; count < values.size; ++count) {
+        const size_t size = varintDecode(src, end, &values.data[count]);
+        if (size == 0) {
+            return false;
+        }
+        src += size;
+    }
+
+    self->offset += (size_t)(src - start);
+    return true;
+}
@@ -0,0 +1,312 @@
+#include "n5/csv.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/simd.h"
+#include "n5/utils.h"
+
+#define CSV_MIN_FIELDS 16
+#define CSV_MIN_CARRY 256
+
+static inline void CsvScanner_reset(CsvScanner *const self, const size_t base, const uint64_t inQuotes) {
+    *self = (CsvScanner) {
+        .base = base,
+        .inQuotes = inQuotes,
+    };
+}
+
+// Returns the offset of the next delimiter or newline outside quotes, or
+//  SIZE_MAX once 'data' is used up. Blocks start wherever the scan started,
+//  so resuming mid-chunk (after a stitched record) needs no realignment.
+static size_t CsvScanner_next(CsvScanner *const self, const CsvReader *const reader, const cstr data, bool *const newline) {
+    while (self->separators == 0) {
+        if (self->loaded) {
+            self->base += 64;
+        }
+        if (self->base >= data.size) {
+            self->loaded = false;
+            return SIZE_MAX;
+        }
+        self->loaded = true;
+
+        const char* block = data.data + self->base;
+        const size_t remaining = data.size - self->base;
+        uint64_t valid = ~0ull;
+        char tail[64];
+        if (remaining < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, remaining);
+            block = tail;
+            valid = (1ull << remaining) - 1;
+        }
+
+        const uint8_t needles[] = { (uint8_t)reader->delimiter, '\n', '"' };
+        uint64_t masks[n5_arraySize(needles)];
+        n5_simd->matchBlock(block, needles, reader->quoting ? 3 : 2, masks);
+
+        uint64_t quoted = 0;
+        if (reader->quoting) {
+            // note: "" inside a quoted field toggles out and straight back in.
+            quoted = n5_prefixXor64(masks[2] & valid) ^ self->inQuotes;
+            self->inQuotes = (uint64_t)((int64_t)quoted >> 63);
+        }
+        self->separators = (masks[0] | masks[1]) & valid & ~quoted;
+        self->newlines = masks[1] & valid & ~quoted;
+    }
+
+    const uint64_t bit = self->separators & (0 - self->separators);
+    self->separators ^= bit;
+    *newline = (self->newlines & bit) != 0;
+    return self->base + n5_ctz64(bit);
+}
+
+static bool CsvReader_fail(CsvReader *const self, const char *const message) {
+    fprintf(stderr, "[CsvReader] error: %s.\n", message);
+    self->failed = true;
+    return false;
+}
+
+static bool CsvReader_push(CsvReader *const self, const size_t index, const cstr field) {
+    if (index == self->fields.size) {
+        cstrs fields = (cstrs)Allocator_createItems(self->owner, cstr, self->fields.size * 2);
+        if (fields.data == NULL) {
+            return CsvReader_fail(self, "field array allocation failed");
+        }
+        memcpy(fields.data, self->fields.data, self->fields.size * sizeof(cstr));
+        Allocator_destroyItems(self->owner, self->fields);
+        self->fields = fields;
+    }
+    self->fields.data[index] = field;
+    return true;
+}
+
+// Strips a field's surrounding quotes; only when it also holds "" escapes
+//  is it copied (into the arena) to collapse them.
+static bool CsvReader_unquote(CsvReader *const self, cstr* field) {
+    cstr inner = cstr_slice(*field, 1, field->size - 1);
+    if (inner.size > 0 && inner.data[inner.size - 1] == '"') {
+        --inner.size;
+    }
+    if (cstr_findChar(inner, '"') == inner.size) {
+        *field = inner;
+        return true;
+    }
+
+    Block copy = Allocator_alloc(&self->arena->base, char, inner.size);
+    if (copy.data == NULL) {
+        return CsvReader_fail(self, "out of arena memory for unescaped fields");
+    }
+    char *const out = copy.data;
+    size_t size = 0;
+    for (size_t i = 0; i < inner.size; ++i) {
+        out[size++] = inner.data[i];
+        if (inner.data[i] == '"' && i + 1 < inner.size && inner.data[i + 1] == '"') {
+            ++i;
+        }
+    }
+    (void)Allocator_resize(&self->arena->base, copy, char, size);
+
+    *field = (cstr)Slice_from((const char*)out, size);
+    return true;
+}
+
+// Splits the record starting at 'position' in 'data' into self->fields,
+//  skipping blank lines. Sets 'count' to 0 (leaving 'position' alone) if
+//  'data' runs out before a newline, unless it's 'final' and the rest of
+//  'data' is the record. Returns false only on failure.
+static bool CsvReader_split(
+    CsvReader *const self,
+    CsvScanner *const scanner,
+    const cstr data,
+    size_t *const position,
+    const bool final,
+    size_t *const count
+) {
+    for (;;) {
+        const size_t start = *position;
+        size_t fieldStart = start;
+        size_t fields = 0;
+        for (;;) {
+            bool newline;
+            size_t end = CsvScanner_next(scanner, self, data, &newline);
+            if (end == SIZE_MAX) {
+                if (!final || start == data.size) {
+                    *count = 0;
+                    return true;
+                }
+                end = data.size;
+                newline = true;
+            }
+
+            size_t fieldEnd = end;
+            if (newline && fieldEnd > fieldStart && data.data[fieldEnd - 1] == '\r') {
+                --fieldEnd;
+            }
+            if (newline && fields == 0 && fieldEnd == fieldStart) {
+                // note: a blank line.
+                *position = n5_min(end + 1, data.size);
+                break;
+            }
+
+            cstr field = cstr_slice(data, fieldStart, fieldEnd - fieldStart);
+            if (self->quoting && field.size > 0 && field.data[0] == '"' && !CsvReader_unquote(self, &field)) {
+                return false;
+            }
+            if (!CsvReader_push(self, fields++, field)) {
+                return false;
+            }
+
+            if (newline) {
+                *position = n5_min(end + 1, data.size);
+                *count = fields;
+                return true;
+            }
+            fieldStart = end + 1;
+        }
+    }
+}
+
+bool CsvReader_init(
+    CsvReader *const self,
+    Allocator *const owner,
+    Arena *const arena,
+    const char delimiter,
+    const bool quoting
+) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(arena != NULL);
+    assert(delimiter != '\n' && delimiter != '"');
+
+    *self = (CsvReader) {
+        .owner = owner,
+        .arena = arena,
+        .delimiter = delimiter,
+        .quoting = quoting,
+        .chunk = cstr_literal(""),
+    };
+
+    self->fields = (cstrs)Allocator_createItems(owner, cstr, CSV_MIN_FIELDS);
+    if (self->fields.data == NULL) {
+        fprintf(stderr, "[CsvReader] error: field array allocation failed.\n");
+        return false;
+    }
+    self->carry = String_new(owner, CSV_MIN_CARRY);
+    if (self->carry.str.data == NULL) {
+        fprintf(stderr, "[CsvReader] error: carry buffer allocation failed.\n");
+        Allocator_destroyItems(owner, self->fields);
+        return false;
+    }
+    return true;
+}
+
+void CsvReader_deinit(CsvReader *const self) {
+    assert(self != NULL);
+    String_free(&self->carry);
+    Allocator_destroyItems(self->owner, self->fields);
+    *self = (CsvReader) { 0 };
+}
+
+void CsvReader_feed(CsvReader *const self, const cstr chunk, const bool last) {
+    assert(self != NULL);
+    assert(chunk.data != NULL || chunk.size == 0);
+    assert(self->position == self->chunk.size);
+
+    self->chunk = chunk;
+    self->last = last;
+    self->position = 0;
+    CsvScanner_reset(&self->scanner, 0, 0);
+    if (self->carry.str.size == 0) {
+        return;
+    }
+
+    // The record left over from the last chunk ends at the first newline
+    //  outside quotes, so only that prefix is copied to complete it.
+    self->scanner.inQuotes = self->carryQuotes;
+    bool newline = false;
+    size_t end;
+    do {
+        end = CsvScanner_next(&self->scanner, self, chunk, &newline);
+    } while (end != SIZE_MAX && !newline);
+
+    const size_t taken = (end == SIZE_MAX) ? chunk.size : end + 1;
+    if (!String_append_str(&self->carry, cstr_slice(chunk, 0, taken))) {
+        CsvReader_fail(self, "carry buffer allocation failed");
+        return;
+    }
+    self->position = taken;
+    if (end == SIZE_MAX) {
+        self->carryQuotes = self->scanner.inQuotes;
+        self->carryReady = last;
+    } else {
+        self->carryReady = true;
+        CsvScanner_reset(&self->scanner, taken, 0);
+    }
+}
+
+bool CsvReader_next(CsvReader *const self, CsvRecord *const record) {
+    assert(self != NULL);
+    assert(record != NULL);
+
+    if (self->failed) {
+        return false;
+    }
+    if (self->carryEmitted) {
+        self->carry.str.size = 0;
+        self->carryEmitted = false;
+    }
+
+    size_t count = 0;
+    if (self->carryReady) {
+        self->carryReady = false;
+        self->carryEmitted = true;
+        CsvScanner scanner = { 0 };
+        size_t position = 0;
+        if (!CsvReader_split(self, &scanner, cstr_cast(self->carry.str), &position, true, &count)) {
+            return false;
+        }
+        if (count > 0) {
+            record->fields = (cstrs)Slice_from(self->fields.data, count);
+            return true;
+        }
+        // note: it was only a blank line.
+        self->carry.str.size = 0;
+        self->carryEmitted = false;
+    }
+
+    if (!CsvReader_split(self, &self->scanner, self->chunk, &self->position, self->last, &count)) {
+        return false;
+    }
+    if (count > 0) {
+        record->fields = (cstrs)Slice_from(self->fields.data, count);
+        return true;
+    }
+
+    // note: keep the unfinished record until the next chunk completes it.
+    if (!self->last && self->position < self->chunk.size) {
+        const cstr rest = cstr_slice(self->chunk, self->position, self->chunk.size - self->position);
+        if (!String_append_str(&self->carry, rest)) {
+            return CsvReader_fail(self, "carry buffer allocation failed");
+        }
+        self->carryQuotes = self->scanner.inQuotes;
+        self->position = self->chunk.size;
+    }
+    return false;
+}
+
+cstr CsvRecord_field(const CsvRecord *const self, const size_t index) {
+    assert(self != NULL);
+    return (index < self->fields.size) ? self->fields.data[index] : cstr_literal("");
+}
+
+bool CsvRecord_tryParse_u64(const CsvRecord *const self, const size_t index, uint64_t *const val) {
+    const cstr field = CsvRecord_field(self, index);
+    return field.size > 0 && str_tryParse_u64(field, val);
+}
+
+bool CsvRecord_tryParse_i64(const CsvRecord *const self, const size_t index, int64_t *const val) {
+    const cstr field = CsvRecord_field(self, index);
+    return field.size > 0 && str_tryParse_i64(field, val);
+}
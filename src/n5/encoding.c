@@ -0,0 +1,168 @@
+#include "n5/encoding.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "n5/simd.h"
+
+static inline bool Hex_isDigit(const uint8_t c) {
+    return (uint8_t)(c - '0') < 10 || (uint8_t)((c | 0x20) - 'a') < 6;
+}
+
+static inline bool Base64_isChar(const uint8_t c, const bool url) {
+    return (uint8_t)(c - 'A') < 26 || (uint8_t)(c - 'a') < 26 || (uint8_t)(c - '0') < 10
+        || c == (url ? '-' : '+') || c == (url ? '_' : '/');
+}
+
+static DecodeResult Decode_fail(const char *const name, const cstr text, const DecodeError error, const size_t size, const size_t offset) {
+    switch (error) {
+        case decode_invalid_char:
+            fprintf(stderr, "[%s] error: invalid character 0x%02x at byte %zu.\n", name, (uint8_t)text.data[offset], offset);
+            break;
+        case decode_truncated:
+            fprintf(stderr, "[%s] error: text ends partway through a byte at byte %zu.\n", name, offset);
+            break;
+        case decode_bad_padding:
+            fprintf(stderr, "[%s] error: bad padding at byte %zu.\n", name, offset);
+            break;
+        default:
+            fprintf(stderr, "[%s] error: destination is too small.\n", name);
+            break;
+    }
+    return (DecodeResult) { .error = error, .size = size, .offset = offset };
+}
+
+// Makes room for 'size' more chars at the end of 'out'. 'bytes' is updated
+//  if it points into 'out' and the buffer moves.
+static bool Encoding_reserve(String *const out, cstr *const bytes, const size_t size) {
+    if (size > SIZE_MAX - out->str.size - 1) {
+        return false;
+    }
+
+    // edge case: 'bytes' is a substring of 'out'
+    const uintptr_t localOffset = (uintptr_t)bytes->data - (uintptr_t)out->str.data;
+    const bool local = out->str.data != NULL && localOffset <= out->str.size;
+    if (!String_grow(out, out->str.size + size)) {
+        return false;
+    }
+    if (local) {
+        bytes->data = out->str.data + localOffset;
+    }
+    return true;
+}
+
+static inline void Encoding_commit(String *const out, const size_t size) {
+    out->str.size += size;
+    out->str.data[out->str.size] = '\0';
+}
+
+bool Hex_encode(String *const out, cstr bytes, const bool upper) {
+    assert(out != NULL);
+    assert(bytes.data != NULL || bytes.size == 0);
+
+    if (bytes.size > SIZE_MAX / 2 || !Encoding_reserve(out, &bytes, Hex_encodedSize(bytes.size))) {
+        return false;
+    }
+    n5_simd->hexEncode(out->str.data + out->str.size, bytes.data, bytes.size, upper);
+    Encoding_commit(out, Hex_encodedSize(bytes.size));
+    return true;
+}
+
+DecodeResult Hex_decode(const cstr text, const Block dest) {
+    assert(text.data != NULL || text.size == 0);
+    assert(dest.data != NULL || dest.size == 0);
+
+    if (dest.size < Hex_decodedSize(text.size)) {
+        return Decode_fail("Hex_decode", text, decode_no_space, 0, 0);
+    }
+
+    const size_t pairs = text.size & ~(size_t)1;
+    const size_t decoded = n5_simd->hexDecode(dest.data, text.data, pairs);
+    if (decoded < pairs) {
+        const size_t offset = decoded + Hex_isDigit((uint8_t)text.data[decoded]);
+        return Decode_fail("Hex_decode", text, decode_invalid_char, decoded / 2, offset);
+    }
+    if (pairs < text.size) {
+        const DecodeError error = Hex_isDigit((uint8_t)text.data[pairs]) ? decode_truncated : decode_invalid_char;
+        return Decode_fail("Hex_decode", text, error, pairs / 2, pairs);
+    }
+    return (DecodeResult) { .size = pairs / 2, .offset = text.size };
+}
+
+bool Base64_encode(String *const out, cstr bytes, const Base64Alphabet alphabet) {
+    assert(out != NULL);
+    assert(bytes.data != NULL || bytes.size == 0);
+
+    const bool url = (alphabet == base64_url);
+    const size_t size = Base64_encodedSize(bytes.size, alphabet);
+    if (bytes.size > SIZE_MAX / 2 || !Encoding_reserve(out, &bytes, size)) {
+        return false;
+    }
+
+    char *const chars = out->str.data + out->str.size;
+    const size_t whole = bytes.size - bytes.size % 3;
+    n5_simd->base64Encode(chars, bytes.data, whole, url);
+
+    // The last 1 or 2 bytes go through the kernel zero-filled; the chars that
+    //  only cover the fill become padding (or are dropped).
+    const size_t rest = bytes.size - whole;
+    if (rest != 0) {
+        uint8_t group[3] = { 0 };
+        char encoded[4];
+        memcpy(group, bytes.data + whole, rest);
+        n5_simd->base64Encode(encoded, group, 3, url);
+        char *const tail = chars + whole / 3 * 4;
+        memcpy(tail, encoded, rest + 1);
+        if (!url) {
+            memset(tail + rest + 1, '=', 3 - rest);
+        }
+    }
+    Encoding_commit(out, size);
+    return true;
+}
+
+DecodeResult Base64_decode(const cstr text, const Block dest, const Base64Alphabet alphabet) {
+    assert(text.data != NULL || text.size == 0);
+    assert(dest.data != NULL || dest.size == 0);
+
+    const bool url = (alphabet == base64_url);
+    size_t size = text.size;
+    while (size > 0 && text.data[size - 1] == '=') {
+        --size;
+    }
+    const size_t padding = text.size - size;
+
+    if (dest.size < Base64_decodedSize(size)) {
+        return Decode_fail("Base64_decode", text, decode_no_space, 0, 0);
+    }
+
+    uint8_t *const bytes = dest.data;
+    const size_t whole = size & ~(size_t)3;
+    const size_t decoded = n5_simd->base64Decode(bytes, text.data, whole, url);
+    // note: this also finds bad chars in the last, partial group.
+    size_t offset = decoded;
+    while (offset < size && Base64_isChar((uint8_t)text.data[offset], url)) {
+        ++offset;
+    }
+    if (offset < size) {
+        return Decode_fail("Base64_decode", text, decode_invalid_char, decoded / 4 * 3, offset);
+    }
+
+    // The last 2 or 3 chars are decoded as a group filled out with 'A' (zero bits).
+    const size_t rest = size - whole;
+    if (rest == 1) {
+        return Decode_fail("Base64_decode", text, decode_truncated, whole / 4 * 3, whole);
+    }
+    if (padding != 0 && (padding > 2 || rest + padding != 4)) {
+        return Decode_fail("Base64_decode", text, decode_bad_padding, whole / 4 * 3, size);
+    }
+    if (rest != 0) {
+        char group[4] = { 'A', 'A', 'A', 'A' };
+        uint8_t last[3];
+        memcpy(group, text.data + whole, rest);
+        n5_simd->base64Decode(last, group, 4, url);
+        memcpy(bytes + whole / 4 * 3, last, rest - 1);
+    }
+    return (DecodeResult) { .size = Base64_decodedSize(size), .offset = text.size };
+}
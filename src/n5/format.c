@@ -3,13 +3,18 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include "n5/trace.h"
+
 bool String_format_raw(String *const self, const cstr format, const FormatArgs args) {
     assert(self != NULL);
     assert(format.data != NULL);
 
+    Trace_begin("String_format_raw");
+
     self->str.size = 0;
     if (!String_grow(self, format.size)) {
         fprintf(stderr, "[String_format] error: string allocation failed.\n");
+        Trace_end("String_format_raw");
         return false;
     }
 
@@ -118,6 +123,14 @@ bool String_format_raw(String *const self, const cstr format, const FormatArgs a
                         }
                     } break;
 
+                    case fmt_custom: {
+                        assert(arg->custom.fn != NULL);
+                        if (!arg->custom.fn(self, arg->custom.ctx)) {
+                            fprintf(stderr, "[String_format] error: failed to append custom argument.\n");
+                            goto error;
+                        }
+                    } break;
+
                     default: {
                         fprintf(stderr, "[String_format] error: unrecognised argument type.\n");
                         goto error;
@@ -144,10 +157,60 @@ bool String_format_raw(String *const self, const cstr format, const FormatArgs a
 
     self->str.data[self->str.size] = '\0';
 
+    Trace_end("String_format_raw");
     return true;
 
 error:
     self->str.size = 0;
     self->str.data[0] = '\0';
+    Trace_end("String_format_raw");
     return false;
 }
+
+bool Format_slice(String *const self, const void *const ctx) {
+    assert(ctx != NULL);
+    const FormatSlice *const slice = ctx;
+    assert(slice->item != NULL);
+
+    const size_t startSize = self->str.size;
+    const uint8_t* item = slice->data;
+    for (size_t i = 0; i < slice->size; ++i, item += slice->stride) {
+        if (i > 0 && slice->separator.size > 0 && !String_append_str(self, slice->separator)) {
+            goto error;
+        }
+        if (!slice->item(self, item)) {
+            goto error;
+        }
+    }
+
+    return true;
+
+error:
+    self->str.size = startSize;
+    self->str.data[startSize] = '\0';
+    return false;
+}
+
+bool Format_str(String *const self, const void *const item) {
+    return String_append_str(self, *(const cstr*)item);
+}
+
+bool Format_char(String *const self, const void *const item) {
+    return String_append_char(self, *(const char*)item);
+}
+
+bool Format_i64(String *const self, const void *const item) {
+    return String_append_i64(self, *(const int64_t*)item, false);
+}
+
+bool Format_u64(String *const self, const void *const item) {
+    return String_append_u64(self, *(const uint64_t*)item, false);
+}
+
+bool Format_f64(String *const self, const void *const item) {
+    return String_append_f64(self, *(const double*)item);
+}
+
+bool Format_bool(String *const self, const void *const item) {
+    return String_append_bool(self, *(const bool*)item);
+}
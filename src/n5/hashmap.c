@@ -0,0 +1,315 @@
+#include "n5/hashmap.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHMAP_SSE2 1
+#include <emmintrin.h>
+#else
+#define HASHMAP_SSE2 0
+#endif
+
+#define GROUP_WIDTH 16
+#define MIN_CAPACITY 16
+#define CTRL_EMPTY ((int8_t)-128)
+
+typedef struct Slot Slot;
+
+struct Slot {
+    uint64_t hash;
+    union {
+        uint64_t u64;
+        cstr str;
+    } key;
+};
+
+static inline Slot* HashMap_slot(const HashMap *const self, const size_t index) {
+    return (Slot*)(self->slots + index * self->slotSize);
+}
+
+static inline void* Slot_value(Slot *const slot) {
+    return slot + 1;
+}
+
+static inline int8_t HashMap_h2(const uint64_t hash) {
+    return (int8_t)(hash >> 57);
+}
+
+static inline void HashMap_setCtrl(HashMap *const self, const size_t index, const int8_t value) {
+    self->ctrl[index] = value;
+    // note: the first group is mirrored past the end so groups can be loaded unaligned.
+    if (index < GROUP_WIDTH) {
+        self->ctrl[self->capacity + index] = value;
+    }
+}
+
+static inline uint32_t Group_match(const int8_t *const ctrl, const int8_t h2) {
+#if HASHMAP_SSE2
+    const __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) {
+        mask |= (uint32_t)(ctrl[i] == h2) << i;
+    }
+    return mask;
+#endif
+}
+
+static inline uint32_t Group_matchEmpty(const int8_t *const ctrl) {
+#if HASHMAP_SSE2
+    // note: only empty control bytes have their sign bit set.
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) {
+        mask |= (uint32_t)(ctrl[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+static inline bool HashMap_keyEquals(const HashMap *const self, const Slot *const slot, const Slot *const key) {
+    if (self->keyKind == hash_key_u64) {
+        return slot->key.u64 == key->key.u64;
+    }
+    return slot->key.str.size == key->key.str.size
+        && memcmp(slot->key.str.data, key->key.str.data, key->key.str.size) == 0;
+}
+
+static size_t HashMap_find(const HashMap *const self, const Slot *const key) {
+    if (self->capacity == 0) {
+        return SIZE_MAX;
+    }
+
+    const size_t mask = self->capacity - 1;
+    const int8_t h2 = HashMap_h2(key->hash);
+    size_t pos = key->hash & mask;
+    for (;;) {
+        const int8_t *const group = self->ctrl + pos;
+        for (uint32_t match = Group_match(group, h2); match != 0; match &= match - 1) {
+            const size_t index = (pos + n5_ctz32(match)) & mask;
+            const Slot *const slot = HashMap_slot(self, index);
+            if (slot->hash == key->hash && HashMap_keyEquals(self, slot, key)) {
+                return index;
+            }
+        }
+
+        if (Group_matchEmpty(group) != 0) {
+            return SIZE_MAX;
+        }
+        pos = (pos + GROUP_WIDTH) & mask;
+    }
+}
+
+static size_t HashMap_findEmpty(const HashMap *const self, const uint64_t hash) {
+    const size_t mask = self->capacity - 1;
+    size_t pos = hash & mask;
+    for (;;) {
+        const uint32_t empty = Group_matchEmpty(self->ctrl + pos);
+        if (empty != 0) {
+            return (pos + n5_ctz32(empty)) & mask;
+        }
+        pos = (pos + GROUP_WIDTH) & mask;
+    }
+}
+
+static bool HashMap_rehash(HashMap *const self, const size_t capacity) {
+    assert(capacity >= MIN_CAPACITY);
+    assert((capacity & (capacity - 1)) == 0);
+
+    const size_t slotsSize = capacity * self->slotSize;
+    const size_t ctrlSize = capacity + GROUP_WIDTH;
+    const size_t words = (slotsSize + ctrlSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    Block memory = Allocator_alloc(self->owner, uint64_t, words);
+    if (memory.data == NULL) {
+        return false;
+    }
+
+    HashMap old = *self;
+    self->memory = memory;
+    self->slots = memory.data;
+    self->ctrl = (int8_t*)(self->slots + slotsSize);
+    self->capacity = capacity;
+    self->growthLeft = (capacity / 8) * 7 - old.size;
+    memset(self->ctrl, CTRL_EMPTY, ctrlSize);
+
+    for (size_t i = 0; i < old.capacity; ++i) {
+        if (old.ctrl[i] >= 0) {
+            const Slot *const slot = HashMap_slot(&old, i);
+            const size_t index = HashMap_findEmpty(self, slot->hash);
+            HashMap_setCtrl(self, index, old.ctrl[i]);
+            memcpy(HashMap_slot(self, index), slot, self->slotSize);
+        }
+    }
+
+    if (old.memory.data != NULL) {
+        Allocator_free(self->owner, old.memory);
+    }
+
+    return true;
+}
+
+static void* HashMap_insertKey(HashMap *const self, Slot key) {
+    const size_t existing = HashMap_find(self, &key);
+    if (existing != SIZE_MAX) {
+        return Slot_value(HashMap_slot(self, existing));
+    }
+
+    if (self->growthLeft == 0 && !HashMap_rehash(self, n5_max(self->capacity * 2, MIN_CAPACITY))) {
+        return NULL;
+    }
+
+    if (self->keyKind == hash_key_cstr && key.key.str.size > 0) {
+        Block copy = Allocator_alloc(self->owner, char, key.key.str.size);
+        if (copy.data == NULL) {
+            return NULL;
+        }
+        memcpy(copy.data, key.key.str.data, key.key.str.size);
+        key.key.str.data = copy.data;
+    }
+
+    const size_t index = HashMap_findEmpty(self, key.hash);
+    HashMap_setCtrl(self, index, HashMap_h2(key.hash));
+
+    Slot *const slot = HashMap_slot(self, index);
+    *slot = key;
+    memset(Slot_value(slot), 0, self->valueSize);
+
+    ++self->size;
+    --self->growthLeft;
+
+    return Slot_value(slot);
+}
+
+static void HashMap_freeKey(HashMap *const self, Slot *const slot) {
+    if (self->keyKind == hash_key_cstr && slot->key.str.size > 0) {
+        Allocator_free(self->owner, ((Block) {
+            .data = (void*)slot->key.str.data,
+            .size = slot->key.str.size,
+        }));
+    }
+}
+
+static bool HashMap_removeKey(HashMap *const self, const Slot *const key) {
+    size_t hole = HashMap_find(self, key);
+    if (hole == SIZE_MAX) {
+        return false;
+    }
+
+    HashMap_freeKey(self, HashMap_slot(self, hole));
+
+    // backward-shift deletion: pull later entries of the probe run into the hole
+    //  whenever the hole lies between their home slot and their current slot.
+    const size_t mask = self->capacity - 1;
+    for (size_t next = (hole + 1) & mask; self->ctrl[next] >= 0; next = (next + 1) & mask) {
+        Slot *const slot = HashMap_slot(self, next);
+        const size_t home = slot->hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            HashMap_setCtrl(self, hole, self->ctrl[next]);
+            memcpy(HashMap_slot(self, hole), slot, self->slotSize);
+            hole = next;
+        }
+    }
+
+    HashMap_setCtrl(self, hole, CTRL_EMPTY);
+    --self->size;
+    ++self->growthLeft;
+
+    return true;
+}
+
+void HashMap_init(HashMap *const self, Allocator *const owner, const HashKey keyKind, const size_t valueSize) {
+    assert(self != NULL);
+    assert(owner != NULL);
+
+    *self = (HashMap) {
+        .owner = owner,
+        .keyKind = keyKind,
+        .valueSize = valueSize,
+        .slotSize = n5_alignSize(sizeof(Slot) + valueSize, alignof(Slot)),
+    };
+}
+
+void HashMap_deinit(HashMap *const self) {
+    assert(self != NULL);
+
+    HashMap_clear(self);
+    if (self->memory.data != NULL) {
+        Allocator_free(self->owner, self->memory);
+    }
+    *self = (HashMap) { 0 };
+}
+
+void HashMap_clear(HashMap *const self) {
+    assert(self != NULL);
+
+    if (self->capacity == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < self->capacity; ++i) {
+        if (self->ctrl[i] >= 0) {
+            HashMap_freeKey(self, HashMap_slot(self, i));
+        }
+    }
+
+    memset(self->ctrl, CTRL_EMPTY, self->capacity + GROUP_WIDTH);
+    self->size = 0;
+    self->growthLeft = (self->capacity / 8) * 7;
+}
+
+bool HashMap_reserve(HashMap *const self, const size_t count) {
+    assert(self != NULL);
+
+    if (count <= self->size + self->growthLeft) {
+        return true;
+    }
+
+    const size_t capacity = n5_nextPow2(n5_max((count * 8 + 6) / 7, MIN_CAPACITY));
+    return HashMap_rehash(self, capacity);
+}
+
+void* HashMap_get_u64(const HashMap *const self, const uint64_t key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_u64);
+
+    const size_t index = HashMap_find(self, &(Slot) { .hash = n5_hash_u64(key), .key.u64 = key });
+    return (index != SIZE_MAX) ? Slot_value(HashMap_slot(self, index)) : NULL;
+}
+
+void* HashMap_get_cstr(const HashMap *const self, const cstr key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_cstr);
+
+    const size_t index = HashMap_find(self, &(Slot) { .hash = cstr_hash(key), .key.str = key });
+    return (index != SIZE_MAX) ? Slot_value(HashMap_slot(self, index)) : NULL;
+}
+
+void* HashMap_insert_u64(HashMap *const self, const uint64_t key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_u64);
+    return HashMap_insertKey(self, (Slot) { .hash = n5_hash_u64(key), .key.u64 = key });
+}
+
+void* HashMap_insert_cstr(HashMap *const self, const cstr key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_cstr);
+    return HashMap_insertKey(self, (Slot) { .hash = cstr_hash(key), .key.str = key });
+}
+
+bool HashMap_remove_u64(HashMap *const self, const uint64_t key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_u64);
+    return HashMap_removeKey(self, &(Slot) { .hash = n5_hash_u64(key), .key.u64 = key });
+}
+
+bool HashMap_remove_cstr(HashMap *const self, const cstr key) {
+    assert(self != NULL);
+    assert(self->keyKind == hash_key_cstr);
+    return HashMap_removeKey(self, &(Slot) { .hash = cstr_hash(key), .key.str = key });
+}
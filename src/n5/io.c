@@ -0,0 +1,217 @@
+#include "n5/io.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "n5/utils.h"
+
+#define MIN_BUFFER_SIZE 64
+
+cstr n5_file_map(const char *const path, const int advice) {
+    assert(path != NULL);
+
+    cstr view = { 0 };
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        (advice & file_advice_sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "[n5_file_map] error: failed to open '%s'.\n", path);
+        return view;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        fprintf(stderr, "[n5_file_map] error: failed to stat '%s'.\n", path);
+        CloseHandle(file);
+        return view;
+    }
+
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return cstr_literal("");
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        fprintf(stderr, "[n5_file_map] error: failed to map '%s'.\n", path);
+        return view;
+    }
+
+    const void *const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) {
+        fprintf(stderr, "[n5_file_map] error: failed to map '%s'.\n", path);
+        return view;
+    }
+
+    (void)advice;
+    view = (cstr)Slice_from(data, (size_t)size.QuadPart);
+#else
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[n5_file_map] error: failed to open '%s'.\n", path);
+        return view;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        fprintf(stderr, "[n5_file_map] error: failed to stat '%s'.\n", path);
+        close(fd);
+        return view;
+    }
+
+    // note: mmap rejects empty mappings, so empty files get an empty (non-NULL) view.
+    if (info.st_size == 0) {
+        close(fd);
+        return cstr_literal("");
+    }
+
+    void *const data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "[n5_file_map] error: failed to map '%s'.\n", path);
+        return view;
+    }
+
+    if (advice & file_advice_sequential) {
+        madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+    }
+    if (advice & file_advice_willneed) {
+        madvise(data, (size_t)info.st_size, MADV_WILLNEED);
+    }
+
+    view = (cstr)Slice_from(data, (size_t)info.st_size);
+#endif
+
+    return view;
+}
+
+void n5_file_unmap(const cstr view) {
+    if (view.data == NULL || view.size == 0) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(view.data);
+#else
+    munmap((void*)view.data, view.size);
+#endif
+}
+
+bool LineReader_init(
+    LineReader *const self,
+    Allocator *const owner,
+    FILE *const file,
+    const size_t bufferSize,
+    const char delimiter
+) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(file != NULL);
+
+    Block buffer = Allocator_alloc(owner, char, n5_max(bufferSize, MIN_BUFFER_SIZE));
+    if (buffer.data == NULL) {
+        fprintf(stderr, "[LineReader] error: buffer allocation failed.\n");
+        return false;
+    }
+
+    *self = (LineReader) {
+        .owner = owner,
+        .file = file,
+        .buffer = buffer,
+        .delimiter = delimiter,
+    };
+    return true;
+}
+
+void LineReader_deinit(LineReader *const self) {
+    assert(self != NULL);
+    Allocator_free(self->owner, self->buffer);
+    *self = (LineReader) { 0 };
+}
+
+// Moves the partial record to the front of the buffer (growing it if the record
+//  already fills it) and reads more input after it.
+static bool LineReader_refill(LineReader *const self) {
+    char* data = self->buffer.data;
+    const size_t pending = self->end - self->start;
+
+    if (self->start > 0) {
+        memmove(data, data + self->start, pending);
+        self->start = 0;
+        self->end = pending;
+    }
+
+    if (pending == self->buffer.size) {
+        const size_t size = self->buffer.size * 2;
+        if (Allocator_resize(self->owner, self->buffer, char, size)) {
+            self->buffer.size = size;
+        } else {
+            Block buffer = Allocator_alloc(self->owner, char, size);
+            if (buffer.data == NULL) {
+                fprintf(stderr, "[LineReader] error: buffer allocation failed.\n");
+                return false;
+            }
+            memcpy(buffer.data, data, pending);
+            Allocator_free(self->owner, self->buffer);
+            self->buffer = buffer;
+        }
+        data = self->buffer.data;
+    }
+
+    const size_t read = fread(data + self->end, 1, self->buffer.size - self->end, self->file);
+    self->end += read;
+    if (read == 0) {
+        self->eof = true;
+        if (ferror(self->file)) {
+            fprintf(stderr, "[LineReader] error: read failed.\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LineReader_next(LineReader *const self, cstr *const record) {
+    assert(self != NULL);
+    assert(record != NULL);
+
+    // note: only the bytes that haven't been searched yet are scanned after a refill.
+    size_t searched = 0;
+    for (;;) {
+        const char *const data = self->buffer.data;
+        const cstr pending = Slice_from(data + self->start + searched, self->end - self->start - searched);
+        const size_t found = cstr_findChar(pending, self->delimiter);
+        if (found < pending.size) {
+            const size_t size = searched + found;
+            *record = (cstr)Slice_from(data + self->start, size);
+            self->start += size + 1;
+            return true;
+        }
+        searched += pending.size;
+
+        if (self->eof) {
+            if (self->start == self->end) {
+                return false;
+            }
+            *record = (cstr)Slice_from(data + self->start, self->end - self->start);
+            self->start = self->end;
+            return true;
+        }
+
+        if (!LineReader_refill(self)) {
+            return false;
+        }
+    }
+}
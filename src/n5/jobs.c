@@ -0,0 +1,403 @@
+#include "n5/jobs.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+#define DEQUE_CAPACITY 4096
+#define MAX_CHUNKS 256
+#define CHUNKS_PER_WORKER 4
+#define SPIN_COUNT 64
+
+static _Thread_local JobWorker* currentWorker = NULL;
+
+static bool JobDeque_init(JobDeque *const self, Allocator *const owner) {
+    Block buffer = Allocator_alloc(owner, _Atomic(Job*), DEQUE_CAPACITY);
+    if (buffer.data == NULL) {
+        return false;
+    }
+
+    atomic_init(&self->top, 0);
+    atomic_init(&self->bottom, 0);
+    self->buffer = buffer.data;
+    self->mask = DEQUE_CAPACITY - 1;
+    return true;
+}
+
+static void JobDeque_deinit(JobDeque *const self, Allocator *const owner) {
+    if (self->buffer != NULL) {
+        Allocator_free(owner, ((Block) {
+            .data = self->buffer,
+            .size = DEQUE_CAPACITY * sizeof(self->buffer[0]),
+        }));
+        self->buffer = NULL;
+    }
+}
+
+static bool JobDeque_push(JobDeque *const self, Job *const job) {
+    const int64_t bottom = atomic_load_explicit(&self->bottom, memory_order_relaxed);
+    const int64_t top = atomic_load_explicit(&self->top, memory_order_acquire);
+    if (bottom - top > self->mask) {
+        return false;
+    }
+
+    atomic_store_explicit(&self->buffer[bottom & self->mask], job, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+static Job* JobDeque_pop(JobDeque *const self) {
+    const int64_t bottom = atomic_load_explicit(&self->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&self->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&self->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    Job* job = atomic_load_explicit(&self->buffer[bottom & self->mask], memory_order_relaxed);
+    if (top == bottom) {
+        // last item: race any thieves for it.
+        if (!atomic_compare_exchange_strong_explicit(
+            &self->top, &top, top + 1,
+            memory_order_seq_cst, memory_order_relaxed
+        )) {
+            job = NULL;
+        }
+        atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static Job* JobDeque_steal(JobDeque *const self) {
+    int64_t top = atomic_load_explicit(&self->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t bottom = atomic_load_explicit(&self->bottom, memory_order_acquire);
+
+    if (top >= bottom) {
+        return NULL;
+    }
+
+    Job *const job = atomic_load_explicit(&self->buffer[top & self->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(
+        &self->top, &top, top + 1,
+        memory_order_seq_cst, memory_order_relaxed
+    )) {
+        return NULL;
+    }
+    return job;
+}
+
+static Job* JobWorker_take(JobWorker *const self) {
+    Job* job = JobDeque_pop(&self->deque);
+    if (job == NULL) {
+        JobSystem *const system = self->system;
+        const size_t count = system->workers.size;
+
+        // xorshift to pick a victim, so thieves don't all converge on one worker.
+        self->rng ^= self->rng << 13;
+        self->rng ^= self->rng >> 7;
+        self->rng ^= self->rng << 17;
+
+        const size_t start = self->rng % count;
+        for (size_t i = 0; i < count && job == NULL; ++i) {
+            const size_t victim = (start + i) % count;
+            if (victim != self->index) {
+                job = JobDeque_steal(&system->workers.data[victim].deque);
+            }
+        }
+    }
+
+    if (job != NULL) {
+        atomic_fetch_sub_explicit(&self->system->queued, 1, memory_order_relaxed);
+    }
+    return job;
+}
+
+static void JobWorker_run(JobWorker *const self, Job *const job) {
+    job->fn(self, job->ctx, job->begin, job->end);
+
+    // note: a waiter may be blocked in JobSystem_wait, so the last job in a group
+    //  wakes the sleepers (the group itself may be gone once 'pending' hits 0).
+    JobSystem *const system = self->system;
+    if (job->group != NULL
+        && atomic_fetch_sub(&job->group->pending, 1) == 1
+        && atomic_load(&system->sleeping) > 0) {
+        mtx_lock(&system->lock);
+        cnd_broadcast(&system->wake);
+        mtx_unlock(&system->lock);
+    }
+}
+
+static int JobWorker_loop(void *const arg) {
+    JobWorker *const self = arg;
+    JobSystem *const system = self->system;
+    currentWorker = self;
+
+    size_t idle = 0;
+    while (atomic_load_explicit(&system->running, memory_order_acquire)) {
+        Job *const job = JobWorker_take(self);
+        if (job != NULL) {
+            JobWorker_run(self, job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SPIN_COUNT) {
+            thrd_yield();
+            continue;
+        }
+
+        // note: 'sleeping' is raised before 'queued' is checked (and vice versa in
+        //  JobSystem_submit), so a wakeup can't be missed.
+        mtx_lock(&system->lock);
+        atomic_fetch_add(&system->sleeping, 1);
+        if (atomic_load(&system->queued) == 0 && atomic_load(&system->running)) {
+            cnd_wait(&system->wake, &system->lock);
+        }
+        atomic_fetch_sub(&system->sleeping, 1);
+        mtx_unlock(&system->lock);
+        idle = 0;
+    }
+
+    currentWorker = NULL;
+    return 0;
+}
+
+// Stops the first 'started' workers (worker 0 has no thread) and frees the first 'ready'.
+static void JobSystem_release(JobSystem *const self, const size_t ready, const size_t started) {
+    mtx_lock(&self->lock);
+    atomic_store(&self->running, false);
+    cnd_broadcast(&self->wake);
+    mtx_unlock(&self->lock);
+
+    for (size_t i = 1; i < started; ++i) {
+        thrd_join(self->workers.data[i].thread, NULL);
+    }
+
+    for (size_t i = 0; i < ready; ++i) {
+        JobWorker *const worker = &self->workers.data[i];
+        Arena_deinit(&worker->arena);
+        JobDeque_deinit(&worker->deque, self->owner);
+    }
+
+    if (currentWorker != NULL && currentWorker->system == self) {
+        currentWorker = NULL;
+    }
+
+    cnd_destroy(&self->wake);
+    mtx_destroy(&self->lock);
+    Allocator_destroyItems(self->owner, self->workers);
+    *self = (JobSystem) { 0 };
+}
+
+bool JobSystem_init(
+    JobSystem *const self,
+    Allocator *const owner,
+    const size_t threadCount,
+    const size_t arenaSize
+) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(currentWorker == NULL);
+
+    const size_t workerCount = n5_max(threadCount, 1);
+    *self = (JobSystem) {
+        .owner = owner,
+        .workers = Allocator_createItems(owner, JobWorker, workerCount),
+    };
+    if (self->workers.data == NULL) {
+        fprintf(stderr, "[JobSystem] error: worker allocation failed.\n");
+        return false;
+    }
+
+    atomic_init(&self->queued, 0);
+    atomic_init(&self->sleeping, 0);
+    atomic_init(&self->running, true);
+    // note: JobSystem_release needs both, so a failure here unwinds by hand.
+    const bool lockReady = mtx_init(&self->lock, mtx_plain) == thrd_success;
+    const bool wakeReady = cnd_init(&self->wake) == thrd_success;
+    if (!lockReady || !wakeReady) {
+        fprintf(stderr, "[JobSystem] error: failed to initialise the wait lock.\n");
+        if (wakeReady) {
+            cnd_destroy(&self->wake);
+        }
+        if (lockReady) {
+            mtx_destroy(&self->lock);
+        }
+        Allocator_destroyItems(owner, self->workers);
+        *self = (JobSystem) { 0 };
+        return false;
+    }
+
+    size_t ready = 0;
+    for (; ready < workerCount; ++ready) {
+        JobWorker *const worker = &self->workers.data[ready];
+        *worker = (JobWorker) {
+            .system = self,
+            .index = ready,
+            .rng = n5_hash_u64(ready + 1),
+        };
+
+        if (!JobDeque_init(&worker->deque, owner)) {
+            break;
+        }
+        if (!Arena_init(&worker->arena, owner, arenaSize)) {
+            JobDeque_deinit(&worker->deque, owner);
+            break;
+        }
+    }
+
+    size_t started = 1;
+    if (ready == workerCount) {
+        for (; started < workerCount; ++started) {
+            JobWorker *const worker = &self->workers.data[started];
+            if (thrd_create(&worker->thread, JobWorker_loop, worker) != thrd_success) {
+                break;
+            }
+        }
+    }
+
+    if (ready < workerCount || started < workerCount) {
+        fprintf(stderr, "[JobSystem] error: failed to initialise workers.\n");
+        JobSystem_release(self, ready, started);
+        return false;
+    }
+
+    currentWorker = &self->workers.data[0];
+    return true;
+}
+
+void JobSystem_deinit(JobSystem *const self) {
+    assert(self != NULL);
+    JobSystem_release(self, self->workers.size, self->workers.size);
+}
+
+JobWorker* JobSystem_currentWorker(const JobSystem *const self) {
+    assert(self != NULL);
+    return (currentWorker != NULL && currentWorker->system == self) ? currentWorker : NULL;
+}
+
+void JobSystem_submit(JobSystem *const self, Job *const job, WaitGroup *const group) {
+    assert(self != NULL);
+    assert(job != NULL);
+    assert(job->fn != NULL);
+
+    JobWorker *const worker = JobSystem_currentWorker(self);
+    assert(worker != NULL);
+
+    job->group = group;
+    if (group != NULL) {
+        atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    }
+
+    atomic_fetch_add(&self->queued, 1);
+    if (!JobDeque_push(&worker->deque, job)) {
+        // the deque is full, so just run it now.
+        atomic_fetch_sub(&self->queued, 1);
+        JobWorker_run(worker, job);
+        return;
+    }
+
+    if (atomic_load(&self->sleeping) > 0) {
+        mtx_lock(&self->lock);
+        cnd_signal(&self->wake);
+        mtx_unlock(&self->lock);
+    }
+}
+
+void JobSystem_wait(JobSystem *const self, WaitGroup *const group) {
+    assert(self != NULL);
+    assert(group != NULL);
+
+    JobWorker *const worker = JobSystem_currentWorker(self);
+    assert(worker != NULL);
+
+    // Back off in steps while there's nothing to steal: pause a growing number
+    //  of times, then yield, then sleep like an idle worker until a job is
+    //  queued or the group finishes.
+    size_t idle = 0;
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        Job *const job = JobWorker_take(worker);
+        if (job != NULL) {
+            JobWorker_run(worker, job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < SPIN_COUNT) {
+            for (size_t i = 0; i < idle; ++i) {
+                n5_cpuRelax();
+            }
+            continue;
+        }
+        if (idle < SPIN_COUNT * 2) {
+            thrd_yield();
+            continue;
+        }
+
+        // note: pairs with JobWorker_run: either it sees 'sleeping' raised, or
+        //  this sees 'pending' at 0.
+        mtx_lock(&self->lock);
+        atomic_fetch_add(&self->sleeping, 1);
+        if (atomic_load(&self->queued) == 0 && atomic_load(&group->pending) > 0) {
+            cnd_wait(&self->wake, &self->lock);
+        }
+        atomic_fetch_sub(&self->sleeping, 1);
+        mtx_unlock(&self->lock);
+        idle = 0;
+    }
+}
+
+void JobSystem_parallelFor(
+    JobSystem *const self,
+    const size_t count,
+    const size_t grain,
+    const JobFn fn,
+    void *const ctx
+) {
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    if (count == 0) {
+        return;
+    }
+
+    JobWorker *const worker = JobSystem_currentWorker(self);
+    assert(worker != NULL);
+
+    // enough chunks to balance load across workers, but none smaller than 'grain'.
+    size_t chunkCount = n5_min(self->workers.size * CHUNKS_PER_WORKER, MAX_CHUNKS);
+    chunkCount = n5_min(chunkCount, (count + n5_max(grain, 1) - 1) / n5_max(grain, 1));
+    if (chunkCount <= 1) {
+        fn(worker, ctx, 0, count);
+        return;
+    }
+
+    Job jobs[MAX_CHUNKS];
+    WaitGroup group;
+    WaitGroup_init(&group);
+
+    // note: chunk 0 runs on this thread, so only the rest are queued.
+    for (size_t i = 1; i < chunkCount; ++i) {
+        jobs[i] = (Job) {
+            .fn = fn,
+            .ctx = ctx,
+            .begin = (count * i) / chunkCount,
+            .end = (count * (i + 1)) / chunkCount,
+        };
+        JobSystem_submit(self, &jobs[i], &group);
+    }
+
+    fn(worker, ctx, 0, count / chunkCount);
+    JobSystem_wait(self, &group);
+}
+
+void JobSystem_resetArenas(JobSystem *const self) {
+    assert(self != NULL);
+    for (size_t i = 0; i < self->workers.size; ++i) {
+        Arena_reset(&self->workers.data[i].arena);
+    }
+}
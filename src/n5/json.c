@@ -0,0 +1,956 @@
+#include "n5/json.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "n5/simd.h"
+#include "n5/utils.h"
+
+typedef struct JsonParser {
+    const char* data;
+    size_t size;
+    Arena* arena;
+    JsonNode* nodes;
+    size_t nodeCount;
+    char* strings;
+    size_t stringsSize;
+    // note: the backslash offsets (ascending, then UINT32_MAX) from the first one not yet passed.
+    const uint32_t* backslashes;
+} JsonParser;
+
+// Bitmask state carried from one 64-byte block to the next.
+typedef struct JsonScanner {
+    uint64_t escaped;
+    uint64_t inString;
+    uint64_t scalar;
+} JsonScanner;
+
+// Stage 1's byte classes as nibble tables (see SimdKernels.classifyBlock). The
+//  bits are ',' 0x01, ':' 0x02, '[]{}' 0x04, ' ' 0x08, '\t\n\r' 0x10, '"' 0x20
+//  and '\\' 0x40; each is a set of low nibbles paired with a set of high ones.
+static const uint8_t JsonClassTables[32] = {
+    // low nibble: 0 ' ', 2 '"', 9 '\t', a ':' '\n', b '[' '{', c ',' '\\', d ']' '}' '\r'
+    0x08, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x12, 0x04, 0x41, 0x14, 0x00, 0x00,
+    // high nibble: 0 controls, 2 ' ' '"' ',', 3 ':', 5 '[' ']' '\\', 7 '{' '}'
+    0x10, 0x00, 0x29, 0x02, 0x00, 0x44, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// note: the masks stage 1 asks for, in this order.
+static const uint8_t JsonClasses[] = {
+    0x07, // operators
+    0x18, // whitespace
+    0x20, // quotes
+    0x40, // backslashes
+};
+
+static const double JsonPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static inline bool Json_isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Bytes that may directly follow a number or literal.
+static inline bool Json_isDelimiter(const char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r':
+        case ',': case ']': case '}': case ':':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// note: little-endian order, so the first byte is the low byte.
+static inline uint64_t Json_load64(const char *const data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Counts the leading ASCII digits of a little-endian word (up to 8).
+static inline size_t Json_countDigits(const uint64_t word) {
+    // note: bytes past the first non-digit can be misflagged; they're never looked at.
+    const uint64_t nonDigits = ((word & 0xf0f0f0f0f0f0f0f0ull) ^ 0x3030303030303030ull)
+        | (((word + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) ^ 0x3030303030303030ull);
+    const uint64_t flags = (((nonDigits & 0x7f7f7f7f7f7f7f7full) + 0x7f7f7f7f7f7f7f7full) | nonDigits)
+        & 0x8080808080808080ull;
+    return (flags == 0) ? 8 : n5_ctz64(flags) / 8;
+}
+
+// Converts eight ASCII digits (first digit in the low byte) with three multiplies.
+static inline uint64_t Json_parseEightDigits(uint64_t word) {
+    word -= 0x3030303030303030ull;
+    word = (word * 10) + (word >> 8);
+    return (((word & 0x000000ff000000ffull) * (100 + (1000000ull << 32)))
+        + (((word >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >> 32;
+}
+
+// Appends a run of digits to 'mantissa' and returns its length. Up to eight
+//  digits are converted at once: a short run is shifted to the top of the
+//  word and zero-padded below, so it needs neither a loop nor a branch per digit.
+//  note: 'mantissa' wraps on long runs; callers fall back when there are more than 19 digits.
+static inline size_t Json_parseDigits(const char *const data, const size_t size, uint64_t *const mantissa) {
+    static const uint64_t scales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+    size_t i = 0;
+    while (i + 8 <= size) {
+        uint64_t word = Json_load64(data + i);
+        const size_t digits = Json_countDigits(word);
+        if (digits == 0) {
+            return i;
+        }
+        if (digits < 8) {
+            word = (word << (64 - digits * 8)) | (0x3030303030303030ull >> (digits * 8));
+        }
+        *mantissa = *mantissa * scales[digits] + Json_parseEightDigits(word);
+        i += digits;
+        if (digits < 8) {
+            return i;
+        }
+    }
+    for (; i < size && Json_isDigit(data[i]); ++i) {
+        *mantissa = *mantissa * 10 + (uint64_t)(data[i] - '0');
+    }
+    return i;
+}
+
+// Marks the bytes preceded by an odd run of backslashes. Backslashes are rare
+//  outside of escaped text, so they're walked one run at a time.
+static inline uint64_t JsonScanner_escapes(JsonScanner *const self, uint64_t backslash) {
+    uint64_t escaped = self->escaped;
+    backslash &= ~escaped;
+    self->escaped = 0;
+    while (backslash != 0) {
+        const uint64_t bit = backslash & (0 - backslash);
+        if (bit == (1ull << 63)) {
+            self->escaped = 1;
+        }
+        escaped |= bit << 1;
+        backslash &= ~(bit | (bit << 1));
+    }
+    return escaped;
+}
+
+// Stage 1: records the offset of every structural character outside strings
+//  ({}[]:, and quotes that open strings) plus the first byte of every number
+//  or literal. Returns the number of indices, or SIZE_MAX if a string is left open.
+//  The offsets of backslashes inside strings are written downwards from
+//  indices[size + 1], so stage 2 can tell whether a string needs unescaping
+//  without reading it; no byte is both, so the two never meet.
+static size_t Json_index(const char *const data, const size_t size, uint32_t *const indices, size_t *const backslashCount) {
+    JsonScanner scanner = { 0 };
+    uint64_t masks[n5_arraySize(JsonClasses)];
+    char tail[64];
+    size_t count = 0;
+    uint32_t* backslashes = indices + size + 1;
+
+    for (size_t offset = 0; offset < size; offset += 64) {
+        const char* block = data + offset;
+        if (size - offset < 64) {
+            // note: padding with whitespace keeps the tail from adding structurals.
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, size - offset);
+            block = tail;
+        }
+        n5_simd->classifyBlock(block, JsonClassTables, JsonClasses, n5_arraySize(JsonClasses), masks);
+
+        const uint64_t operators = masks[0];
+        const uint64_t whitespace = masks[1];
+        const uint64_t quotes = masks[2] & ~JsonScanner_escapes(&scanner, masks[3]);
+
+        const uint64_t inString = n5_prefixXor64(quotes) ^ scanner.inString;
+        scanner.inString = (uint64_t)((int64_t)inString >> 63);
+        // note: the string bodies and their closing quotes, but not the opening quotes.
+        const uint64_t stringTail = inString ^ quotes;
+
+        const uint64_t scalar = ~(operators | whitespace);
+        const uint64_t bareScalar = scalar & ~quotes;
+        const uint64_t followsScalar = (bareScalar << 1) | scanner.scalar;
+        scanner.scalar = bareScalar >> 63;
+
+        uint64_t structurals = (operators | (scalar & ~followsScalar)) & ~stringTail;
+        while (structurals != 0) {
+            indices[count++] = (uint32_t)(offset + n5_ctz64(structurals));
+            structurals &= structurals - 1;
+        }
+        // note: only backslashes inside strings, which are never structurals.
+        for (uint64_t backslash = masks[3] & stringTail; backslash != 0; backslash &= backslash - 1) {
+            *backslashes-- = (uint32_t)(offset + n5_ctz64(backslash));
+        }
+    }
+
+    *backslashCount = (size_t)(indices + size + 1 - backslashes);
+    return (scanner.inString != 0) ? SIZE_MAX : count;
+}
+
+static bool Json_fail(const size_t position, const char *const message) {
+    fprintf(stderr, "[JsonDoc_parse] error: %s at byte %zu.\n", message, position);
+    return false;
+}
+
+// Starts the node at 'index' on the tape; a leaf's subtree ends right after it.
+static inline JsonNode* Json_node(JsonNode *const nodes, const size_t index, const JsonType type) {
+    JsonNode *const node = &nodes[index];
+    node->type = (uint8_t)type;
+    node->unescaped = false;
+    node->next = (uint32_t)(index + 1);
+    return node;
+}
+
+static inline size_t Json_hex4(const char *const data) {
+    size_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        const char c = data[i];
+        size_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (size_t)(c - '0');
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            digit = (size_t)((c | 0x20) - 'a' + 10);
+        } else {
+            return SIZE_MAX;
+        }
+        value = (value << 4) | digit;
+    }
+    return value;
+}
+
+static inline char* Json_encodeUtf8(char* out, const size_t codepoint) {
+    if (codepoint < 0x80) {
+        *out++ = (char)codepoint;
+    } else if (codepoint < 0x800) {
+        *out++ = (char)(0xc0 | (codepoint >> 6));
+        *out++ = (char)(0x80 | (codepoint & 0x3f));
+    } else if (codepoint < 0x10000) {
+        *out++ = (char)(0xe0 | (codepoint >> 12));
+        *out++ = (char)(0x80 | ((codepoint >> 6) & 0x3f));
+        *out++ = (char)(0x80 | (codepoint & 0x3f));
+    } else {
+        *out++ = (char)(0xf0 | (codepoint >> 18));
+        *out++ = (char)(0x80 | ((codepoint >> 12) & 0x3f));
+        *out++ = (char)(0x80 | ((codepoint >> 6) & 0x3f));
+        *out++ = (char)(0x80 | (codepoint & 0x3f));
+    }
+    return out;
+}
+
+// Copies the string starting at 'start' into the string buffer with its
+//  escapes resolved. An escape never decodes to more bytes than it spans, so
+//  the buffer is sized to the input once, on first use.
+static bool JsonParser_unescape(JsonParser *const self, const size_t start, JsonNode *const node) {
+    if (self->strings == NULL) {
+        self->strings = Allocator_alloc(&self->arena->base, char, self->size).data;
+        if (self->strings == NULL) {
+            return Json_fail(start, "out of arena memory for strings");
+        }
+    }
+
+    const char *const data = self->data;
+    char *const begin = self->strings + self->stringsSize;
+    char* out = begin;
+    size_t i = start;
+    for (;;) {
+        // note: copy the run up to the next quote or backslash in one go.
+        size_t run = i;
+        while (run < self->size && data[run] != '"' && data[run] != '\\') {
+            ++run;
+        }
+        memcpy(out, data + i, run - i);
+        out += run - i;
+        i = run;
+
+        if (i >= self->size) {
+            return Json_fail(start - 1, "unterminated string");
+        }
+        if (data[i] == '"') {
+            break;
+        }
+        if (i + 1 >= self->size) {
+            return Json_fail(start - 1, "unterminated string");
+        }
+
+        const char escape = data[i + 1];
+        i += 2;
+        switch (escape) {
+            case '"': *out++ = '"'; break;
+            case '\\': *out++ = '\\'; break;
+            case '/': *out++ = '/'; break;
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u': {
+                size_t codepoint = (i + 4 <= self->size) ? Json_hex4(data + i) : SIZE_MAX;
+                if (codepoint == SIZE_MAX) {
+                    return Json_fail(i - 2, "invalid \\u escape");
+                }
+                i += 4;
+                if (codepoint >= 0xdc00 && codepoint <= 0xdfff) {
+                    return Json_fail(i - 6, "unpaired low surrogate");
+                }
+                if (codepoint >= 0xd800 && codepoint <= 0xdbff) {
+                    const size_t low = (i + 6 <= self->size && data[i] == '\\' && data[i + 1] == 'u')
+                        ? Json_hex4(data + i + 2)
+                        : SIZE_MAX;
+                    if (low < 0xdc00 || low > 0xdfff) {
+                        return Json_fail(i - 6, "unpaired high surrogate");
+                    }
+                    i += 6;
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                }
+                out = Json_encodeUtf8(out, codepoint);
+                break;
+            }
+            default:
+                return Json_fail(i - 2, "invalid escape");
+        }
+    }
+
+    node->unescaped = true;
+    node->string.offset = (uint32_t)(begin - self->strings);
+    node->string.size = (uint32_t)(out - begin);
+    self->stringsSize += node->string.size;
+    return true;
+}
+
+static inline bool Json_isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Parses the string whose opening quote is at 'position'. Only whitespace can
+//  sit between its closing quote and 'limit' (the next structural, or the end
+//  of the input), so the body is never scanned; strings without escapes (the
+//  common case) are left where they are.
+static inline bool JsonParser_string(JsonParser *const self, JsonNode *const node, const size_t position, const size_t limit) {
+    const char *const data = self->data;
+    const size_t start = position + 1;
+
+    size_t end = limit;
+    while (end > start && Json_isWhitespace(data[end - 1])) {
+        --end;
+    }
+    if (end <= start || data[end - 1] != '"') {
+        return Json_fail(position, "unterminated string");
+    }
+    --end;
+
+    const uint32_t* backslash = self->backslashes;
+    while (*backslash < start) {
+        ++backslash;
+    }
+    self->backslashes = backslash;
+    if (*backslash < end) {
+        return JsonParser_unescape(self, start, node);
+    }
+
+    node->string.offset = (uint32_t)start;
+    node->string.size = (uint32_t)(end - start);
+    return true;
+}
+
+static inline bool JsonParser_literal(JsonParser *const self, const size_t position, const cstr literal) {
+    const size_t end = position + literal.size;
+    if (end > self->size
+        || memcmp(self->data + position, literal.data, literal.size) != 0
+        || (end < self->size && !Json_isDelimiter(self->data[end]))) {
+        return Json_fail(position, "invalid literal");
+    }
+    return true;
+}
+
+// Checks for 'true' or 'false' without branching on which: in typical data
+//  that's a coin toss the predictor can't learn. Both end in 'e', so their
+//  first four bytes and their last one cover either.
+static inline bool JsonParser_boolean(JsonParser *const self, const size_t position, const bool value) {
+    static const char heads[2][4] = { { 'f', 'a', 'l', 's' }, { 't', 'r', 'u', 'e' } };
+    const size_t end = position + 5 - (size_t)value;
+    if (end > self->size
+        || memcmp(self->data + position, heads[value], 4) != 0
+        || self->data[end - 1] != 'e'
+        || (end < self->size && !Json_isDelimiter(self->data[end]))) {
+        return Json_fail(position, "invalid literal");
+    }
+    return true;
+}
+
+// Numbers are checked against the JSON grammar first. Integers are built in
+//  place; decimals whose digits fit in a double's mantissa and whose
+//  exponent is small are exact with one multiply or divide (both operands
+//  are exact, so the result is correctly rounded). The rest go to strtod.
+static bool JsonParser_number(JsonParser *const self, JsonNode *const node, const size_t position) {
+    const char *const data = self->data;
+    const size_t size = self->size;
+    size_t i = position;
+
+    const bool negative = (data[i] == '-');
+    if (negative) {
+        ++i;
+    }
+    if (i >= size || !Json_isDigit(data[i])) {
+        return Json_fail(position, negative ? "invalid number" : "unexpected character");
+    }
+
+    uint64_t mantissa = 0;
+    const size_t integerStart = i;
+    if (data[i] == '0') {
+        ++i;
+    } else {
+        i += Json_parseDigits(data + i, size - i, &mantissa);
+    }
+    const size_t integerDigits = i - integerStart;
+
+    bool integer = true;
+    size_t fractionDigits = 0;
+    if (i < size && data[i] == '.') {
+        integer = false;
+        ++i;
+        fractionDigits = Json_parseDigits(data + i, size - i, &mantissa);
+        i += fractionDigits;
+        if (fractionDigits == 0) {
+            return Json_fail(position, "invalid number");
+        }
+    }
+
+    int64_t exponent = 0;
+    if (i < size && (data[i] | 0x20) == 'e') {
+        integer = false;
+        ++i;
+        const bool negativeExponent = (i < size && data[i] == '-');
+        if (i < size && (data[i] == '-' || data[i] == '+')) {
+            ++i;
+        }
+        if (i >= size || !Json_isDigit(data[i])) {
+            return Json_fail(position, "invalid number");
+        }
+        for (; i < size && Json_isDigit(data[i]); ++i) {
+            // note: clamped; anything this large is out of range either way.
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (data[i] - '0');
+            }
+        }
+        exponent = negativeExponent ? -exponent : exponent;
+    }
+
+    if (i < size && !Json_isDelimiter(data[i])) {
+        return Json_fail(position, "invalid number");
+    }
+
+    const size_t digits = integerDigits + fractionDigits;
+    // note: the sign is a coin toss in typical data, so it's applied without a branch.
+    if (integer && digits <= 19 && mantissa <= INT64_MAX) {
+        node->i64 = negative ? -(int64_t)mantissa : (int64_t)mantissa;
+        return true;
+    }
+    if (integer && digits <= 19) {
+        if (negative) {
+            if (mantissa == (uint64_t)INT64_MAX + 1) {
+                node->i64 = INT64_MIN;
+                return true;
+            }
+        } else {
+            node->type = json_u64;
+            node->u64 = mantissa;
+            return true;
+        }
+    } else if (integer && digits == 20 && !negative) {
+        // note: 'mantissa' wrapped; redo the last step with an overflow check.
+        uint64_t head = 0;
+        for (size_t d = integerStart; d + 1 < i; ++d) {
+            head = head * 10 + (uint64_t)(data[d] - '0');
+        }
+        const uint64_t last = (uint64_t)(data[i - 1] - '0');
+        if (head <= (UINT64_MAX - last) / 10) {
+            node->type = json_u64;
+            node->u64 = head * 10 + last;
+            return true;
+        }
+    }
+
+    node->type = json_f64;
+    const int64_t scale = exponent - (int64_t)fractionDigits;
+    if (digits <= 19 && mantissa <= (1ull << 53) && scale >= -22 && scale <= 22) {
+        const double value = (scale < 0)
+            ? (double)mantissa / JsonPow10[-scale]
+            : (double)mantissa * JsonPow10[scale];
+        node->f64 = negative ? -value : value;
+        return true;
+    }
+
+    // note: strtod stops at the delimiter, so it can read the input in place
+    //  unless the number runs right up to the end of it (a bare top-level
+    //  number), which gets a terminated copy in the arena.
+    if (i < size) {
+        node->f64 = strtod(data + position, NULL);
+        return true;
+    }
+    const size_t length = i - position;
+    Block buffer = Allocator_alloc(&self->arena->base, char, length + 1);
+    if (buffer.data == NULL) {
+        return Json_fail(position, "out of arena memory for a number");
+    }
+    memcpy(buffer.data, data + position, length);
+    ((char*)buffer.data)[length] = '\0';
+    node->f64 = strtod(buffer.data, NULL);
+    Allocator_free(&self->arena->base, buffer);
+    return true;
+}
+
+// Stage 2: a state machine over the structural indices. Containers are kept
+//  on an explicit stack so deep nesting can't overflow the call stack, and
+//  array elements enter through their own label so only they bump the count.
+//  note: the tape's length is kept in a local and stored once at the end; kept
+//  in the parser, every node written would have to reload it.
+static bool JsonParser_run(JsonParser *const self, const uint32_t *const indices, const size_t count) {
+    const char *const data = self->data;
+    JsonNode *const nodes = self->nodes;
+    size_t nodeCount = 0;
+    uint32_t stack[JSON_MAX_DEPTH];
+    size_t depth = 0;
+    JsonNode* container = NULL;
+    size_t i = 0;
+    size_t position;
+
+arrayValue:
+    if (container != NULL) {
+        ++container->count;
+    }
+value:
+    if (i >= count) {
+        return Json_fail(self->size, "unexpected end of input");
+    }
+    position = indices[i++];
+
+    switch (data[position]) {
+        case '{':
+        case '[': {
+            if (depth == JSON_MAX_DEPTH) {
+                return Json_fail(position, "nesting too deep");
+            }
+            const bool object = (data[position] == '{');
+            container = Json_node(nodes, nodeCount, object ? json_object : json_array);
+            container->count = 0;
+            stack[depth++] = (uint32_t)nodeCount++;
+            if (i < count && data[indices[i]] == (object ? '}' : ']')) {
+                ++i;
+                goto close;
+            }
+            if (object) {
+                goto key;
+            }
+            goto arrayValue;
+        }
+        case '"':
+            if (!JsonParser_string(self, Json_node(nodes, nodeCount++, json_string), position, indices[i])) {
+                return false;
+            }
+            goto next;
+        case 't':
+        case 'f': {
+            const bool value = (data[position] == 't');
+            if (!JsonParser_boolean(self, position, value)) {
+                return false;
+            }
+            Json_node(nodes, nodeCount++, json_bool)->boolean = value;
+            goto next;
+        }
+        case 'n':
+            if (!JsonParser_literal(self, position, cstr_literal("null"))) {
+                return false;
+            }
+            Json_node(nodes, nodeCount++, json_null)->u64 = 0;
+            goto next;
+        default:
+            // note: JsonParser_number rejects anything that isn't one.
+            if (!JsonParser_number(self, Json_node(nodes, nodeCount++, json_i64), position)) {
+                return false;
+            }
+            goto next;
+    }
+
+close:
+    container->next = (uint32_t)nodeCount;
+    --depth;
+    container = (depth > 0) ? &nodes[stack[depth - 1]] : NULL;
+
+next:
+    if (container == NULL) {
+        if (i != count) {
+            return Json_fail(indices[i], "trailing content");
+        }
+        self->nodeCount = nodeCount;
+        return true;
+    }
+    if (i >= count) {
+        return Json_fail(self->size, "unexpected end of input");
+    }
+    position = indices[i++];
+    if (container->type == json_object) {
+        if (data[position] == ',') {
+            goto key;
+        }
+        if (data[position] == '}') {
+            goto close;
+        }
+        return Json_fail(position, "expected ',' or '}'");
+    }
+    if (data[position] == ',') {
+        goto arrayValue;
+    }
+    if (data[position] == ']') {
+        goto close;
+    }
+    return Json_fail(position, "expected ',' or ']'");
+
+key:
+    if (i >= count) {
+        return Json_fail(self->size, "unexpected end of input");
+    }
+    position = indices[i++];
+    if (data[position] != '"') {
+        return Json_fail(position, "expected a string key");
+    }
+    if (!JsonParser_string(self, Json_node(nodes, nodeCount++, json_string), position, indices[i])) {
+        return false;
+    }
+    ++container->count;
+    if (i >= count || data[indices[i]] != ':') {
+        return Json_fail((i < count) ? indices[i] : self->size, "expected ':'");
+    }
+    ++i;
+    goto value;
+}
+
+size_t JsonDoc_arenaSize(const size_t inputSize) {
+    // note: at worst every byte is a structural (and so a node), and every
+    //  string needs unescaping; plus slack for alignment.
+    return (inputSize + 2) * sizeof(uint32_t) + inputSize * (sizeof(JsonNode) + 1) + 64;
+}
+
+bool JsonDoc_parse(JsonDoc *const self, Arena *const arena, const cstr input) {
+    assert(self != NULL);
+    assert(arena != NULL);
+    assert(input.data != NULL || input.size == 0);
+
+    if (input.size > UINT32_MAX) {
+        fprintf(stderr, "[JsonDoc_parse] error: documents are limited to 4GB.\n");
+        return false;
+    }
+
+    // note: a failed parse hands back everything it took from the arena.
+    const size_t mark = arena->offset;
+    JsonParser parser = {
+        .data = input.data,
+        .size = input.size,
+        .arena = arena,
+    };
+
+    Block indices = Allocator_alloc(&arena->base, uint32_t, input.size + 2);
+    if (indices.data == NULL) {
+        fprintf(stderr, "[JsonDoc_parse] error: out of arena memory for the structural index.\n");
+        goto error;
+    }
+
+    size_t backslashCount = 0;
+    const size_t count = Json_index(input.data, input.size, indices.data, &backslashCount);
+    if (count == SIZE_MAX) {
+        Json_fail(input.size, "unterminated string");
+        goto error;
+    }
+    if (count == 0) {
+        Json_fail(input.size, "empty document");
+        goto error;
+    }
+
+    // Move the backslashes down to follow the structurals, in ascending order,
+    //  then trim the index. Each list ends in a sentinel (the input size, and
+    //  UINT32_MAX) so stage 2 needn't check where it is in either.
+    //  note: shrinking the newest allocation in an arena can't fail.
+    uint32_t *const backslashes = (uint32_t*)indices.data + count + 1;
+    uint32_t *const stored = (uint32_t*)indices.data + input.size + 2 - backslashCount;
+    for (size_t b = 0; b < backslashCount / 2; ++b) {
+        const uint32_t tmp = stored[b];
+        stored[b] = stored[backslashCount - 1 - b];
+        stored[backslashCount - 1 - b] = tmp;
+    }
+    memmove(backslashes, stored, backslashCount * sizeof(uint32_t));
+    ((uint32_t*)indices.data)[count] = (uint32_t)input.size;
+    backslashes[backslashCount] = UINT32_MAX;
+    (void)Allocator_resize(&arena->base, indices, uint32_t, count + backslashCount + 2);
+    parser.backslashes = backslashes;
+
+    // note: every node starts at a distinct structural, so 'count' always suffices.
+    Block nodes = Allocator_alloc(&arena->base, JsonNode, count);
+    if (nodes.data == NULL) {
+        fprintf(stderr, "[JsonDoc_parse] error: out of arena memory for the tape.\n");
+        goto error;
+    }
+    parser.nodes = nodes.data;
+
+    if (!JsonParser_run(&parser, indices.data, count)) {
+        goto error;
+    }
+
+    // note: give back whichever buffer came last.
+    if (parser.strings != NULL) {
+        (void)Allocator_resize(&arena->base, ((Block) { parser.strings, input.size }), char, parser.stringsSize);
+    } else {
+        (void)Allocator_resize(&arena->base, nodes, JsonNode, parser.nodeCount);
+    }
+
+    *self = (JsonDoc) {
+        .input = input,
+        .nodes = parser.nodes,
+        .count = parser.nodeCount,
+        .strings = parser.strings,
+    };
+    return true;
+
+error:
+    arena->offset = mark;
+    return false;
+}
+
+cstr JsonDoc_string(const JsonDoc *const self, const JsonNode *const node) {
+    assert(self != NULL);
+    assert(node != NULL && node->type == json_string);
+
+    const char *const base = node->unescaped ? self->strings : self->input.data;
+    return (cstr)Slice_from(base + node->string.offset, node->string.size);
+}
+
+const JsonNode* JsonDoc_find(const JsonDoc *const self, const JsonNode *const object, const cstr key) {
+    assert(self != NULL);
+    assert(object != NULL);
+
+    if (object->type != json_object) {
+        return NULL;
+    }
+
+    const JsonNode* member = object + 1;
+    for (size_t i = 0; i < object->count; ++i) {
+        const cstr name = JsonDoc_string(self, member);
+        if (name.size == key.size && memcmp(name.data, key.data, key.size) == 0) {
+            return member + 1;
+        }
+        member = JsonDoc_next(self, member + 1);
+    }
+    return NULL;
+}
+
+const JsonNode* JsonDoc_at(const JsonDoc *const self, const JsonNode *const array, const size_t index) {
+    assert(self != NULL);
+    assert(array != NULL);
+
+    if (array->type != json_array || index >= array->count) {
+        return NULL;
+    }
+
+    const JsonNode* element = array + 1;
+    for (size_t i = 0; i < index; ++i) {
+        element = JsonDoc_next(self, element);
+    }
+    return element;
+}
+
+JsonWriter JsonWriter_from(String *const out) {
+    assert(out != NULL);
+    return (JsonWriter) {
+        .out = out,
+        .needsComma = false,
+    };
+}
+
+static inline bool JsonWriter_separate(JsonWriter *const self) {
+    if (self->needsComma) {
+        return String_append_char(self->out, ',');
+    }
+    self->needsComma = true;
+    return true;
+}
+
+static bool JsonWriter_quote(String *const out, const cstr value) {
+    static const char hex[] = "0123456789abcdef";
+
+    // note: reserve for the common case where nothing needs escaping.
+    if (!String_grow(out, out->str.size + value.size + 2) || !String_append_char(out, '"')) {
+        return false;
+    }
+
+    size_t run = 0;
+    for (size_t i = 0; i < value.size; ++i) {
+        const uint8_t c = (uint8_t)value.data[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        char escape[6] = { '\\', 0 };
+        size_t escapeSize = 2;
+        switch (c) {
+            case '"': escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            default:
+                memcpy(escape, "\\u00", 4);
+                escape[4] = hex[c >> 4];
+                escape[5] = hex[c & 0xf];
+                escapeSize = 6;
+                break;
+        }
+        if (!String_append_str(out, cstr_slice(value, run, i - run))
+            || !String_append_str(out, (cstr)Slice_from((const char*)escape, escapeSize))) {
+            return false;
+        }
+        run = i + 1;
+    }
+
+    return String_append_str(out, cstr_slice(value, run, value.size - run))
+        && String_append_char(out, '"');
+}
+
+bool JsonWriter_beginObject(JsonWriter *const self) {
+    assert(self != NULL);
+    const bool result = JsonWriter_separate(self) && String_append_char(self->out, '{');
+    self->needsComma = false;
+    return result;
+}
+
+bool JsonWriter_endObject(JsonWriter *const self) {
+    assert(self != NULL);
+    self->needsComma = true;
+    return String_append_char(self->out, '}');
+}
+
+bool JsonWriter_beginArray(JsonWriter *const self) {
+    assert(self != NULL);
+    const bool result = JsonWriter_separate(self) && String_append_char(self->out, '[');
+    self->needsComma = false;
+    return result;
+}
+
+bool JsonWriter_endArray(JsonWriter *const self) {
+    assert(self != NULL);
+    self->needsComma = true;
+    return String_append_char(self->out, ']');
+}
+
+bool JsonWriter_key(JsonWriter *const self, const cstr key) {
+    assert(self != NULL);
+    const bool result = JsonWriter_separate(self)
+        && JsonWriter_quote(self->out, key)
+        && String_append_char(self->out, ':');
+    self->needsComma = false;
+    return result;
+}
+
+bool JsonWriter_write_str(JsonWriter *const self, const cstr value) {
+    assert(self != NULL);
+    return JsonWriter_separate(self) && JsonWriter_quote(self->out, value);
+}
+
+bool JsonWriter_write_i64(JsonWriter *const self, const int64_t value) {
+    assert(self != NULL);
+    return JsonWriter_separate(self) && String_append_i64(self->out, value, false);
+}
+
+bool JsonWriter_write_u64(JsonWriter *const self, const uint64_t value) {
+    assert(self != NULL);
+    return JsonWriter_separate(self) && String_append_u64(self->out, value, false);
+}
+
+// Most doubles in practice are short decimals (prices, scores, ratios): finds
+//  the smallest power of ten that scales the value to an exact integer which
+//  divides back to the same double, and prints that with integer formatting.
+//  The division is exact-operand and correctly rounded, the same computation
+//  the reader's fast path does, so the digits are guaranteed to round-trip.
+//  Returns 0 for values this can't handle.
+static size_t Json_formatDecimal(char *const buffer, const double value) {
+    const double magnitude = fabs(value);
+    for (size_t scale = 0; scale < n5_arraySize(JsonPow10); ++scale) {
+        const double scaled = magnitude * JsonPow10[scale];
+        if (scaled >= 9007199254740992.0) {
+            return 0;
+        }
+        const uint64_t digits = (uint64_t)scaled;
+        if ((double)digits != scaled || (double)digits / JsonPow10[scale] != magnitude) {
+            continue;
+        }
+
+        // note: digits come out backwards, padded so there's one before the point.
+        char reversed[24];
+        size_t count = 0;
+        uint64_t rest = digits;
+        do {
+            reversed[count++] = (char)('0' + rest % 10);
+            rest /= 10;
+        } while (rest != 0);
+        while (count < scale + 1) {
+            reversed[count++] = '0';
+        }
+
+        size_t size = 0;
+        if (signbit(value)) {
+            buffer[size++] = '-';
+        }
+        for (size_t i = count; i > scale; --i) {
+            buffer[size++] = reversed[i - 1];
+        }
+        buffer[size++] = '.';
+        if (scale == 0) {
+            buffer[size++] = '0';
+        }
+        for (size_t i = scale; i > 0; --i) {
+            buffer[size++] = reversed[i - 1];
+        }
+        return size;
+    }
+    return 0;
+}
+
+bool JsonWriter_write_f64(JsonWriter *const self, const double value) {
+    assert(self != NULL);
+
+    if (!isfinite(value)) {
+        return JsonWriter_write_null(self);
+    }
+
+    // note: String_append_f64 is fixed at 4 decimals, so anything that isn't
+    //  a short decimal goes through printf, with the fewest digits that read
+    //  back as the same double.
+    char buffer[32];
+    size_t size = Json_formatDecimal(buffer, value);
+    for (int precision = 15; size == 0 && precision <= 17; ++precision) {
+        const int written = snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (precision == 17 || strtod(buffer, NULL) == value) {
+            size = (size_t)written;
+        }
+    }
+    // note: keep large integral values from reading back as integers.
+    if (memchr(buffer, '.', size) == NULL && memchr(buffer, 'e', size) == NULL) {
+        memcpy(buffer + size, ".0", 2);
+        size += 2;
+    }
+    return JsonWriter_separate(self)
+        && String_append_str(self->out, (cstr)Slice_from((const char*)buffer, size));
+}
+
+bool JsonWriter_write_bool(JsonWriter *const self, const bool value) {
+    assert(self != NULL);
+    return JsonWriter_separate(self) && String_append_bool(self->out, value);
+}
+
+bool JsonWriter_write_null(JsonWriter *const self) {
+    assert(self != NULL);
+    return JsonWriter_separate(self) && String_append_str(self->out, cstr_literal("null"));
+}
@@ -0,0 +1,313 @@
+#include "n5/log.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "n5/alloc.h"
+#include "n5/utils.h"
+
+#define MIN_RING_CAPACITY 4096
+#define DEFAULT_BATCH_SIZE (64 * 1024)
+#define IDLE_SLEEP_NS 200000
+
+#define RECORD_ALIGN alignof(FormatArg)
+#define PADDING_RECORD SIZE_MAX
+
+static int Logger_run(void* arg);
+
+bool Logger_init(Logger *const self, Allocator *const owner, FILE *const file, const LogOverflow overflow) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(file != NULL);
+
+    *self = (Logger) {
+        .owner = owner,
+        .file = file,
+        .overflow = overflow,
+        .batchSize = DEFAULT_BATCH_SIZE,
+        .line = String_new(owner, 256),
+        .batch = String_new(owner, DEFAULT_BATCH_SIZE),
+    };
+
+    if (self->line.str.data == NULL || self->batch.str.data == NULL) {
+        fprintf(stderr, "[Logger] error: buffer allocation failed.\n");
+        goto error;
+    }
+
+    if (mtx_init(&self->lock, mtx_plain) != thrd_success) {
+        fprintf(stderr, "[Logger] error: failed to create mutex.\n");
+        goto error;
+    }
+
+    atomic_init(&self->running, true);
+    if (thrd_create(&self->thread, Logger_run, self) != thrd_success) {
+        fprintf(stderr, "[Logger] error: failed to start consumer thread.\n");
+        mtx_destroy(&self->lock);
+        goto error;
+    }
+
+    return true;
+
+error:
+    if (self->line.str.data != NULL) {
+        String_free(&self->line);
+    }
+    if (self->batch.str.data != NULL) {
+        String_free(&self->batch);
+    }
+    *self = (Logger) { 0 };
+    return false;
+}
+
+void Logger_deinit(Logger *const self) {
+    assert(self != NULL);
+    assert(self->producers == NULL);
+
+    atomic_store_explicit(&self->running, false, memory_order_release);
+    thrd_join(self->thread, NULL);
+
+    mtx_destroy(&self->lock);
+    String_free(&self->line);
+    String_free(&self->batch);
+    *self = (Logger) { 0 };
+}
+
+bool LogProducer_init(
+    LogProducer *const self,
+    Logger *const logger,
+    Allocator *const owner,
+    const size_t capacity
+) {
+    assert(self != NULL);
+    assert(logger != NULL);
+    assert(owner != NULL);
+
+    const size_t size = n5_nextPow2(n5_max(capacity, MIN_RING_CAPACITY));
+    // note: rounded up, since a power of two isn't a multiple of sizeof(FormatArg).
+    Block buffer = Allocator_alloc(owner, FormatArg, (size + sizeof(FormatArg) - 1) / sizeof(FormatArg));
+    if (buffer.data == NULL) {
+        fprintf(stderr, "[LogProducer] error: ring allocation failed.\n");
+        return false;
+    }
+
+    *self = (LogProducer) {
+        .logger = logger,
+        .owner = owner,
+        .buffer = buffer,
+        .mask = size - 1,
+    };
+    atomic_init(&self->head, 0);
+    atomic_init(&self->tail, 0);
+    atomic_init(&self->dropped, 0);
+
+    mtx_lock(&logger->lock);
+    self->next = logger->producers;
+    logger->producers = self;
+    mtx_unlock(&logger->lock);
+
+    return true;
+}
+
+void LogProducer_deinit(LogProducer *const self) {
+    assert(self != NULL);
+    assert(self->logger != NULL);
+
+    // wait for the consumer to catch up before unlinking the ring, including
+    //  the report for any records dropped since its last pass.
+    const size_t head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    while (atomic_load_explicit(&self->tail, memory_order_acquire) != head
+        || atomic_load_explicit(&self->dropped, memory_order_relaxed) != 0) {
+        thrd_yield();
+    }
+
+    Logger *const logger = self->logger;
+    mtx_lock(&logger->lock);
+    LogProducer** node = &logger->producers;
+    while (*node != NULL && *node != self) {
+        node = &(*node)->next;
+    }
+    if (*node == self) {
+        *node = self->next;
+    }
+    mtx_unlock(&logger->lock);
+
+    Allocator_free(self->owner, self->buffer);
+    *self = (LogProducer) { 0 };
+}
+
+bool Log_write_raw(LogProducer *const self, const cstr format, const FormatArgs args) {
+    assert(self != NULL);
+    assert(format.data != NULL);
+
+    size_t payloadSize = 0;
+    for (size_t i = 0; i < args.size; ++i) {
+        if (args.data[i].type == fmt_str) {
+            payloadSize += args.data[i].str.size;
+        } else if (args.data[i].type == fmt_custom) {
+            // note: the callback context can't be copied, so it can't outlive this call.
+            fprintf(stderr, "[Log_write] error: fmt_custom arguments cannot be deferred.\n");
+            return false;
+        }
+    }
+
+    const size_t capacity = self->mask + 1;
+    const size_t size = n5_alignSize(
+        sizeof(LogRecord) + Slice_rawSize(args) + payloadSize,
+        RECORD_ALIGN
+    );
+    if (size > capacity / 2) {
+        fprintf(stderr, "[Log_write] error: record exceeds ring capacity.\n");
+        return false;
+    }
+
+    const size_t head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    const size_t offset = head & self->mask;
+    const size_t contiguous = capacity - offset;
+    // records never wrap, so pad out the end of the ring if necessary.
+    const size_t required = (contiguous < size) ? (contiguous + size) : size;
+
+    size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+    while (capacity - (head - tail) < required) {
+        switch (self->logger->overflow) {
+            case log_overflow_block: {
+                thrd_yield();
+                tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+            } break;
+
+            case log_overflow_count: {
+                atomic_fetch_add_explicit(&self->dropped, 1, memory_order_relaxed);
+                return false;
+            }
+
+            default: {
+                return false;
+            }
+        }
+    }
+
+    uint8_t *const ring = self->buffer.data;
+    uint8_t* cursor = ring + offset;
+    if (contiguous < size) {
+        // note: a tail too small to hold a header is skipped implicitly by the consumer.
+        if (contiguous >= sizeof(LogRecord)) {
+                *(LogRecord*)cursor = (LogRecord) {
+                .size = contiguous,
+                .argCount = PADDING_RECORD,
+            };
+        }
+        cursor = ring;
+    }
+
+    LogRecord *const record = (LogRecord*)cursor;
+    *record = (LogRecord) {
+        .size = size,
+        .format = format,
+        .argCount = args.size,
+    };
+
+    FormatArg *const recordArgs = (FormatArg*)(record + 1);
+    char* payload = (char*)(recordArgs + args.size);
+    for (size_t i = 0; i < args.size; ++i) {
+        recordArgs[i] = args.data[i];
+        if (args.data[i].type == fmt_str && args.data[i].str.size > 0) {
+            memcpy(payload, args.data[i].str.data, args.data[i].str.size);
+            recordArgs[i].str.data = payload;
+            payload += args.data[i].str.size;
+        }
+    }
+
+    atomic_store_explicit(&self->head, head + required, memory_order_release);
+    return true;
+}
+
+static bool Logger_flushBatch(Logger *const self) {
+    if (self->batch.str.size == 0) {
+        return true;
+    }
+
+    const size_t size = self->batch.str.size;
+    const size_t written = fwrite(self->batch.str.data, 1, size, self->file);
+    self->batch.str.size = 0;
+    self->batch.str.data[0] = '\0';
+    if (written != size) {
+        fprintf(stderr, "[Logger] error: failed to write batch.\n");
+        return false;
+    }
+    return true;
+}
+
+static void Logger_emit(Logger *const self, const cstr line) {
+    if (!String_append_str(&self->batch, line) || !String_append_char(&self->batch, '\n')) {
+        fprintf(stderr, "[Logger] error: failed to append to batch.\n");
+    }
+
+    if (self->batch.str.size >= self->batchSize) {
+        Logger_flushBatch(self);
+    }
+}
+
+static size_t Logger_drainProducer(Logger *const self, LogProducer *const producer) {
+    const size_t dropped = atomic_exchange_explicit(&producer->dropped, 0, memory_order_relaxed);
+    if (dropped > 0 && String_format(
+        &self->line,
+        cstr_literal("[Logger] {} record(s) dropped."),
+        FormatArg_u64(dropped)
+    )) {
+        Logger_emit(self, cstr_cast(self->line.str));
+    }
+
+    const uint8_t *const ring = producer->buffer.data;
+    const size_t head = atomic_load_explicit(&producer->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&producer->tail, memory_order_relaxed);
+
+    const size_t capacity = producer->mask + 1;
+    size_t count = 0;
+    while (tail != head) {
+        const size_t contiguous = capacity - (tail & producer->mask);
+        if (contiguous < sizeof(LogRecord)) {
+            tail += contiguous;
+            continue;
+        }
+
+        const LogRecord *const record = (const LogRecord*)(ring + (tail & producer->mask));
+        if (record->argCount != PADDING_RECORD) {
+            const FormatArgs args = Slice_from((const FormatArg*)(record + 1), record->argCount);
+            if (String_format_raw(&self->line, record->format, args)) {
+                Logger_emit(self, cstr_cast(self->line.str));
+            }
+            ++count;
+        }
+        tail += record->size;
+    }
+
+    atomic_store_explicit(&producer->tail, tail, memory_order_release);
+    return count;
+}
+
+static size_t Logger_drain(Logger *const self) {
+    size_t count = 0;
+    mtx_lock(&self->lock);
+    for (LogProducer* producer = self->producers; producer != NULL; producer = producer->next) {
+        count += Logger_drainProducer(self, producer);
+    }
+    mtx_unlock(&self->lock);
+    return count;
+}
+
+static int Logger_run(void *const arg) {
+    Logger *const self = arg;
+
+    while (atomic_load_explicit(&self->running, memory_order_acquire)) {
+        if (Logger_drain(self) == 0) {
+            Logger_flushBatch(self);
+            fflush(self->file);
+            thrd_sleep(&(struct timespec) { .tv_nsec = IDLE_SLEEP_NS }, NULL);
+        }
+    }
+
+    while (Logger_drain(self) > 0) {}
+    Logger_flushBatch(self);
+    fflush(self->file);
+
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include "n5/queue.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <threads.h>
+
+// Copies 'count' items into the ring starting at index 'position', wrapping
+//  around the end at most once.
+static void Queue_copyIn(const Block buffer, const size_t mask, const size_t itemSize, const size_t position, const void *const items, const size_t count) {
+    const size_t start = position & mask;
+    const size_t first = n5_min(count, mask + 1 - start);
+    uint8_t *const ring = buffer.data;
+    memcpy(ring + start * itemSize, items, first * itemSize);
+    memcpy(ring, (const uint8_t*)items + first * itemSize, (count - first) * itemSize);
+}
+
+static void Queue_copyOut(const Block buffer, const size_t mask, const size_t itemSize, const size_t position, void *const items, const size_t count) {
+    const size_t start = position & mask;
+    const size_t first = n5_min(count, mask + 1 - start);
+    const uint8_t *const ring = buffer.data;
+    memcpy(items, ring + start * itemSize, first * itemSize);
+    memcpy((uint8_t*)items + first * itemSize, ring, (count - first) * itemSize);
+}
+
+bool SpscQueue_init(SpscQueue *const self, Allocator *const owner, const size_t capacity, const size_t itemSize) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(capacity > 0);
+    assert(itemSize > 0);
+
+    const size_t size = n5_nextPow2(capacity);
+    Block buffer = Allocator_alloc(owner, uint8_t, size * itemSize);
+    if (buffer.data == NULL) {
+        fprintf(stderr, "[SpscQueue] error: ring allocation failed.\n");
+        return false;
+    }
+
+    *self = (SpscQueue) {
+        .owner = owner,
+        .buffer = buffer,
+        .itemSize = itemSize,
+        .mask = size - 1,
+    };
+    atomic_init(&self->head, 0);
+    atomic_init(&self->tail, 0);
+    return true;
+}
+
+void SpscQueue_deinit(SpscQueue *const self) {
+    assert(self != NULL);
+    Allocator_free(self->owner, self->buffer);
+    *self = (SpscQueue) { 0 };
+}
+
+bool SpscQueue_push(SpscQueue *const self, const void *const item) {
+    return SpscQueue_pushBatch(self, item, 1) == 1;
+}
+
+bool SpscQueue_pop(SpscQueue *const self, void *const item) {
+    return SpscQueue_popBatch(self, item, 1) == 1;
+}
+
+size_t SpscQueue_pushBatch(SpscQueue *const self, const void *const items, const size_t count) {
+    assert(self != NULL);
+    assert(items != NULL || count == 0);
+
+    const size_t head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    const size_t capacity = self->mask + 1;
+    // note: the consumer's index is only re-read when the cached one says there isn't room.
+    if (capacity - (head - self->cachedTail) < count) {
+        self->cachedTail = atomic_load_explicit(&self->tail, memory_order_acquire);
+    }
+    const size_t pushed = n5_min(count, capacity - (head - self->cachedTail));
+    if (pushed == 0) {
+        return 0;
+    }
+
+    Queue_copyIn(self->buffer, self->mask, self->itemSize, head, items, pushed);
+    atomic_store_explicit(&self->head, head + pushed, memory_order_release);
+    return pushed;
+}
+
+size_t SpscQueue_popBatch(SpscQueue *const self, void *const items, const size_t count) {
+    assert(self != NULL);
+    assert(items != NULL || count == 0);
+
+    const size_t tail = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    if (self->cachedHead - tail < count) {
+        self->cachedHead = atomic_load_explicit(&self->head, memory_order_acquire);
+    }
+    const size_t popped = n5_min(count, self->cachedHead - tail);
+    if (popped == 0) {
+        return 0;
+    }
+
+    Queue_copyOut(self->buffer, self->mask, self->itemSize, tail, items, popped);
+    atomic_store_explicit(&self->tail, tail + popped, memory_order_release);
+    return popped;
+}
+
+size_t SpscQueue_size(SpscQueue *const self) {
+    assert(self != NULL);
+    const size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+    return atomic_load_explicit(&self->head, memory_order_acquire) - tail;
+}
+
+// Each cell is a sequence number followed by the item. A cell at position p is
+//  free for the producer of p when its sequence is p, and full for the consumer
+//  of p when it's p + 1; consuming it sets it to p + capacity, the next lap.
+static inline atomic_size_t* MpmcQueue_cell(const MpmcQueue *const self, const size_t position) {
+    return (atomic_size_t*)((uint8_t*)self->buffer.data + (position & self->mask) * self->cellSize);
+}
+
+bool MpmcQueue_init(MpmcQueue *const self, Allocator *const owner, const size_t capacity, const size_t itemSize) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(capacity > 0);
+    assert(itemSize > 0);
+
+    // note: one cell can't tell "full" from "empty", since both laps share a sequence.
+    const size_t size = n5_nextPow2(n5_max(capacity, 2));
+    const size_t cellSize = n5_alignSize(sizeof(atomic_size_t) + itemSize, sizeof(atomic_size_t));
+    Block buffer = Allocator_alloc(owner, atomic_size_t, size * cellSize / sizeof(atomic_size_t));
+    if (buffer.data == NULL) {
+        fprintf(stderr, "[MpmcQueue] error: ring allocation failed.\n");
+        return false;
+    }
+
+    *self = (MpmcQueue) {
+        .owner = owner,
+        .buffer = buffer,
+        .itemSize = itemSize,
+        .cellSize = cellSize,
+        .mask = size - 1,
+    };
+    for (size_t i = 0; i < size; ++i) {
+        atomic_init(MpmcQueue_cell(self, i), i);
+    }
+    atomic_init(&self->head, 0);
+    atomic_init(&self->tail, 0);
+    return true;
+}
+
+void MpmcQueue_deinit(MpmcQueue *const self) {
+    assert(self != NULL);
+    Allocator_free(self->owner, self->buffer);
+    *self = (MpmcQueue) { 0 };
+}
+
+bool MpmcQueue_push(MpmcQueue *const self, const void *const item) {
+    assert(self != NULL);
+    assert(item != NULL);
+
+    size_t position = atomic_load_explicit(&self->head, memory_order_relaxed);
+    atomic_size_t* cell;
+    for (;;) {
+        cell = MpmcQueue_cell(self, position);
+        const size_t sequence = atomic_load_explicit(cell, memory_order_acquire);
+        const intptr_t lag = (intptr_t)(sequence - position);
+        if (lag == 0) {
+            if (atomic_compare_exchange_weak_explicit(&self->head, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // note: the cell still holds last lap's item.
+            return false;
+        } else {
+            position = atomic_load_explicit(&self->head, memory_order_relaxed);
+        }
+    }
+
+    memcpy(cell + 1, item, self->itemSize);
+    atomic_store_explicit(cell, position + 1, memory_order_release);
+    return true;
+}
+
+bool MpmcQueue_pop(MpmcQueue *const self, void *const item) {
+    assert(self != NULL);
+    assert(item != NULL);
+
+    size_t position = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    atomic_size_t* cell;
+    for (;;) {
+        cell = MpmcQueue_cell(self, position);
+        const size_t sequence = atomic_load_explicit(cell, memory_order_acquire);
+        const intptr_t lag = (intptr_t)(sequence - (position + 1));
+        if (lag == 0) {
+            if (atomic_compare_exchange_weak_explicit(&self->tail, &position, position + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // note: nothing has been pushed into this cell yet.
+            return false;
+        } else {
+            position = atomic_load_explicit(&self->tail, memory_order_relaxed);
+        }
+    }
+
+    memcpy(item, cell + 1, self->itemSize);
+    atomic_store_explicit(cell, position + self->mask + 1, memory_order_release);
+    return true;
+}
+
+// note: spins only on cells whose previous owner has already claimed them.
+static inline void MpmcQueue_await(atomic_size_t *const cell, const size_t sequence) {
+    while (atomic_load_explicit(cell, memory_order_acquire) != sequence) {
+        thrd_yield();
+    }
+}
+
+size_t MpmcQueue_pushBatch(MpmcQueue *const self, const void *const items, const size_t count) {
+    assert(self != NULL);
+    assert(items != NULL || count == 0);
+
+    // Claims the range by counting: a stale tail can only under-report free
+    //  cells, and every cell below the tail has been claimed by a consumer.
+    const size_t capacity = self->mask + 1;
+    size_t position = atomic_load_explicit(&self->head, memory_order_relaxed);
+    size_t pushed;
+    for (;;) {
+        const size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+        const size_t used = position - tail;
+        if ((intptr_t)used < 0 || used > capacity) {
+            // note: the two indices were read too far apart to compare.
+            position = atomic_load_explicit(&self->head, memory_order_relaxed);
+            continue;
+        }
+        pushed = n5_min(count, capacity - used);
+        if (pushed == 0) {
+            return 0;
+        }
+        if (atomic_compare_exchange_weak_explicit(&self->head, &position, position + pushed, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    const uint8_t* item = items;
+    for (size_t i = 0; i < pushed; ++i, item += self->itemSize) {
+        atomic_size_t *const cell = MpmcQueue_cell(self, position + i);
+        MpmcQueue_await(cell, position + i);
+        memcpy(cell + 1, item, self->itemSize);
+        atomic_store_explicit(cell, position + i + 1, memory_order_release);
+    }
+    return pushed;
+}
+
+size_t MpmcQueue_popBatch(MpmcQueue *const self, void *const items, const size_t count) {
+    assert(self != NULL);
+    assert(items != NULL || count == 0);
+
+    size_t position = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    size_t popped;
+    for (;;) {
+        const size_t head = atomic_load_explicit(&self->head, memory_order_acquire);
+        if ((intptr_t)(head - position) <= 0) {
+            return 0;
+        }
+        popped = n5_min(count, head - position);
+        if (atomic_compare_exchange_weak_explicit(&self->tail, &position, position + popped, memory_order_relaxed, memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    uint8_t* item = items;
+    for (size_t i = 0; i < popped; ++i, item += self->itemSize) {
+        atomic_size_t *const cell = MpmcQueue_cell(self, position + i);
+        MpmcQueue_await(cell, position + i + 1);
+        memcpy(item, cell + 1, self->itemSize);
+        atomic_store_explicit(cell, position + i + self->mask + 1, memory_order_release);
+    }
+    return popped;
+}
+
+size_t MpmcQueue_size(MpmcQueue *const self) {
+    assert(self != NULL);
+    const size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+    const size_t head = atomic_load_explicit(&self->head, memory_order_acquire);
+    return ((intptr_t)(head - tail) > 0) ? n5_min(head - tail, self->mask + 1) : 0;
+}
@@ -0,0 +1,853 @@
+#include "n5/radix.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RADIX_SSE2 1
+#include <emmintrin.h>
+#else
+#define RADIX_SSE2 0
+#endif
+
+// note: longer prefixes keep only their first bytes; the rest are read back
+//  from a leaf below when needed (and otherwise skipped, then checked at the leaf).
+#define PREFIX_MAX 16
+
+typedef struct RadixLeaf RadixLeaf;
+typedef struct RadixNode4 RadixNode4;
+typedef struct RadixNode16 RadixNode16;
+typedef struct RadixNode48 RadixNode48;
+typedef struct RadixNode256 RadixNode256;
+typedef struct RadixWalk RadixWalk;
+
+typedef enum RadixNodeType {
+    radix_node4,
+    radix_node16,
+    radix_node48,
+    radix_node256,
+} RadixNodeType;
+
+// Child pointers with the low bit set are leaves: the key's size, then the
+//  value, then the key itself.
+struct RadixLeaf {
+    size_t size;
+};
+
+// 'terminal' is the leaf for the key that ends right after this node's prefix,
+//  which is also the smallest key below it.
+struct RadixNode {
+    uint8_t type;
+    uint16_t count;
+    uint32_t prefixSize;
+    uint8_t prefix[PREFIX_MAX];
+    RadixLeaf* terminal;
+};
+
+// note: 4 and 16 keep their keys sorted; 48 maps a byte to its child's slot + 1.
+struct RadixNode4 {
+    RadixNode base;
+    uint8_t keys[4];
+    RadixNode* children[4];
+};
+
+struct RadixNode16 {
+    RadixNode base;
+    uint8_t keys[16];
+    RadixNode* children[16];
+};
+
+struct RadixNode48 {
+    RadixNode base;
+    uint8_t index[256];
+    RadixNode* children[48];
+};
+
+struct RadixNode256 {
+    RadixNode base;
+    RadixNode* children[256];
+};
+
+struct RadixWalk {
+    const RadixTree* tree;
+    cstr lower;
+    cstr upper;
+    // note: with this set, keys that start with 'upper' are in range too.
+    bool upperIsPrefix;
+    RadixVisitFn fn;
+    void* ctx;
+};
+
+static const size_t RadixNode_sizes[] = {
+    [radix_node4] = sizeof(RadixNode4),
+    [radix_node16] = sizeof(RadixNode16),
+    [radix_node48] = sizeof(RadixNode48),
+    [radix_node256] = sizeof(RadixNode256),
+};
+
+static inline bool Radix_isLeaf(const RadixNode *const ref) {
+    return ((uintptr_t)ref & 1) != 0;
+}
+
+static inline RadixLeaf* Radix_leaf(const RadixNode *const ref) {
+    return (RadixLeaf*)((uintptr_t)ref - 1);
+}
+
+static inline RadixNode* Radix_tag(const RadixLeaf *const leaf) {
+    return (RadixNode*)((uintptr_t)leaf + 1);
+}
+
+static inline size_t RadixTree_valueStride(const RadixTree *const self) {
+    return n5_alignSize(self->valueSize, sizeof(uint64_t));
+}
+
+static inline void* RadixLeaf_value(const RadixLeaf *const leaf) {
+    return (void*)(leaf + 1);
+}
+
+static inline cstr RadixLeaf_key(const RadixTree *const tree, const RadixLeaf *const leaf) {
+    return (cstr)Slice_from((const char*)(leaf + 1) + RadixTree_valueStride(tree), leaf->size);
+}
+
+static inline Block RadixLeaf_block(const RadixTree *const tree, RadixLeaf *const leaf) {
+    return (Block) {
+        .data = leaf,
+        .size = n5_alignSize(sizeof(RadixLeaf) + RadixTree_valueStride(tree) + leaf->size, sizeof(uint64_t)),
+    };
+}
+
+static RadixLeaf* RadixTree_newLeaf(RadixTree *const self, const cstr key) {
+    const size_t words = n5_alignSize(sizeof(RadixLeaf) + RadixTree_valueStride(self) + key.size, sizeof(uint64_t)) / sizeof(uint64_t);
+    RadixLeaf *const leaf = Allocator_alloc(self->owner, uint64_t, words).data;
+    if (leaf == NULL) {
+        return NULL;
+    }
+    leaf->size = key.size;
+    memset(RadixLeaf_value(leaf), 0, RadixTree_valueStride(self));
+    memcpy((char*)RadixLeaf_value(leaf) + RadixTree_valueStride(self), key.data, key.size);
+    return leaf;
+}
+
+static inline void RadixTree_freeLeaf(RadixTree *const self, RadixLeaf *const leaf) {
+    Allocator_free(self->owner, RadixLeaf_block(self, leaf));
+}
+
+static RadixNode* RadixTree_newNode(RadixTree *const self, const RadixNodeType type) {
+    RadixNode *const node = Allocator_alloc(self->owner, uint64_t, RadixNode_sizes[type] / sizeof(uint64_t)).data;
+    if (node == NULL) {
+        return NULL;
+    }
+    memset(node, 0, RadixNode_sizes[type]);
+    node->type = type;
+    return node;
+}
+
+static inline void RadixTree_freeNode(RadixTree *const self, RadixNode *const node) {
+    Allocator_free(self->owner, ((Block) { .data = node, .size = RadixNode_sizes[node->type] }));
+}
+
+static inline bool Radix_keyEquals(const cstr a, const cstr b) {
+    return a.size == b.size && memcmp(a.data, b.data, a.size) == 0;
+}
+
+static inline bool Radix_startsWith(const cstr key, const cstr prefix) {
+    return key.size >= prefix.size && memcmp(key.data, prefix.data, prefix.size) == 0;
+}
+
+// note: lexicographic, so a prefix sorts before the keys that extend it.
+static inline int Radix_compare(const cstr a, const cstr b) {
+    const int result = memcmp(a.data, b.data, n5_min(a.size, b.size));
+    if (result != 0) {
+        return result;
+    }
+    return (a.size > b.size) - (a.size < b.size);
+}
+
+static RadixNode** RadixNode_findChild(RadixNode *const node, const uint8_t byte) {
+    switch (node->type) {
+        case radix_node4: {
+            RadixNode4 *const n = (RadixNode4*)node;
+            for (uint32_t i = 0; i < node->count; ++i) {
+                if (n->keys[i] == byte) {
+                    return &n->children[i];
+                }
+            }
+            return NULL;
+        }
+        case radix_node16: {
+            RadixNode16 *const n = (RadixNode16*)node;
+#if RADIX_SSE2
+            const __m128i keys = _mm_loadu_si128((const __m128i*)n->keys);
+            const uint32_t match = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8((char)byte)))
+                & ((1u << node->count) - 1);
+            return (match != 0) ? &n->children[n5_ctz32(match)] : NULL;
+#else
+            for (uint32_t i = 0; i < node->count; ++i) {
+                if (n->keys[i] == byte) {
+                    return &n->children[i];
+                }
+            }
+            return NULL;
+#endif
+        }
+        case radix_node48: {
+            RadixNode48 *const n = (RadixNode48*)node;
+            return (n->index[byte] != 0) ? &n->children[n->index[byte] - 1] : NULL;
+        }
+        default: {
+            RadixNode256 *const n = (RadixNode256*)node;
+            return (n->children[byte] != NULL) ? &n->children[byte] : NULL;
+        }
+    }
+}
+
+// Returns the child with the smallest byte >= '*byte' (updating '*byte'), or
+//  NULL if there isn't one.
+static RadixNode* RadixNode_nextChild(const RadixNode *const node, uint32_t *const byte) {
+    switch (node->type) {
+        case radix_node4:
+        case radix_node16: {
+            const uint8_t *const keys = (node->type == radix_node4) ? ((const RadixNode4*)node)->keys : ((const RadixNode16*)node)->keys;
+            RadixNode *const *const children = (node->type == radix_node4) ? ((const RadixNode4*)node)->children : ((const RadixNode16*)node)->children;
+            for (uint32_t i = 0; i < node->count; ++i) {
+                if (keys[i] >= *byte) {
+                    *byte = keys[i];
+                    return children[i];
+                }
+            }
+            return NULL;
+        }
+        case radix_node48: {
+            const RadixNode48 *const n = (const RadixNode48*)node;
+            for (uint32_t b = *byte; b < 256; ++b) {
+                if (n->index[b] != 0) {
+                    *byte = b;
+                    return n->children[n->index[b] - 1];
+                }
+            }
+            return NULL;
+        }
+        default: {
+            const RadixNode256 *const n = (const RadixNode256*)node;
+            for (uint32_t b = *byte; b < 256; ++b) {
+                if (n->children[b] != NULL) {
+                    *byte = b;
+                    return n->children[b];
+                }
+            }
+            return NULL;
+        }
+    }
+}
+
+static const RadixLeaf* RadixNode_minLeaf(const RadixNode* ref) {
+    while (!Radix_isLeaf(ref)) {
+        if (ref->terminal != NULL) {
+            return ref->terminal;
+        }
+        uint32_t byte = 0;
+        ref = RadixNode_nextChild(ref, &byte);
+    }
+    return Radix_leaf(ref);
+}
+
+static void RadixNode_copyHeader(RadixNode *const dest, const RadixNode *const source) {
+    dest->count = source->count;
+    dest->prefixSize = source->prefixSize;
+    memcpy(dest->prefix, source->prefix, sizeof(dest->prefix));
+    dest->terminal = source->terminal;
+}
+
+// Moves 'node' into a node of 'type' (bigger or smaller), replacing it in '*ref'.
+static bool RadixTree_retype(RadixTree *const self, RadixNode **const ref, const RadixNodeType type) {
+    RadixNode *const node = *ref;
+    RadixNode *const next = RadixTree_newNode(self, type);
+    if (next == NULL) {
+        return false;
+    }
+    RadixNode_copyHeader(next, node);
+
+    // note: children are visited in byte order, so sorted nodes stay sorted.
+    uint32_t slot = 0;
+    uint32_t byte = 0;
+    for (RadixNode* child; byte < 256 && (child = RadixNode_nextChild(node, &byte)) != NULL; ++byte, ++slot) {
+        switch (type) {
+            case radix_node4:
+                ((RadixNode4*)next)->keys[slot] = (uint8_t)byte;
+                ((RadixNode4*)next)->children[slot] = child;
+                break;
+            case radix_node16:
+                ((RadixNode16*)next)->keys[slot] = (uint8_t)byte;
+                ((RadixNode16*)next)->children[slot] = child;
+                break;
+            case radix_node48:
+                ((RadixNode48*)next)->index[byte] = (uint8_t)(slot + 1);
+                ((RadixNode48*)next)->children[slot] = child;
+                break;
+            default:
+                ((RadixNode256*)next)->children[byte] = child;
+                break;
+        }
+    }
+
+    RadixTree_freeNode(self, node);
+    *ref = next;
+    return true;
+}
+
+static bool RadixTree_addChild(RadixTree *const self, RadixNode **const ref, const uint8_t byte, RadixNode *const child) {
+    static const uint32_t capacities[] = { 4, 16, 48, 256 };
+    if ((*ref)->count == capacities[(*ref)->type] && !RadixTree_retype(self, ref, (RadixNodeType)((*ref)->type + 1))) {
+        return false;
+    }
+
+    RadixNode *const node = *ref;
+    switch (node->type) {
+        case radix_node4:
+        case radix_node16: {
+            uint8_t *const keys = (node->type == radix_node4) ? ((RadixNode4*)node)->keys : ((RadixNode16*)node)->keys;
+            RadixNode **const children = (node->type == radix_node4) ? ((RadixNode4*)node)->children : ((RadixNode16*)node)->children;
+            uint32_t at = 0;
+            while (at < node->count && keys[at] < byte) {
+                ++at;
+            }
+            memmove(keys + at + 1, keys + at, node->count - at);
+            memmove(children + at + 1, children + at, (node->count - at) * sizeof(RadixNode*));
+            keys[at] = byte;
+            children[at] = child;
+            break;
+        }
+        case radix_node48: {
+            RadixNode48 *const n = (RadixNode48*)node;
+            // note: removals leave holes, so take the first free slot.
+            uint32_t slot = 0;
+            while (n->children[slot] != NULL) {
+                ++slot;
+            }
+            n->index[byte] = (uint8_t)(slot + 1);
+            n->children[slot] = child;
+            break;
+        }
+        default:
+            ((RadixNode256*)node)->children[byte] = child;
+            break;
+    }
+    ++node->count;
+    return true;
+}
+
+static void RadixNode_removeChild(RadixNode *const node, const uint8_t byte) {
+    switch (node->type) {
+        case radix_node4:
+        case radix_node16: {
+            uint8_t *const keys = (node->type == radix_node4) ? ((RadixNode4*)node)->keys : ((RadixNode16*)node)->keys;
+            RadixNode **const children = (node->type == radix_node4) ? ((RadixNode4*)node)->children : ((RadixNode16*)node)->children;
+            uint32_t at = 0;
+            while (keys[at] != byte) {
+                ++at;
+            }
+            memmove(keys + at, keys + at + 1, node->count - at - 1);
+            memmove(children + at, children + at + 1, (node->count - at - 1) * sizeof(RadixNode*));
+            break;
+        }
+        case radix_node48: {
+            RadixNode48 *const n = (RadixNode48*)node;
+            n->children[n->index[byte] - 1] = NULL;
+            n->index[byte] = 0;
+            break;
+        }
+        default:
+            ((RadixNode256*)node)->children[byte] = NULL;
+            break;
+    }
+    --node->count;
+}
+
+// After a removal: shrinks the node (with some slack, so a key added and removed
+//  at the boundary doesn't resize it every time), or replaces a node left with a
+//  single entry by that entry, merging the prefixes.
+static void RadixTree_shrink(RadixTree *const self, RadixNode **const ref) {
+    RadixNode *const node = *ref;
+    const uint32_t entries = node->count + (node->terminal != NULL);
+    if (entries == 1) {
+        if (node->terminal != NULL) {
+            *ref = Radix_tag(node->terminal);
+            RadixTree_freeNode(self, node);
+            return;
+        }
+
+        uint32_t byte = 0;
+        RadixNode *const child = RadixNode_nextChild(node, &byte);
+        if (!Radix_isLeaf(child)) {
+            uint8_t prefix[PREFIX_MAX];
+            size_t size = n5_min(node->prefixSize, PREFIX_MAX);
+            memcpy(prefix, node->prefix, size);
+            if (size < PREFIX_MAX) {
+                prefix[size++] = (uint8_t)byte;
+            }
+            const size_t kept = n5_min(child->prefixSize, PREFIX_MAX - size);
+            memcpy(prefix + size, child->prefix, kept);
+            memcpy(child->prefix, prefix, size + kept);
+            child->prefixSize += node->prefixSize + 1;
+        }
+        *ref = child;
+        RadixTree_freeNode(self, node);
+        return;
+    }
+
+    // note: a failed shrink just leaves the bigger node in place.
+    if (node->type == radix_node16 && node->count < 3) {
+        (void)RadixTree_retype(self, ref, radix_node4);
+    } else if (node->type == radix_node48 && node->count < 12) {
+        (void)RadixTree_retype(self, ref, radix_node16);
+    } else if (node->type == radix_node256 && node->count < 37) {
+        (void)RadixTree_retype(self, ref, radix_node48);
+    }
+}
+
+static void RadixTree_freeAll(RadixTree *const self, RadixNode *const ref) {
+    if (Radix_isLeaf(ref)) {
+        RadixTree_freeLeaf(self, Radix_leaf(ref));
+        return;
+    }
+    if (ref->terminal != NULL) {
+        RadixTree_freeLeaf(self, ref->terminal);
+    }
+    uint32_t byte = 0;
+    for (RadixNode* child; byte < 256 && (child = RadixNode_nextChild(ref, &byte)) != NULL; ++byte) {
+        RadixTree_freeAll(self, child);
+    }
+    RadixTree_freeNode(self, ref);
+}
+
+void RadixTree_init(RadixTree *const self, Allocator *const owner, const size_t valueSize) {
+    assert(self != NULL);
+    assert(owner != NULL);
+
+    *self = (RadixTree) {
+        .owner = owner,
+        .valueSize = valueSize,
+    };
+}
+
+void RadixTree_deinit(RadixTree *const self) {
+    assert(self != NULL);
+
+    if (self->root != NULL) {
+        RadixTree_freeAll(self, self->root);
+    }
+    self->root = NULL;
+    self->size = 0;
+}
+
+// Returns how many bytes of the node's prefix match 'key' from 'depth'.
+static size_t RadixNode_matchPrefix(const RadixTree *const self, const RadixNode *const node, const cstr key, const size_t depth) {
+    const size_t stored = n5_min(node->prefixSize, PREFIX_MAX);
+    const size_t limit = n5_min(node->prefixSize, key.size - depth);
+    size_t i = 0;
+    while (i < n5_min(stored, limit) && node->prefix[i] == (uint8_t)key.data[depth + i]) {
+        ++i;
+    }
+    if (i == stored && i < limit) {
+        const cstr full = RadixLeaf_key(self, RadixNode_minLeaf(node));
+        while (i < limit && full.data[depth + i] == key.data[depth + i]) {
+            ++i;
+        }
+    }
+    return i;
+}
+
+// note: only compares the stored prefix bytes; the rest are checked at the leaf.
+static inline bool RadixNode_skipPrefix(const RadixNode *const node, const cstr key, size_t *const depth) {
+    if (node->prefixSize == 0) {
+        return true;
+    }
+    const size_t stored = n5_min(node->prefixSize, PREFIX_MAX);
+    if (*depth + node->prefixSize > key.size || memcmp(node->prefix, key.data + *depth, stored) != 0) {
+        return false;
+    }
+    *depth += node->prefixSize;
+    return true;
+}
+
+void* RadixTree_get(const RadixTree *const self, const cstr key) {
+    assert(self != NULL);
+    assert(key.data != NULL || key.size == 0);
+
+    const RadixNode* node = self->root;
+    size_t depth = 0;
+    while (node != NULL) {
+        if (Radix_isLeaf(node)) {
+            const RadixLeaf *const leaf = Radix_leaf(node);
+            return Radix_keyEquals(RadixLeaf_key(self, leaf), key) ? RadixLeaf_value(leaf) : NULL;
+        }
+        if (!RadixNode_skipPrefix(node, key, &depth)) {
+            return NULL;
+        }
+        if (depth == key.size) {
+            const RadixLeaf *const leaf = node->terminal;
+            return (leaf != NULL && Radix_keyEquals(RadixLeaf_key(self, leaf), key)) ? RadixLeaf_value(leaf) : NULL;
+        }
+        RadixNode *const *const child = RadixNode_findChild((RadixNode*)node, (uint8_t)key.data[depth++]);
+        node = (child != NULL) ? *child : NULL;
+    }
+    return NULL;
+}
+
+// Hangs 'leaf' off a fresh node at 'depth': as its terminal if the key ends there.
+static void RadixNode_place(RadixTree *const self, RadixNode **const ref, RadixLeaf *const leaf, const cstr key, const size_t depth) {
+    if (key.size == depth) {
+        (*ref)->terminal = leaf;
+    } else {
+        // note: a fresh node has room for both of its entries.
+        (void)RadixTree_addChild(self, ref, (uint8_t)key.data[depth], Radix_tag(leaf));
+    }
+}
+
+void* RadixTree_insert(RadixTree *const self, const cstr key) {
+    assert(self != NULL);
+    assert(key.data != NULL || key.size == 0);
+
+    RadixNode** ref = &self->root;
+    size_t depth = 0;
+    for (;;) {
+        RadixNode *const node = *ref;
+        if (node == NULL) {
+            RadixLeaf *const leaf = RadixTree_newLeaf(self, key);
+            if (leaf == NULL) {
+                return NULL;
+            }
+            *ref = Radix_tag(leaf);
+            ++self->size;
+            return RadixLeaf_value(leaf);
+        }
+
+        if (Radix_isLeaf(node)) {
+            RadixLeaf *const existing = Radix_leaf(node);
+            const cstr existingKey = RadixLeaf_key(self, existing);
+            if (Radix_keyEquals(existingKey, key)) {
+                return RadixLeaf_value(existing);
+            }
+
+            // Split the leaf: a new node holds the bytes both keys share.
+            size_t common = 0;
+            const size_t limit = n5_min(existingKey.size, key.size) - depth;
+            while (common < limit && existingKey.data[depth + common] == key.data[depth + common]) {
+                ++common;
+            }
+
+            RadixLeaf *const leaf = RadixTree_newLeaf(self, key);
+            RadixNode* split = RadixTree_newNode(self, radix_node4);
+            if (leaf == NULL || split == NULL) {
+                if (leaf != NULL) {
+                    RadixTree_freeLeaf(self, leaf);
+                }
+                if (split != NULL) {
+                    RadixTree_freeNode(self, split);
+                }
+                return NULL;
+            }
+            split->prefixSize = (uint32_t)common;
+            memcpy(split->prefix, key.data + depth, n5_min(common, PREFIX_MAX));
+            RadixNode_place(self, &split, existing, existingKey, depth + common);
+            RadixNode_place(self, &split, leaf, key, depth + common);
+            *ref = split;
+            ++self->size;
+            return RadixLeaf_value(leaf);
+        }
+
+        if (node->prefixSize > 0) {
+            const size_t matched = RadixNode_matchPrefix(self, node, key, depth);
+            if (matched < node->prefixSize) {
+                // Split the prefix: a new node takes the matching part, and the
+                //  old one keeps what follows the byte where they differ.
+                RadixLeaf *const leaf = RadixTree_newLeaf(self, key);
+                RadixNode* split = RadixTree_newNode(self, radix_node4);
+                if (leaf == NULL || split == NULL) {
+                    if (leaf != NULL) {
+                        RadixTree_freeLeaf(self, leaf);
+                    }
+                    if (split != NULL) {
+                        RadixTree_freeNode(self, split);
+                    }
+                    return NULL;
+                }
+                split->prefixSize = (uint32_t)matched;
+                memcpy(split->prefix, node->prefix, n5_min(matched, PREFIX_MAX));
+
+                const size_t rest = node->prefixSize - matched - 1;
+                uint8_t branch;
+                if (node->prefixSize <= PREFIX_MAX) {
+                    branch = node->prefix[matched];
+                    memmove(node->prefix, node->prefix + matched + 1, rest);
+                } else {
+                    const cstr full = RadixLeaf_key(self, RadixNode_minLeaf(node));
+                    branch = (uint8_t)full.data[depth + matched];
+                    memcpy(node->prefix, full.data + depth + matched + 1, n5_min(rest, PREFIX_MAX));
+                }
+                node->prefixSize = (uint32_t)rest;
+
+                (void)RadixTree_addChild(self, &split, branch, node);
+                RadixNode_place(self, &split, leaf, key, depth + matched);
+                *ref = split;
+                ++self->size;
+                return RadixLeaf_value(leaf);
+            }
+            depth += node->prefixSize;
+        }
+
+        if (depth == key.size) {
+            if (node->terminal != NULL) {
+                return RadixLeaf_value(node->terminal);
+            }
+            RadixLeaf *const leaf = RadixTree_newLeaf(self, key);
+            if (leaf == NULL) {
+                return NULL;
+            }
+            node->terminal = leaf;
+            ++self->size;
+            return RadixLeaf_value(leaf);
+        }
+
+        RadixNode **const child = RadixNode_findChild(node, (uint8_t)key.data[depth]);
+        if (child != NULL) {
+            ref = child;
+            ++depth;
+            continue;
+        }
+
+        RadixLeaf *const leaf = RadixTree_newLeaf(self, key);
+        if (leaf == NULL) {
+            return NULL;
+        }
+        if (!RadixTree_addChild(self, ref, (uint8_t)key.data[depth], Radix_tag(leaf))) {
+            RadixTree_freeLeaf(self, leaf);
+            return NULL;
+        }
+        ++self->size;
+        return RadixLeaf_value(leaf);
+    }
+}
+
+bool RadixTree_remove(RadixTree *const self, const cstr key) {
+    assert(self != NULL);
+    assert(key.data != NULL || key.size == 0);
+
+    RadixNode** ref = &self->root;
+    if (*ref == NULL) {
+        return false;
+    }
+    if (Radix_isLeaf(*ref)) {
+        RadixLeaf *const leaf = Radix_leaf(*ref);
+        if (!Radix_keyEquals(RadixLeaf_key(self, leaf), key)) {
+            return false;
+        }
+        RadixTree_freeLeaf(self, leaf);
+        *ref = NULL;
+        --self->size;
+        return true;
+    }
+
+    size_t depth = 0;
+    for (;;) {
+        RadixNode *const node = *ref;
+        if (!RadixNode_skipPrefix(node, key, &depth)) {
+            return false;
+        }
+
+        if (depth == key.size) {
+            RadixLeaf *const leaf = node->terminal;
+            if (leaf == NULL || !Radix_keyEquals(RadixLeaf_key(self, leaf), key)) {
+                return false;
+            }
+            RadixTree_freeLeaf(self, leaf);
+            node->terminal = NULL;
+            RadixTree_shrink(self, ref);
+            --self->size;
+            return true;
+        }
+
+        const uint8_t byte = (uint8_t)key.data[depth];
+        RadixNode **const child = RadixNode_findChild(node, byte);
+        if (child == NULL) {
+            return false;
+        }
+        if (Radix_isLeaf(*child)) {
+            RadixLeaf *const leaf = Radix_leaf(*child);
+            if (!Radix_keyEquals(RadixLeaf_key(self, leaf), key)) {
+                return false;
+            }
+            RadixTree_freeLeaf(self, leaf);
+            RadixNode_removeChild(node, byte);
+            RadixTree_shrink(self, ref);
+            --self->size;
+            return true;
+        }
+        ref = child;
+        ++depth;
+    }
+}
+
+void* RadixTree_longestPrefix(const RadixTree *const self, const cstr key, size_t *const matched) {
+    assert(self != NULL);
+    assert(key.data != NULL || key.size == 0);
+
+    // Candidates are checked as they're found, but only from where the last
+    //  one left off: the path up to it is known to match.
+    const RadixLeaf* best = NULL;
+    size_t verified = 0;
+    const RadixNode* node = self->root;
+    size_t depth = 0;
+    while (node != NULL) {
+        const RadixLeaf* candidate = NULL;
+        if (Radix_isLeaf(node)) {
+            candidate = Radix_leaf(node);
+            node = NULL;
+        } else {
+            if (!RadixNode_skipPrefix(node, key, &depth)) {
+                break;
+            }
+            candidate = node->terminal;
+            if (depth == key.size) {
+                node = NULL;
+            } else {
+                RadixNode *const *const child = RadixNode_findChild((RadixNode*)node, (uint8_t)key.data[depth++]);
+                node = (child != NULL) ? *child : NULL;
+            }
+        }
+
+        if (candidate != NULL) {
+            const cstr candidateKey = RadixLeaf_key(self, candidate);
+            if (candidateKey.size > key.size
+                || memcmp(candidateKey.data + verified, key.data + verified, candidateKey.size - verified) != 0) {
+                // note: a skipped prefix byte didn't match, so nothing deeper will either.
+                break;
+            }
+            best = candidate;
+            verified = candidateKey.size;
+        }
+    }
+
+    if (best == NULL) {
+        return NULL;
+    }
+    if (matched != NULL) {
+        *matched = best->size;
+    }
+    return RadixLeaf_value(best);
+}
+
+static inline bool RadixWalk_pastUpper(const RadixWalk *const self, const cstr key) {
+    if (self->upperIsPrefix) {
+        return !Radix_startsWith(key, self->upper) && Radix_compare(key, self->upper) > 0;
+    }
+    return Radix_compare(key, self->upper) >= 0;
+}
+
+// Visits the subtree at 'ref' in order. 'lowTight' and 'highTight' say whether
+//  the path so far still equals the start of 'lower' / 'upper'; once it doesn't,
+//  the whole subtree is known to be inside that bound. Returns false to stop.
+static bool RadixWalk_visit(const RadixWalk *const self, const RadixNode *const ref, size_t depth, bool lowTight, bool highTight) {
+    if (Radix_isLeaf(ref)) {
+        const RadixLeaf *const leaf = Radix_leaf(ref);
+        const cstr key = RadixLeaf_key(self->tree, leaf);
+        if (lowTight && Radix_compare(key, self->lower) < 0) {
+            return true;
+        }
+        if (highTight && RadixWalk_pastUpper(self, key)) {
+            return false;
+        }
+        return self->fn(self->ctx, key, RadixLeaf_value(leaf));
+    }
+
+    if ((lowTight || highTight) && ref->prefixSize > 0) {
+        const cstr path = RadixLeaf_key(self->tree, RadixNode_minLeaf(ref));
+        for (size_t i = depth; i < depth + ref->prefixSize && (lowTight || highTight); ++i) {
+            const uint8_t byte = (uint8_t)path.data[i];
+            if (lowTight) {
+                if (i >= self->lower.size || byte > (uint8_t)self->lower.data[i]) {
+                    lowTight = false;
+                } else if (byte < (uint8_t)self->lower.data[i]) {
+                    return true;
+                }
+            }
+            if (highTight) {
+                if (i >= self->upper.size) {
+                    if (!self->upperIsPrefix) {
+                        return false;
+                    }
+                    highTight = false;
+                } else if (byte < (uint8_t)self->upper.data[i]) {
+                    highTight = false;
+                } else if (byte > (uint8_t)self->upper.data[i]) {
+                    return false;
+                }
+            }
+        }
+    }
+    depth += ref->prefixSize;
+
+    if (ref->terminal != NULL && !RadixWalk_visit(self, Radix_tag(ref->terminal), depth, lowTight, highTight)) {
+        return false;
+    }
+
+    // note: a tight lower bound lets the scan start at its next byte.
+    uint32_t byte = (lowTight && depth < self->lower.size) ? (uint8_t)self->lower.data[depth] : 0;
+    for (const RadixNode* child; byte < 256 && (child = RadixNode_nextChild(ref, &byte)) != NULL; ++byte) {
+        bool childLow = lowTight;
+        bool childHigh = highTight;
+        if (lowTight && (depth >= self->lower.size || byte > (uint8_t)self->lower.data[depth])) {
+            childLow = false;
+        }
+        if (highTight) {
+            if (depth >= self->upper.size) {
+                if (!self->upperIsPrefix) {
+                    return false;
+                }
+                childHigh = false;
+            } else if (byte > (uint8_t)self->upper.data[depth]) {
+                return false;
+            } else if (byte < (uint8_t)self->upper.data[depth]) {
+                childHigh = false;
+            }
+        }
+        if (!RadixWalk_visit(self, child, depth + 1, childLow, childHigh)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RadixTree_walk(const RadixTree *const self, const cstr lower, const cstr upper, const bool bounded, const bool upperIsPrefix, const RadixVisitFn fn, void *const ctx) {
+    assert(self != NULL);
+    assert(fn != NULL);
+    assert(lower.data != NULL || lower.size == 0);
+    assert(upper.data != NULL || upper.size == 0);
+
+    if (self->root == NULL) {
+        return;
+    }
+    const RadixWalk walk = {
+        .tree = self,
+        .lower = lower,
+        .upper = upper,
+        .upperIsPrefix = upperIsPrefix,
+        .fn = fn,
+        .ctx = ctx,
+    };
+    RadixWalk_visit(&walk, self->root, 0, true, bounded);
+}
+
+void RadixTree_range(const RadixTree *const self, const cstr lower, const cstr upper, const RadixVisitFn fn, void *const ctx) {
+    RadixTree_walk(self, lower, upper, true, false, fn, ctx);
+}
+
+void RadixTree_rangeFrom(const RadixTree *const self, const cstr lower, const RadixVisitFn fn, void *const ctx) {
+    RadixTree_walk(self, lower, cstr_literal(""), false, false, fn, ctx);
+}
+
+void RadixTree_withPrefix(const RadixTree *const self, const cstr prefix, const RadixVisitFn fn, void *const ctx) {
+    RadixTree_walk(self, prefix, prefix, true, true, fn, ctx);
+}
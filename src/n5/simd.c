@@ -0,0 +1,974 @@
+#include "n5/simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define SIMD_SSE2 0
+#endif
+
+// note: wider kernels are compiled per-function with target attributes and only
+//  selected after checking the CPU, so the rest of the library stays baseline.
+#if SIMD_SSE2 && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_DISPATCH 1
+#include <immintrin.h>
+#define SIMD_TARGET(features) __attribute__((target(features)))
+#else
+#define SIMD_DISPATCH 0
+#endif
+
+static inline int simd_sign(const uint8_t a, const uint8_t b) {
+    return (a < b) ? -1 : 1;
+}
+
+static inline uint8_t simd_lower(const uint8_t c) {
+    return ((uint8_t)(c - 'A') < 26) ? (uint8_t)(c | 0x20) : c;
+}
+
+// note: -1 for anything that isn't a hex digit. Each range becomes a mask
+//  rather than a branch, which random input would keep mispredicting.
+static inline int32_t simd_hexValue(const uint8_t c) {
+    const uint8_t lower = c | 0x20;
+    const int32_t isDigit = -(int32_t)((uint8_t)(c - '0') < 10);
+    const int32_t isLetter = -(int32_t)((uint8_t)(lower - 'a') < 6);
+    return (isDigit & (c - '0')) | (isLetter & (lower - 'a' + 10)) | ~(isDigit | isLetter);
+}
+
+static inline int32_t simd_base64Value(const uint8_t c, const bool url) {
+    const int32_t isUpper = -(int32_t)((uint8_t)(c - 'A') < 26);
+    const int32_t isLower = -(int32_t)((uint8_t)(c - 'a') < 26);
+    const int32_t isDigit = -(int32_t)((uint8_t)(c - '0') < 10);
+    const int32_t isPlus = -(int32_t)(c == (url ? '-' : '+'));
+    const int32_t isSlash = -(int32_t)(c == (url ? '_' : '/'));
+    return (isUpper & (c - 'A')) | (isLower & (c - 'a' + 26)) | (isDigit & (c - '0' + 52))
+        | (isPlus & 62) | (isSlash & 63) | ~(isUpper | isLower | isDigit | isPlus | isSlash);
+}
+
+static const char simd_hexDigits[2][17] = { "0123456789abcdef", "0123456789ABCDEF" };
+static const char simd_base64Chars[2][65] = {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_",
+};
+
+// note: equal and findByte use libc at every level. memcmp and memchr are
+//  already vectorised (and dispatched) by the C library, and measured faster
+//  than hand-written SSE2/AVX2/AVX-512 loops at nearly every size.
+static bool scalar_equal(const void *const a, const void *const b, const size_t size) {
+    return memcmp(a, b, size) == 0;
+}
+
+static int scalar_compare(const void *const a, const void *const b, const size_t size) {
+    const int result = memcmp(a, b, size);
+    return (result > 0) - (result < 0);
+}
+
+static void scalar_fill(void *const dest, const size_t count, const void *const value, const size_t width) {
+    if (width == 1) {
+        memset(dest, *(const uint8_t*)value, count);
+        return;
+    }
+    uint8_t* cursor = dest;
+    for (size_t i = 0; i < count; ++i, cursor += width) {
+        memcpy(cursor, value, width);
+    }
+}
+
+static void scalar_reverseRange(uint8_t* start, uint8_t* end) {
+    while (start + 1 < end) {
+        const uint8_t tmp = *start;
+        *(start++) = *(--end);
+        *end = tmp;
+    }
+}
+
+static void scalar_reverse(void *const data, const size_t size) {
+    scalar_reverseRange(data, (uint8_t*)data + size);
+}
+
+static size_t scalar_findByte(const void *const data, const size_t size, const uint8_t byte) {
+    const uint8_t *const found = memchr(data, byte, size);
+    return (found != NULL) ? (size_t)(found - (const uint8_t*)data) : size;
+}
+
+static size_t scalar_countByte(const void *const data, const size_t size, const uint8_t byte) {
+    const uint8_t *const bytes = data;
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += (bytes[i] == byte);
+    }
+    return count;
+}
+
+static void scalar_matchBlock(const void *const block, const uint8_t *const needles, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    for (size_t n = 0; n < count; ++n) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            mask |= (uint64_t)(bytes[i] == needles[n]) << i;
+        }
+        masks[n] = mask;
+    }
+}
+
+static void scalar_classifyBlock(const void *const block, const uint8_t *const tables, const uint8_t *const classes, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    uint8_t found[64];
+    for (size_t i = 0; i < 64; ++i) {
+        found[i] = tables[bytes[i] & 0x0f] & tables[16 + (bytes[i] >> 4)];
+    }
+    for (size_t n = 0; n < count; ++n) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            mask |= (uint64_t)((found[i] & classes[n]) != 0) << i;
+        }
+        masks[n] = mask;
+    }
+}
+
+static void scalar_flipCase(void *const data, const size_t size, const uint8_t first) {
+    uint8_t *const bytes = data;
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] ^= ((uint8_t)(bytes[i] - first) < 26) ? 0x20 : 0;
+    }
+}
+
+static size_t scalar_mismatchIgnoreCase(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    for (size_t i = 0; i < size; ++i) {
+        if (x[i] != y[i] && simd_lower(x[i]) != simd_lower(y[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+static void scalar_hexEncode(void *const dest, const void *const src, const size_t size, const bool upper) {
+    char *const out = dest;
+    const uint8_t *const bytes = src;
+    const char *const digits = simd_hexDigits[upper];
+    for (size_t i = 0; i < size; ++i) {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0f];
+    }
+}
+
+static size_t scalar_hexDecode(void *const dest, const void *const src, const size_t size) {
+    uint8_t *const out = dest;
+    const uint8_t *const chars = src;
+    size_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        const int32_t high = simd_hexValue(chars[i]);
+        const int32_t low = simd_hexValue(chars[i + 1]);
+        if ((high | low) < 0) {
+            break;
+        }
+        out[i / 2] = (uint8_t)((high << 4) | low);
+    }
+    return i;
+}
+
+static void scalar_base64Encode(void *const dest, const void *const src, const size_t size, const bool url) {
+    char* out = dest;
+    const uint8_t *const bytes = src;
+    const char *const chars = simd_base64Chars[url];
+    for (size_t i = 0; i + 3 <= size; i += 3) {
+        const uint32_t group = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | bytes[i + 2];
+        out[0] = chars[group >> 18];
+        out[1] = chars[(group >> 12) & 0x3f];
+        out[2] = chars[(group >> 6) & 0x3f];
+        out[3] = chars[group & 0x3f];
+        out += 4;
+    }
+}
+
+static size_t scalar_base64Decode(void *const dest, const void *const src, const size_t size, const bool url) {
+    uint8_t* out = dest;
+    const uint8_t *const chars = src;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        const int32_t a = simd_base64Value(chars[i], url);
+        const int32_t b = simd_base64Value(chars[i + 1], url);
+        const int32_t c = simd_base64Value(chars[i + 2], url);
+        const int32_t d = simd_base64Value(chars[i + 3], url);
+        if ((a | b | c | d) < 0) {
+            break;
+        }
+        const uint32_t group = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+        out[0] = (uint8_t)(group >> 16);
+        out[1] = (uint8_t)(group >> 8);
+        out[2] = (uint8_t)group;
+        out += 3;
+    }
+    return i;
+}
+
+static const SimdKernels ScalarKernels = {
+    .level = simd_scalar,
+    .equal = scalar_equal,
+    .compare = scalar_compare,
+    .fill = scalar_fill,
+    .reverse = scalar_reverse,
+    .findByte = scalar_findByte,
+    .countByte = scalar_countByte,
+    .matchBlock = scalar_matchBlock,
+    .classifyBlock = scalar_classifyBlock,
+    .flipCase = scalar_flipCase,
+    .mismatchIgnoreCase = scalar_mismatchIgnoreCase,
+    .hexEncode = scalar_hexEncode,
+    .hexDecode = scalar_hexDecode,
+    .base64Encode = scalar_base64Encode,
+    .base64Decode = scalar_base64Decode,
+};
+
+#if SIMD_SSE2
+
+static int sse2_compare(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(x + i)), _mm_loadu_si128((const __m128i*)(y + i)));
+        const uint32_t diff = ~(uint32_t)_mm_movemask_epi8(eq) & 0xffff;
+        if (diff != 0) {
+            const size_t j = i + n5_ctz32(diff);
+            return simd_sign(x[j], y[j]);
+        }
+    }
+    for (; i < size; ++i) {
+        if (x[i] != y[i]) {
+            return simd_sign(x[i], y[i]);
+        }
+    }
+    return 0;
+}
+
+static __m128i sse2_broadcast(const void *const value, const size_t width) {
+    switch (width) {
+        case 1: return _mm_set1_epi8(*(const int8_t*)value);
+        case 2: { int16_t v; memcpy(&v, value, 2); return _mm_set1_epi16(v); }
+        case 4: { int32_t v; memcpy(&v, value, 4); return _mm_set1_epi32(v); }
+        default: { int64_t v; memcpy(&v, value, 8); return _mm_set1_epi64x(v); }
+    }
+}
+
+static void sse2_fill(void *const dest, const size_t count, const void *const value, const size_t width) {
+    if (width != 1 && width != 2 && width != 4 && width != 8) {
+        scalar_fill(dest, count, value, width);
+        return;
+    }
+
+    // note: 16 is a multiple of every supported width, so the pattern stays in phase.
+    const __m128i pattern = sse2_broadcast(value, width);
+    uint8_t *const bytes = dest;
+    const size_t size = count * width;
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm_storeu_si128((__m128i*)(bytes + i), pattern);
+    }
+    scalar_fill(bytes + i, (size - i) / width, value, width);
+}
+
+static inline __m128i sse2_reverse16(__m128i x) {
+    x = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static void sse2_reverse(void *const data, const size_t size) {
+    uint8_t* start = data;
+    uint8_t* end = start + size;
+    while (end - start >= 32) {
+        const __m128i head = _mm_loadu_si128((const __m128i*)start);
+        const __m128i tail = _mm_loadu_si128((const __m128i*)(end - 16));
+        _mm_storeu_si128((__m128i*)start, sse2_reverse16(tail));
+        _mm_storeu_si128((__m128i*)(end - 16), sse2_reverse16(head));
+        start += 16;
+        end -= 16;
+    }
+    scalar_reverseRange(start, end);
+}
+
+static size_t sse2_countByte(const void *const data, const size_t size, const uint8_t byte) {
+    const uint8_t *const bytes = data;
+    const __m128i needle = _mm_set1_epi8((char)byte);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 16 <= size) {
+        // note: byte lanes overflow after 255 matches, so flush through psadbw periodically.
+        const size_t blocks = n5_min((size - i) / 16, 255);
+        __m128i acc = _mm_setzero_si128();
+        for (size_t b = 0; b < blocks; ++b, i += 16) {
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(bytes + i)), needle));
+        }
+
+        uint64_t sums[2];
+        _mm_storeu_si128((__m128i*)sums, _mm_sad_epu8(acc, _mm_setzero_si128()));
+        count += sums[0] + sums[1];
+    }
+    return count + scalar_countByte(bytes + i, size - i, byte);
+}
+
+static void sse2_matchBlock(const void *const block, const uint8_t *const needles, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    const __m128i b0 = _mm_loadu_si128((const __m128i*)bytes);
+    const __m128i b1 = _mm_loadu_si128((const __m128i*)(bytes + 16));
+    const __m128i b2 = _mm_loadu_si128((const __m128i*)(bytes + 32));
+    const __m128i b3 = _mm_loadu_si128((const __m128i*)(bytes + 48));
+    for (size_t n = 0; n < count; ++n) {
+        const __m128i needle = _mm_set1_epi8((char)needles[n]);
+        masks[n] = (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(b0, needle))
+            | ((uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(b1, needle)) << 16)
+            | ((uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(b2, needle)) << 32)
+            | ((uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(b3, needle)) << 48);
+    }
+}
+
+// 0x20 in every byte within ['first', 'first' + 25]: the offset moves that
+//  range to the bottom of the signed byte range, so one compare finds it.
+static inline __m128i sse2_caseBits(const __m128i x, const __m128i offset) {
+    const __m128i inRange = _mm_cmplt_epi8(_mm_add_epi8(x, offset), _mm_set1_epi8(-128 + 26));
+    return _mm_and_si128(inRange, _mm_set1_epi8(0x20));
+}
+
+static void sse2_flipCase(void *const data, const size_t size, const uint8_t first) {
+    uint8_t *const bytes = data;
+    const __m128i offset = _mm_set1_epi8((char)(0x80 - first));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(bytes + i));
+        _mm_storeu_si128((__m128i*)(bytes + i), _mm_xor_si128(x, sse2_caseBits(x, offset)));
+    }
+    scalar_flipCase(bytes + i, size - i, first);
+}
+
+static size_t sse2_mismatchIgnoreCase(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    const __m128i offset = _mm_set1_epi8((char)(0x80 - 'A'));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(x + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(y + i));
+        const __m128i eq = _mm_cmpeq_epi8(_mm_or_si128(va, sse2_caseBits(va, offset)), _mm_or_si128(vb, sse2_caseBits(vb, offset)));
+        const uint32_t diff = ~(uint32_t)_mm_movemask_epi8(eq) & 0xffff;
+        if (diff != 0) {
+            return i + n5_ctz32(diff);
+        }
+    }
+    return i + scalar_mismatchIgnoreCase(x + i, y + i, size - i);
+}
+
+// '0' + n, or the letter for n > 9: 'letters' is ('a' or 'A') - '0' - 10 in every byte.
+static inline __m128i sse2_hexDigits(const __m128i nibbles, const __m128i letters) {
+    const __m128i isLetter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), _mm_and_si128(isLetter, letters));
+}
+
+static void sse2_hexEncode(void *const dest, const void *const src, const size_t size, const bool upper) {
+    char *const out = dest;
+    const uint8_t *const bytes = src;
+    const __m128i letters = _mm_set1_epi8((char)((upper ? 'A' : 'a') - '0' - 10));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(bytes + i));
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+        const __m128i low = _mm_and_si128(x, nibble);
+        _mm_storeu_si128((__m128i*)(out + 2 * i), sse2_hexDigits(_mm_unpacklo_epi8(high, low), letters));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), sse2_hexDigits(_mm_unpackhi_epi8(high, low), letters));
+    }
+    scalar_hexEncode(out + 2 * i, bytes + i, size - i, upper);
+}
+
+// The value of each hex digit; '*valid' gets 0xff for bytes that are digits.
+//  The ranges are found with the same signed-offset compare as sse2_caseBits.
+static inline __m128i sse2_hexValues(const __m128i c, __m128i *const valid) {
+    const __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    const __m128i isDigit = _mm_cmplt_epi8(_mm_add_epi8(c, _mm_set1_epi8((char)(0x80 - '0'))), _mm_set1_epi8(-128 + 10));
+    const __m128i isLetter = _mm_cmplt_epi8(_mm_add_epi8(lower, _mm_set1_epi8((char)(0x80 - 'a'))), _mm_set1_epi8(-128 + 6));
+    *valid = _mm_or_si128(isDigit, isLetter);
+    return _mm_or_si128(
+        _mm_and_si128(isDigit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+        _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))
+    );
+}
+
+// Joins each pair of digit values (high nibble in the even byte) into one byte
+//  per 16-bit lane.
+static inline __m128i sse2_hexJoin(const __m128i values) {
+    return _mm_and_si128(_mm_or_si128(_mm_slli_epi16(values, 4), _mm_srli_epi16(values, 8)), _mm_set1_epi16(0xff));
+}
+
+static size_t sse2_hexDecode(void *const dest, const void *const src, const size_t size) {
+    uint8_t *const out = dest;
+    const uint8_t *const chars = src;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m128i valid0;
+        __m128i valid1;
+        const __m128i v0 = sse2_hexValues(_mm_loadu_si128((const __m128i*)(chars + i)), &valid0);
+        const __m128i v1 = sse2_hexValues(_mm_loadu_si128((const __m128i*)(chars + i + 16)), &valid1);
+        // note: the scalar loop below finds the exact pair.
+        if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(out + i / 2), _mm_packus_epi16(sse2_hexJoin(v0), sse2_hexJoin(v1)));
+    }
+    return i + scalar_hexDecode(out + i / 2, chars + i, size - i);
+}
+
+// note: SSE2 has no byte shuffle, but nearly every CPU that stops at this level
+//  has SSSE3's (checked once by n5_simd_detect); the rest look bytes up one by one.
+#if SIMD_DISPATCH
+static bool simd_ssse3 = false;
+
+SIMD_TARGET("ssse3") static void ssse3_classifyBlock(const void *const block, const uint8_t *const tables, const uint8_t *const classes, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    const __m128i low = _mm_loadu_si128((const __m128i*)tables);
+    const __m128i high = _mm_loadu_si128((const __m128i*)(tables + 16));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    __m128i found[4];
+    for (size_t i = 0; i < 4; ++i) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(bytes + i * 16));
+        found[i] = _mm_and_si128(
+            _mm_shuffle_epi8(low, _mm_and_si128(x, nibble)),
+            _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi16(x, 4), nibble)));
+    }
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t n = 0; n < count; ++n) {
+        const __m128i wanted = _mm_set1_epi8((char)classes[n]);
+        uint64_t miss = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            miss |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(found[i], wanted), zero)) << (i * 16);
+        }
+        masks[n] = ~miss;
+    }
+}
+#endif
+
+static void sse2_classifyBlock(const void *const block, const uint8_t *const tables, const uint8_t *const classes, const size_t count, uint64_t *const masks) {
+#if SIMD_DISPATCH
+    if (simd_ssse3) {
+        ssse3_classifyBlock(block, tables, classes, count, masks);
+        return;
+    }
+#endif
+    scalar_classifyBlock(block, tables, classes, count, masks);
+}
+
+static const SimdKernels Sse2Kernels = {
+    .level = simd_sse2,
+    .equal = scalar_equal,
+    .compare = sse2_compare,
+    .fill = sse2_fill,
+    .reverse = sse2_reverse,
+    .findByte = scalar_findByte,
+    .countByte = sse2_countByte,
+    .matchBlock = sse2_matchBlock,
+    .classifyBlock = sse2_classifyBlock,
+    .flipCase = sse2_flipCase,
+    .mismatchIgnoreCase = sse2_mismatchIgnoreCase,
+    .hexEncode = sse2_hexEncode,
+    .hexDecode = sse2_hexDecode,
+    // note: base64 needs a byte shuffle (SSSE3) to vectorize well.
+    .base64Encode = scalar_base64Encode,
+    .base64Decode = scalar_base64Decode,
+};
+
+#endif // SIMD_SSE2
+
+#if SIMD_DISPATCH
+
+SIMD_TARGET("avx2") static int avx2_compare(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(x + i)), _mm256_loadu_si256((const __m256i*)(y + i)));
+        const uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(eq);
+        if (diff != 0) {
+            const size_t j = i + n5_ctz32(diff);
+            return simd_sign(x[j], y[j]);
+        }
+    }
+    return sse2_compare(x + i, y + i, size - i);
+}
+
+SIMD_TARGET("avx2") static void avx2_fill(void *const dest, const size_t count, const void *const value, const size_t width) {
+    if (width != 1 && width != 2 && width != 4 && width != 8) {
+        scalar_fill(dest, count, value, width);
+        return;
+    }
+
+    const __m128i half = sse2_broadcast(value, width);
+    const __m256i pattern = _mm256_broadcastsi128_si256(half);
+    uint8_t *const bytes = dest;
+    const size_t size = count * width;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        _mm256_storeu_si256((__m256i*)(bytes + i), pattern);
+    }
+    sse2_fill(bytes + i, (size - i) / width, value, width);
+}
+
+SIMD_TARGET("avx2") static inline __m256i avx2_reverse32(const __m256i x) {
+    const __m256i lanes = _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+        15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+    ));
+    return _mm256_permute2x128_si256(lanes, lanes, 0x01);
+}
+
+SIMD_TARGET("avx2") static void avx2_reverse(void *const data, const size_t size) {
+    uint8_t* start = data;
+    uint8_t* end = start + size;
+    while (end - start >= 64) {
+        const __m256i head = _mm256_loadu_si256((const __m256i*)start);
+        const __m256i tail = _mm256_loadu_si256((const __m256i*)(end - 32));
+        _mm256_storeu_si256((__m256i*)start, avx2_reverse32(tail));
+        _mm256_storeu_si256((__m256i*)(end - 32), avx2_reverse32(head));
+        start += 32;
+        end -= 32;
+    }
+    sse2_reverse(start, (size_t)(end - start));
+}
+
+SIMD_TARGET("avx2") static size_t avx2_countByte(const void *const data, const size_t size, const uint8_t byte) {
+    const uint8_t *const bytes = data;
+    const __m256i needle = _mm256_set1_epi8((char)byte);
+    size_t count = 0;
+    size_t i = 0;
+    while (i + 32 <= size) {
+        const size_t blocks = n5_min((size - i) / 32, 255);
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t b = 0; b < blocks; ++b, i += 32) {
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(bytes + i)), needle));
+        }
+
+        uint64_t sums[4];
+        _mm256_storeu_si256((__m256i*)sums, _mm256_sad_epu8(acc, _mm256_setzero_si256()));
+        count += sums[0] + sums[1] + sums[2] + sums[3];
+    }
+    return count + sse2_countByte(bytes + i, size - i, byte);
+}
+
+SIMD_TARGET("avx2") static void avx2_matchBlock(const void *const block, const uint8_t *const needles, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    const __m256i low = _mm256_loadu_si256((const __m256i*)bytes);
+    const __m256i high = _mm256_loadu_si256((const __m256i*)(bytes + 32));
+    for (size_t n = 0; n < count; ++n) {
+        const __m256i needle = _mm256_set1_epi8((char)needles[n]);
+        masks[n] = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle))
+            | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)) << 32);
+    }
+}
+
+SIMD_TARGET("avx2") static void avx2_classifyBlock(const void *const block, const uint8_t *const tables, const uint8_t *const classes, const size_t count, uint64_t *const masks) {
+    const uint8_t *const bytes = block;
+    const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tables));
+    const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tables + 16)));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i found[2];
+    for (size_t half = 0; half < 2; ++half) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(bytes + half * 32));
+        found[half] = _mm256_and_si256(
+            _mm256_shuffle_epi8(low, _mm256_and_si256(x, nibble)),
+            _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t n = 0; n < count; ++n) {
+        const __m256i wanted = _mm256_set1_epi8((char)classes[n]);
+        const uint32_t lowMiss = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(found[0], wanted), zero));
+        const uint32_t highMiss = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(found[1], wanted), zero));
+        masks[n] = ~((uint64_t)lowMiss | ((uint64_t)highMiss << 32));
+    }
+}
+
+SIMD_TARGET("avx2") static inline __m256i avx2_caseBits(const __m256i x, const __m256i offset) {
+    const __m256i inRange = _mm256_cmpgt_epi8(_mm256_set1_epi8(-128 + 26), _mm256_add_epi8(x, offset));
+    return _mm256_and_si256(inRange, _mm256_set1_epi8(0x20));
+}
+
+SIMD_TARGET("avx2") static void avx2_flipCase(void *const data, const size_t size, const uint8_t first) {
+    uint8_t *const bytes = data;
+    const __m256i offset = _mm256_set1_epi8((char)(0x80 - first));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        _mm256_storeu_si256((__m256i*)(bytes + i), _mm256_xor_si256(x, avx2_caseBits(x, offset)));
+    }
+    sse2_flipCase(bytes + i, size - i, first);
+}
+
+SIMD_TARGET("avx2") static size_t avx2_mismatchIgnoreCase(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    const __m256i offset = _mm256_set1_epi8((char)(0x80 - 'A'));
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(x + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(y + i));
+        const __m256i eq = _mm256_cmpeq_epi8(_mm256_or_si256(va, avx2_caseBits(va, offset)), _mm256_or_si256(vb, avx2_caseBits(vb, offset)));
+        const uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(eq);
+        if (diff != 0) {
+            return i + n5_ctz32(diff);
+        }
+    }
+    return i + sse2_mismatchIgnoreCase(x + i, y + i, size - i);
+}
+
+SIMD_TARGET("avx2") static inline __m256i avx2_hexDigits(const __m256i nibbles, const __m256i letters) {
+    const __m256i isLetter = _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), _mm256_and_si256(isLetter, letters));
+}
+
+SIMD_TARGET("avx2") static void avx2_hexEncode(void *const dest, const void *const src, const size_t size, const bool upper) {
+    char *const out = dest;
+    const uint8_t *const bytes = src;
+    const __m256i letters = _mm256_set1_epi8((char)((upper ? 'A' : 'a') - '0' - 10));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(bytes + i));
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+        const __m256i low = _mm256_and_si256(x, nibble);
+        // note: unpacking works within 128-bit lanes, so the halves are swapped back into order.
+        const __m256i first = avx2_hexDigits(_mm256_unpacklo_epi8(high, low), letters);
+        const __m256i second = avx2_hexDigits(_mm256_unpackhi_epi8(high, low), letters);
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    sse2_hexEncode(out + 2 * i, bytes + i, size - i, upper);
+}
+
+// 0xff in every byte within ['first', 'first' + 'count').
+SIMD_TARGET("avx2") static inline __m256i avx2_inRange(const __m256i x, const uint8_t first, const uint8_t count) {
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-128 + count)), _mm256_add_epi8(x, _mm256_set1_epi8((char)(0x80 - first))));
+}
+
+SIMD_TARGET("avx2") static inline __m256i avx2_hexValues(const __m256i c, __m256i *const valid) {
+    const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    const __m256i isDigit = avx2_inRange(c, '0', 10);
+    const __m256i isLetter = avx2_inRange(lower, 'a', 6);
+    *valid = _mm256_or_si256(isDigit, isLetter);
+    return _mm256_or_si256(
+        _mm256_and_si256(isDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+        _mm256_and_si256(isLetter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)))
+    );
+}
+
+SIMD_TARGET("avx2") static inline __m256i avx2_hexJoin(const __m256i values) {
+    return _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi16(values, 4), _mm256_srli_epi16(values, 8)), _mm256_set1_epi16(0xff));
+}
+
+SIMD_TARGET("avx2") static size_t avx2_hexDecode(void *const dest, const void *const src, const size_t size) {
+    uint8_t *const out = dest;
+    const uint8_t *const chars = src;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m256i valid0;
+        __m256i valid1;
+        const __m256i v0 = avx2_hexValues(_mm256_loadu_si256((const __m256i*)(chars + i)), &valid0);
+        const __m256i v1 = avx2_hexValues(_mm256_loadu_si256((const __m256i*)(chars + i + 32)), &valid1);
+        if (_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != -1) {
+            break;
+        }
+        const __m256i packed = _mm256_packus_epi16(avx2_hexJoin(v0), avx2_hexJoin(v1));
+        _mm256_storeu_si256((__m256i*)(out + i / 2), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return i + sse2_hexDecode(out + i / 2, chars + i, size - i);
+}
+
+// Base64 after Mula and Lemire: each 128-bit lane takes 12 bytes, spreads every
+//  3-byte group over 4 bytes, pulls out the 6-bit indices with multiplies and
+//  maps them to chars with a 16-entry shuffle table of offsets.
+SIMD_TARGET("avx2") static void avx2_base64Encode(void *const dest, const void *const src, const size_t size, const bool url) {
+    char* out = dest;
+    const uint8_t *const bytes = src;
+    const __m256i spread = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+    );
+    const char plus = url ? '-' : '+';
+    const char slash = url ? '_' : '/';
+    // note: indexed by 0 for 'a'-'z', 1-10 for '0'-'9', 11 and 12 for the last two and 13 for 'A'-'Z'.
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, (char)(plus - 62), (char)(slash - 63), 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, (char)(plus - 62), (char)(slash - 63), 'A', 0, 0
+    );
+    size_t i = 0;
+    // note: the second lane's load reads 4 bytes past the 24 encoded.
+    for (; i + 28 <= size; i += 24) {
+        const __m128i first = _mm_loadu_si128((const __m128i*)(bytes + i));
+        const __m128i second = _mm_loadu_si128((const __m128i*)(bytes + i + 12));
+        const __m256i x = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1), spread);
+
+        const __m256i outer = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        const __m256i inner = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(outer, inner);
+
+        __m256i slot = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        slot = _mm256_or_si256(slot, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i*)out, _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, slot)));
+        out += 32;
+    }
+    scalar_base64Encode(out, bytes + i, size - i, url);
+}
+
+SIMD_TARGET("avx2") static size_t avx2_base64Decode(void *const dest, const void *const src, const size_t size, const bool url) {
+    uint8_t* out = dest;
+    const uint8_t *const chars = src;
+    const __m256i plus = _mm256_set1_epi8(url ? '-' : '+');
+    const __m256i slash = _mm256_set1_epi8(url ? '_' : '/');
+    const __m256i plusOffset = _mm256_set1_epi8((char)(62 - (url ? '-' : '+')));
+    const __m256i slashOffset = _mm256_set1_epi8((char)(63 - (url ? '_' : '/')));
+    // note: drops the fourth byte of each 32-bit group, leaving 12 bytes per lane.
+    const __m256i gather = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+    );
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i c = _mm256_loadu_si256((const __m256i*)(chars + i));
+        const __m256i isUpper = avx2_inRange(c, 'A', 26);
+        const __m256i isLower = avx2_inRange(c, 'a', 26);
+        const __m256i isDigit = avx2_inRange(c, '0', 10);
+        const __m256i isPlus = _mm256_cmpeq_epi8(c, plus);
+        const __m256i isSlash = _mm256_cmpeq_epi8(c, slash);
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(isUpper, isLower), isDigit), _mm256_or_si256(isPlus, isSlash));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            break;
+        }
+        const __m256i offset = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_and_si256(isUpper, _mm256_set1_epi8(-'A')),
+                _mm256_and_si256(isLower, _mm256_set1_epi8(26 - 'a'))
+            ),
+            _mm256_or_si256(
+                _mm256_and_si256(isDigit, _mm256_set1_epi8(52 - '0')),
+                _mm256_or_si256(_mm256_and_si256(isPlus, plusOffset), _mm256_and_si256(isSlash, slashOffset))
+            )
+        );
+        const __m256i values = _mm256_add_epi8(c, offset);
+
+        // Pairs of 6-bit values into 12 bits, then pairs of those into 24.
+        const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(groups, gather), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        // note: two stores, so nothing past the 24 decoded bytes is written.
+        _mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(packed));
+        _mm_storel_epi64((__m128i*)(out + 16), _mm256_extracti128_si256(packed, 1));
+        out += 24;
+    }
+    return i + scalar_base64Decode(out, chars + i, size - i, url);
+}
+
+static const SimdKernels Avx2Kernels = {
+    .level = simd_avx2,
+    .equal = scalar_equal,
+    .compare = avx2_compare,
+    .fill = avx2_fill,
+    .reverse = avx2_reverse,
+    .findByte = scalar_findByte,
+    .countByte = avx2_countByte,
+    .matchBlock = avx2_matchBlock,
+    .classifyBlock = avx2_classifyBlock,
+    .flipCase = avx2_flipCase,
+    .mismatchIgnoreCase = avx2_mismatchIgnoreCase,
+    .hexEncode = avx2_hexEncode,
+    .hexDecode = avx2_hexDecode,
+    .base64Encode = avx2_base64Encode,
+    .base64Decode = avx2_base64Decode,
+};
+
+// note: AVX-512 tails use masked loads/stores rather than falling back to narrower code.
+#define AVX512_TARGET SIMD_TARGET("avx512f,avx512bw,avx2,popcnt")
+
+AVX512_TARGET static inline __mmask64 avx512_tailMask(const size_t remaining) {
+    return (remaining >= 64) ? ~(__mmask64)0 : (((__mmask64)1 << remaining) - 1);
+}
+
+AVX512_TARGET static int avx512_compare(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    for (size_t i = 0; i < size; i += 64) {
+        const __mmask64 mask = avx512_tailMask(size - i);
+        const __m512i va = _mm512_maskz_loadu_epi8(mask, x + i);
+        const __m512i vb = _mm512_maskz_loadu_epi8(mask, y + i);
+        const __mmask64 diff = _mm512_cmpneq_epi8_mask(va, vb);
+        if (diff != 0) {
+            const size_t j = i + n5_ctz64(diff);
+            return simd_sign(x[j], y[j]);
+        }
+    }
+    return 0;
+}
+
+AVX512_TARGET static void avx512_fill(void *const dest, const size_t count, const void *const value, const size_t width) {
+    if (width != 1 && width != 2 && width != 4 && width != 8) {
+        scalar_fill(dest, count, value, width);
+        return;
+    }
+
+    const __m512i pattern = _mm512_broadcast_i32x4(sse2_broadcast(value, width));
+    uint8_t *const bytes = dest;
+    const size_t size = count * width;
+    for (size_t i = 0; i < size; i += 64) {
+        _mm512_mask_storeu_epi8(bytes + i, avx512_tailMask(size - i), pattern);
+    }
+}
+
+AVX512_TARGET static size_t avx512_countByte(const void *const data, const size_t size, const uint8_t byte) {
+    const uint8_t *const bytes = data;
+    const __m512i needle = _mm512_set1_epi8((char)byte);
+    size_t count = 0;
+    for (size_t i = 0; i < size; i += 64) {
+        const __mmask64 mask = avx512_tailMask(size - i);
+        count += (size_t)_mm_popcnt_u64(_mm512_mask_cmpeq_epi8_mask(mask, _mm512_maskz_loadu_epi8(mask, bytes + i), needle));
+    }
+    return count;
+}
+
+AVX512_TARGET static void avx512_matchBlock(const void *const block, const uint8_t *const needles, const size_t count, uint64_t *const masks) {
+    const __m512i bytes = _mm512_loadu_si512(block);
+    for (size_t n = 0; n < count; ++n) {
+        masks[n] = _mm512_cmpeq_epi8_mask(bytes, _mm512_set1_epi8((char)needles[n]));
+    }
+}
+
+AVX512_TARGET static void avx512_classifyBlock(const void *const block, const uint8_t *const tables, const uint8_t *const classes, const size_t count, uint64_t *const masks) {
+    const __m512i bytes = _mm512_loadu_si512(block);
+    const __m512i low = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)tables));
+    const __m512i high = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(tables + 16)));
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    const __m512i found = _mm512_and_si512(
+        _mm512_shuffle_epi8(low, _mm512_and_si512(bytes, nibble)),
+        _mm512_shuffle_epi8(high, _mm512_and_si512(_mm512_srli_epi16(bytes, 4), nibble)));
+    for (size_t n = 0; n < count; ++n) {
+        masks[n] = _mm512_test_epi8_mask(found, _mm512_set1_epi8((char)classes[n]));
+    }
+}
+
+AVX512_TARGET static void avx512_flipCase(void *const data, const size_t size, const uint8_t first) {
+    uint8_t *const bytes = data;
+    const __m512i base = _mm512_set1_epi8((char)first);
+    const __m512i span = _mm512_set1_epi8(26);
+    const __m512i bit = _mm512_set1_epi8(0x20);
+    for (size_t i = 0; i < size; i += 64) {
+        const __mmask64 mask = avx512_tailMask(size - i);
+        const __m512i x = _mm512_maskz_loadu_epi8(mask, bytes + i);
+        // note: only the bytes that change are stored.
+        const __mmask64 hit = _mm512_mask_cmplt_epu8_mask(mask, _mm512_sub_epi8(x, base), span);
+        _mm512_mask_storeu_epi8(bytes + i, hit, _mm512_xor_si512(x, bit));
+    }
+}
+
+AVX512_TARGET static inline __m512i avx512_lower(const __m512i x) {
+    const __mmask64 upper = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(x, _mm512_set1_epi8('A')), _mm512_set1_epi8(26));
+    return _mm512_mask_mov_epi8(x, upper, _mm512_or_si512(x, _mm512_set1_epi8(0x20)));
+}
+
+AVX512_TARGET static size_t avx512_mismatchIgnoreCase(const void *const a, const void *const b, const size_t size) {
+    const uint8_t *const x = a;
+    const uint8_t *const y = b;
+    for (size_t i = 0; i < size; i += 64) {
+        const __mmask64 mask = avx512_tailMask(size - i);
+        const __m512i va = _mm512_maskz_loadu_epi8(mask, x + i);
+        const __m512i vb = _mm512_maskz_loadu_epi8(mask, y + i);
+        const __mmask64 diff = _mm512_cmpneq_epi8_mask(avx512_lower(va), avx512_lower(vb));
+        if (diff != 0) {
+            return i + n5_ctz64(diff);
+        }
+    }
+    return size;
+}
+
+static const SimdKernels Avx512Kernels = {
+    .level = simd_avx512,
+    .equal = scalar_equal,
+    .compare = avx512_compare,
+    .fill = avx512_fill,
+    // note: a byte reverse gains little over AVX2 here.
+    .reverse = avx2_reverse,
+    .findByte = scalar_findByte,
+    .countByte = avx512_countByte,
+    .matchBlock = avx512_matchBlock,
+    .classifyBlock = avx512_classifyBlock,
+    .flipCase = avx512_flipCase,
+    .mismatchIgnoreCase = avx512_mismatchIgnoreCase,
+    // note: wider versions of these need VBMI's byte permutes to pay off.
+    .hexEncode = avx2_hexEncode,
+    .hexDecode = avx2_hexDecode,
+    .base64Encode = avx2_base64Encode,
+    .base64Decode = avx2_base64Decode,
+};
+
+#endif // SIMD_DISPATCH
+
+#if SIMD_SSE2
+const SimdKernels* n5_simd = &Sse2Kernels;
+#else
+const SimdKernels* n5_simd = &ScalarKernels;
+#endif
+
+SimdLevel n5_simd_detect(void) {
+#if SIMD_DISPATCH
+    __builtin_cpu_init();
+    simd_ssse3 = __builtin_cpu_supports("ssse3");
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("popcnt")) {
+        return simd_avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return simd_avx2;
+    }
+#endif
+#if SIMD_SSE2
+    return simd_sse2;
+#else
+    return simd_scalar;
+#endif
+}
+
+bool n5_simd_select(const SimdLevel level) {
+    if (level > n5_simd_detect()) {
+        return false;
+    }
+
+    switch (level) {
+#if SIMD_DISPATCH
+        case simd_avx512: n5_simd = &Avx512Kernels; return true;
+        case simd_avx2: n5_simd = &Avx2Kernels; return true;
+#endif
+#if SIMD_SSE2
+        case simd_sse2: n5_simd = &Sse2Kernels; return true;
+#endif
+        case simd_scalar: n5_simd = &ScalarKernels; return true;
+        default: return false;
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((constructor)) static void n5_simd_init(void) {
+    static const char *const names[] = { "scalar", "sse2", "avx2", "avx512" };
+
+    SimdLevel level = n5_simd_detect();
+    const char *const override = getenv("N5_SIMD");
+    if (override != NULL) {
+        for (size_t i = 0; i < n5_arraySize(names); ++i) {
+            if (strcmp(override, names[i]) == 0) {
+                level = n5_min(level, (SimdLevel)i);
+            }
+        }
+    }
+    n5_simd_select(level);
+}
+#endif
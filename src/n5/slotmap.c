@@ -0,0 +1,138 @@
+#include "n5/slotmap.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+static inline SlotMapSlot* SlotMapRaw_slots(const SlotMapRaw *const self) {
+    return self->slots.items.data;
+}
+
+static inline uint32_t* SlotMapRaw_itemSlots(const SlotMapRaw *const self) {
+    return self->itemSlots.items.data;
+}
+
+void SlotMapRaw_free(SlotMapRaw *const self, const size_t itemSize, const DebugInfo debugInfo) {
+    assert(self != NULL);
+    // note: the first three fields are laid out like a Vec.
+    VecRaw_free((VecRaw*)self, itemSize, debugInfo);
+    VecRaw_free(&self->itemSlots, sizeof(uint32_t), debugInfo);
+    VecRaw_free(&self->slots, sizeof(SlotMapSlot), debugInfo);
+    self->freeSlot = SLOT_NONE;
+}
+
+bool SlotMapRaw_reserve(
+    SlotMapRaw *const self,
+    const size_t itemSize,
+    const size_t minCapacity,
+    const DebugInfo debugInfo
+) {
+    assert(self != NULL);
+
+    // note: slot indices (and SLOT_NONE) have to fit in 32 bits.
+    if (minCapacity >= SLOT_NONE) {
+        return false;
+    }
+    return VecRaw_reserve((VecRaw*)self, itemSize, minCapacity, debugInfo)
+        && VecRaw_reserve(&self->itemSlots, sizeof(uint32_t), minCapacity, debugInfo)
+        && VecRaw_reserve(&self->slots, sizeof(SlotMapSlot), minCapacity, debugInfo);
+}
+
+bool SlotMapRaw_insert(
+    SlotMapRaw *const self,
+    const size_t itemSize,
+    SlotHandle *const handle,
+    const DebugInfo debugInfo
+) {
+    assert(self != NULL);
+    assert(handle != NULL);
+
+    // note: everything that can fail happens before anything changes.
+    const size_t size = self->items.size;
+    if (!SlotMapRaw_reserve(self, itemSize, size + 1, debugInfo)) {
+        return false;
+    }
+
+    uint32_t index = self->freeSlot;
+    if (index != SLOT_NONE) {
+        self->freeSlot = SlotMapRaw_slots(self)[index].index;
+    } else {
+        index = (uint32_t)self->slots.items.size++;
+        SlotMapRaw_slots(self)[index] = (SlotMapSlot) { 0 };
+    }
+
+    SlotMapSlot *const slot = &SlotMapRaw_slots(self)[index];
+    ++slot->generation;
+    slot->index = (uint32_t)size;
+    SlotMapRaw_itemSlots(self)[size] = index;
+    ++self->itemSlots.items.size;
+    ++self->items.size;
+
+    *handle = (SlotHandle) { .index = index, .generation = slot->generation };
+    return true;
+}
+
+size_t SlotMapRaw_find(const SlotMapRaw *const self, const SlotHandle handle) {
+    assert(self != NULL);
+
+    if (handle.index >= self->slots.items.size) {
+        return SIZE_MAX;
+    }
+    const SlotMapSlot slot = SlotMapRaw_slots(self)[handle.index];
+    // note: a free slot's generation is even, so it never matches a handle.
+    return (slot.generation == handle.generation) ? slot.index : SIZE_MAX;
+}
+
+void* SlotMapRaw_get(const SlotMapRaw *const self, const size_t itemSize, const SlotHandle handle) {
+    const size_t index = SlotMapRaw_find(self, handle);
+    return (index != SIZE_MAX) ? (uint8_t*)self->items.data + index * itemSize : NULL;
+}
+
+bool SlotMapRaw_remove(SlotMapRaw *const self, const size_t itemSize, const SlotHandle handle) {
+    const size_t index = SlotMapRaw_find(self, handle);
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    SlotMapSlot *const slots = SlotMapRaw_slots(self);
+    uint32_t *const itemSlots = SlotMapRaw_itemSlots(self);
+    const size_t last = self->items.size - 1;
+    if (index != last) {
+        uint8_t *const items = self->items.data;
+        memcpy(items + index * itemSize, items + last * itemSize, itemSize);
+        itemSlots[index] = itemSlots[last];
+        slots[itemSlots[index]].index = (uint32_t)index;
+    }
+    --self->items.size;
+    --self->itemSlots.items.size;
+
+    SlotMapSlot *const slot = &slots[handle.index];
+    ++slot->generation;
+    slot->index = self->freeSlot;
+    self->freeSlot = handle.index;
+    return true;
+}
+
+SlotHandle SlotMapRaw_handleAt(const SlotMapRaw *const self, const size_t index) {
+    assert(self != NULL);
+    assert(index < self->items.size);
+
+    const uint32_t slot = SlotMapRaw_itemSlots(self)[index];
+    return (SlotHandle) { .index = slot, .generation = SlotMapRaw_slots(self)[slot].generation };
+}
+
+void SlotMapRaw_clear(SlotMapRaw *const self) {
+    assert(self != NULL);
+
+    SlotMapSlot *const slots = SlotMapRaw_slots(self);
+    const uint32_t *const itemSlots = SlotMapRaw_itemSlots(self);
+    for (size_t i = 0; i < self->items.size; ++i) {
+        SlotMapSlot *const slot = &slots[itemSlots[i]];
+        ++slot->generation;
+        slot->index = self->freeSlot;
+        self->freeSlot = itemSlots[i];
+    }
+    self->items.size = 0;
+    self->itemSlots.items.size = 0;
+}
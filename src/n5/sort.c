@@ -0,0 +1,531 @@
+#include "n5/sort.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <threads.h>
+
+#include "n5/utils.h"
+
+#define RADIX 256
+#define INSERTION_THRESHOLD 32
+#define PARALLEL_THRESHOLD (1 << 16)
+#define MAX_THREADS 64
+
+typedef struct SortPool SortPool;
+typedef struct SortTask SortTask;
+
+struct SortTask {
+    SortPool* pool;
+    const uint64_t* src;
+    uint64_t* dest;
+    cstr* srcStr;
+    cstr* destStr;
+    size_t begin;
+    size_t end;
+    uint32_t shift;
+    uint64_t flip;
+    size_t depth;
+    size_t counts[RADIX + 1];
+};
+
+typedef int (*SortTaskFn)(void* task);
+
+// The workers for one sort call: started once, then woken for each pass and
+//  waited on like a barrier, so a pass costs a broadcast instead of a round
+//  of thread creation.
+struct SortPool {
+    SortTask* tasks;
+    size_t taskCount;
+    size_t workerCount;
+    mtx_t lock;
+    cnd_t wake;
+    cnd_t idle;
+    SortTaskFn fn;
+    size_t generation;
+    size_t pending;
+    bool stopping;
+    // the cstr buckets left to sort, claimed one at a time by sort_bucketTask_cstr.
+    cstr* data;
+    cstr* buffer;
+    size_t depth;
+    size_t bucketCount;
+    size_t bucketStarts[RADIX];
+    size_t bucketSizes[RADIX];
+    atomic_size_t nextBucket;
+    thrd_t threads[MAX_THREADS];
+};
+
+static int SortPool_worker(void *const arg) {
+    SortTask *const task = arg;
+    SortPool *const pool = task->pool;
+    size_t seen = 0;
+
+    mtx_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->stopping) {
+            cnd_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        seen = pool->generation;
+        const SortTaskFn fn = pool->fn;
+        mtx_unlock(&pool->lock);
+
+        fn(task);
+
+        mtx_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            cnd_signal(&pool->idle);
+        }
+    }
+    mtx_unlock(&pool->lock);
+    return 0;
+}
+
+// Starts a worker for every task but the first, which runs on the calling thread.
+//  If the sync objects or some threads can't be created, the pool still works
+//  with fewer workers; the leftover tasks run inline.
+static void SortPool_start(SortPool *const self, SortTask *const tasks, const size_t taskCount) {
+    self->tasks = tasks;
+    self->taskCount = taskCount;
+    self->workerCount = 0;
+    self->generation = 0;
+    self->pending = 0;
+    self->stopping = false;
+    for (size_t t = 0; t < taskCount; ++t) {
+        tasks[t].pool = self;
+    }
+    if (taskCount <= 1) {
+        return;
+    }
+
+    if (mtx_init(&self->lock, mtx_plain) != thrd_success) {
+        return;
+    }
+    if (cnd_init(&self->wake) != thrd_success) {
+        mtx_destroy(&self->lock);
+        return;
+    }
+    if (cnd_init(&self->idle) != thrd_success) {
+        cnd_destroy(&self->wake);
+        mtx_destroy(&self->lock);
+        return;
+    }
+
+    for (size_t t = 1; t < taskCount; ++t) {
+        if (thrd_create(&self->threads[t], SortPool_worker, &tasks[t]) != thrd_success) {
+            break;
+        }
+        ++self->workerCount;
+    }
+    if (self->workerCount == 0) {
+        cnd_destroy(&self->idle);
+        cnd_destroy(&self->wake);
+        mtx_destroy(&self->lock);
+    }
+}
+
+// Runs fn over every task and returns once all of them are done.
+static void SortPool_run(SortPool *const self, const SortTaskFn fn) {
+    if (self->workerCount > 0) {
+        mtx_lock(&self->lock);
+        self->fn = fn;
+        self->pending = self->workerCount;
+        ++self->generation;
+        cnd_broadcast(&self->wake);
+        mtx_unlock(&self->lock);
+    }
+
+    fn(&self->tasks[0]);
+    // note: tasks whose threads failed to start run inline, so the pass still completes.
+    for (size_t t = 1 + self->workerCount; t < self->taskCount; ++t) {
+        fn(&self->tasks[t]);
+    }
+
+    if (self->workerCount > 0) {
+        mtx_lock(&self->lock);
+        while (self->pending > 0) {
+            cnd_wait(&self->idle, &self->lock);
+        }
+        mtx_unlock(&self->lock);
+    }
+}
+
+static void SortPool_stop(SortPool *const self) {
+    if (self->workerCount == 0) {
+        return;
+    }
+
+    mtx_lock(&self->lock);
+    self->stopping = true;
+    cnd_broadcast(&self->wake);
+    mtx_unlock(&self->lock);
+
+    for (size_t t = 1; t <= self->workerCount; ++t) {
+        thrd_join(self->threads[t], NULL);
+    }
+    cnd_destroy(&self->idle);
+    cnd_destroy(&self->wake);
+    mtx_destroy(&self->lock);
+}
+
+static size_t sort_threadCount(const size_t size, const size_t threadCount) {
+    if (threadCount <= 1 || size < PARALLEL_THRESHOLD) {
+        return 1;
+    }
+    return n5_min(n5_min(threadCount, MAX_THREADS), size / (PARALLEL_THRESHOLD / 4));
+}
+
+static void sort_insertion_u64(uint64_t *const data, const size_t size, const uint64_t flip) {
+    for (size_t i = 1; i < size; ++i) {
+        const uint64_t value = data[i];
+        size_t j = i;
+        for (; j > 0 && (data[j - 1] ^ flip) > (value ^ flip); --j) {
+            data[j] = data[j - 1];
+        }
+        data[j] = value;
+    }
+}
+
+static int sort_countTask_u64(void *const arg) {
+    SortTask *const task = arg;
+    memset(task->counts, 0, sizeof(task->counts));
+    for (size_t i = task->begin; i < task->end; ++i) {
+        ++task->counts[((task->src[i] ^ task->flip) >> task->shift) & 0xff];
+    }
+    return 0;
+}
+
+static int sort_scatterTask_u64(void *const arg) {
+    SortTask *const task = arg;
+    for (size_t i = task->begin; i < task->end; ++i) {
+        const uint64_t value = task->src[i];
+        task->dest[task->counts[((value ^ task->flip) >> task->shift) & 0xff]++] = value;
+    }
+    return 0;
+}
+
+// Turns each task's digit counts into its starting offsets in the output,
+//  so that equal digits keep their original (task) order.
+static bool sort_prefixSums(SortTask *const tasks, const size_t taskCount, const size_t size) {
+    size_t offset = 0;
+    for (size_t digit = 0; digit < RADIX; ++digit) {
+        size_t total = 0;
+        for (size_t t = 0; t < taskCount; ++t) {
+            const size_t count = tasks[t].counts[digit];
+            tasks[t].counts[digit] = offset + total;
+            total += count;
+        }
+        // a pass where every key shares the digit would just copy the input.
+        if (total == size) {
+            return false;
+        }
+        offset += total;
+    }
+    return true;
+}
+
+static bool sort_lsd(
+    uint64_t *const data,
+    const size_t size,
+    const uint64_t flip,
+    Allocator *const scratch,
+    const size_t threadCount
+) {
+    if (size < INSERTION_THRESHOLD) {
+        sort_insertion_u64(data, size, flip);
+        return true;
+    }
+
+    Block buffer = Allocator_alloc(scratch, uint64_t, size);
+    if (buffer.data == NULL) {
+        return false;
+    }
+
+    SortTask tasks[MAX_THREADS];
+    const size_t taskCount = sort_threadCount(size, threadCount);
+    for (size_t t = 0; t < taskCount; ++t) {
+        tasks[t] = (SortTask) {
+            .begin = (size * t) / taskCount,
+            .end = (size * (t + 1)) / taskCount,
+            .flip = flip,
+        };
+    }
+
+    SortPool pool;
+    SortPool_start(&pool, tasks, taskCount);
+
+    uint64_t* src = data;
+    uint64_t* dest = buffer.data;
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        for (size_t t = 0; t < taskCount; ++t) {
+            tasks[t].src = src;
+            tasks[t].dest = dest;
+            tasks[t].shift = shift;
+        }
+
+        SortPool_run(&pool, sort_countTask_u64);
+        if (!sort_prefixSums(tasks, taskCount, size)) {
+            continue;
+        }
+        SortPool_run(&pool, sort_scatterTask_u64);
+
+        uint64_t *const tmp = src;
+        src = dest;
+        dest = tmp;
+    }
+    SortPool_stop(&pool);
+
+    if (src != data) {
+        memcpy(data, src, size * sizeof(uint64_t));
+    }
+
+    Allocator_free(scratch, buffer);
+    return true;
+}
+
+bool sort_radix_u64(const u64s self, Allocator *const scratch, const size_t threadCount) {
+    assert(self.data != NULL || self.size == 0);
+    assert(scratch != NULL);
+    return sort_lsd(self.data, self.size, 0, scratch, threadCount);
+}
+
+bool sort_radix_i64(const i64s self, Allocator *const scratch, const size_t threadCount) {
+    assert(self.data != NULL || self.size == 0);
+    assert(scratch != NULL);
+    // note: flipping the sign bit maps two's complement order onto unsigned order.
+    return sort_lsd((uint64_t*)self.data, self.size, (uint64_t)1 << 63, scratch, threadCount);
+}
+
+// Digit 0 is reserved for "past the end", so shorter strings sort first.
+static inline size_t cstr_digit(const cstr key, const size_t depth) {
+    return (depth < key.size) ? (size_t)(uint8_t)key.data[depth] + 1 : 0;
+}
+
+static inline bool cstr_lessFrom(const cstr a, const cstr b, const size_t depth) {
+    const size_t size = n5_min(a.size, b.size);
+    if (size > depth) {
+        const int result = memcmp(a.data + depth, b.data + depth, size - depth);
+        if (result != 0) {
+            return result < 0;
+        }
+    }
+    return a.size < b.size;
+}
+
+static void sort_insertion_cstr(cstr *const data, const size_t size, const size_t depth) {
+    for (size_t i = 1; i < size; ++i) {
+        const cstr value = data[i];
+        size_t j = i;
+        for (; j > 0 && cstr_lessFrom(value, data[j - 1], depth); --j) {
+            data[j] = data[j - 1];
+        }
+        data[j] = value;
+    }
+}
+
+static void sort_msd(cstr *const data, cstr *const buffer, const size_t size, size_t depth) {
+    size_t counts[RADIX + 1];
+    for (;;) {
+        if (size < INSERTION_THRESHOLD) {
+            sort_insertion_cstr(data, size, depth);
+            return;
+        }
+
+        memset(counts, 0, sizeof(counts));
+        for (size_t i = 0; i < size; ++i) {
+            ++counts[cstr_digit(data[i], depth)];
+        }
+
+        if (counts[0] == size) {
+            // every key ends here, so they're all equal.
+            return;
+        }
+
+        // a shared byte at this depth doesn't need a scatter, just go deeper.
+        bool shared = false;
+        for (size_t digit = 1; digit <= RADIX; ++digit) {
+            if (counts[digit] == size) {
+                shared = true;
+                break;
+            }
+        }
+        if (!shared) {
+            break;
+        }
+        ++depth;
+    }
+
+    size_t offsets[RADIX + 1];
+    size_t offset = 0;
+    for (size_t digit = 0; digit <= RADIX; ++digit) {
+        offsets[digit] = offset;
+        offset += counts[digit];
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+        buffer[offsets[cstr_digit(data[i], depth)]++] = data[i];
+    }
+    memcpy(data, buffer, size * sizeof(cstr));
+
+    // note: bucket 0 holds keys that end at this depth, which are already equal.
+    size_t start = counts[0];
+    for (size_t digit = 1; digit <= RADIX; ++digit) {
+        if (counts[digit] > 1) {
+            sort_msd(data + start, buffer + start, counts[digit], depth + 1);
+        }
+        start += counts[digit];
+    }
+}
+
+static int sort_countTask_cstr(void *const arg) {
+    SortTask *const task = arg;
+    memset(task->counts, 0, sizeof(task->counts));
+    for (size_t i = task->begin; i < task->end; ++i) {
+        ++task->counts[cstr_digit(task->srcStr[i], task->depth)];
+    }
+    return 0;
+}
+
+static int sort_scatterTask_cstr(void *const arg) {
+    SortTask *const task = arg;
+    for (size_t i = task->begin; i < task->end; ++i) {
+        task->destStr[task->counts[cstr_digit(task->srcStr[i], task->depth)]++] = task->srcStr[i];
+    }
+    return 0;
+}
+
+static int sort_copyTask_cstr(void *const arg) {
+    SortTask *const task = arg;
+    memcpy(task->srcStr + task->begin, task->destStr + task->begin, (task->end - task->begin) * sizeof(cstr));
+    return 0;
+}
+
+// Sorts the queued buckets, each task claiming the next one until none are left.
+static int sort_bucketTask_cstr(void *const arg) {
+    SortPool *const pool = ((SortTask*)arg)->pool;
+    for (;;) {
+        const size_t i = atomic_fetch_add_explicit(&pool->nextBucket, 1, memory_order_relaxed);
+        if (i >= pool->bucketCount) {
+            return 0;
+        }
+        const size_t start = pool->bucketStarts[i];
+        sort_msd(pool->data + start, pool->buffer + start, pool->bucketSizes[i], pool->depth + 1);
+    }
+}
+
+// One MSD level with the counts and scatter split across the pool. Buckets
+//  bigger than a thread's share go through another parallel level; the rest
+//  are handed out to the workers, largest first.
+static void sort_parallelMsd(SortPool *const pool, cstr *const data, cstr *const buffer, const size_t size, size_t depth) {
+    SortTask *const tasks = pool->tasks;
+    const size_t taskCount = pool->taskCount;
+    for (size_t t = 0; t < taskCount; ++t) {
+        tasks[t].srcStr = data;
+        tasks[t].destStr = buffer;
+        tasks[t].begin = (size * t) / taskCount;
+        tasks[t].end = (size * (t + 1)) / taskCount;
+    }
+
+    size_t sizes[RADIX + 1];
+    for (;;) {
+        for (size_t t = 0; t < taskCount; ++t) {
+            tasks[t].depth = depth;
+        }
+        SortPool_run(pool, sort_countTask_cstr);
+
+        bool shared = false;
+        for (size_t digit = 0; digit <= RADIX; ++digit) {
+            sizes[digit] = 0;
+            for (size_t t = 0; t < taskCount; ++t) {
+                sizes[digit] += tasks[t].counts[digit];
+            }
+            shared |= (sizes[digit] == size);
+        }
+        if (sizes[0] == size) {
+            // every key ends here, so they're all equal.
+            return;
+        }
+        if (!shared) {
+            break;
+        }
+        ++depth;
+    }
+
+    size_t offset = 0;
+    for (size_t digit = 0; digit <= RADIX; ++digit) {
+        for (size_t t = 0; t < taskCount; ++t) {
+            const size_t count = tasks[t].counts[digit];
+            tasks[t].counts[digit] = offset;
+            offset += count;
+        }
+    }
+    SortPool_run(pool, sort_scatterTask_cstr);
+    SortPool_run(pool, sort_copyTask_cstr);
+
+    // note: bucket 0 holds keys that end at this depth, which are already equal.
+    size_t bucketStarts[RADIX];
+    size_t bucketSizes[RADIX];
+    size_t bucketCount = 0;
+    size_t start = sizes[0];
+    for (size_t digit = 1; digit <= RADIX; ++digit) {
+        const size_t count = sizes[digit];
+        if (count >= PARALLEL_THRESHOLD && count > size / taskCount) {
+            sort_parallelMsd(pool, data + start, buffer + start, count, depth + 1);
+        } else if (count > 1) {
+            size_t i = bucketCount++;
+            for (; i > 0 && bucketSizes[i - 1] < count; --i) {
+                bucketStarts[i] = bucketStarts[i - 1];
+                bucketSizes[i] = bucketSizes[i - 1];
+            }
+            bucketStarts[i] = start;
+            bucketSizes[i] = count;
+        }
+        start += count;
+    }
+    if (bucketCount == 0) {
+        return;
+    }
+
+    pool->data = data;
+    pool->buffer = buffer;
+    pool->depth = depth;
+    pool->bucketCount = bucketCount;
+    memcpy(pool->bucketStarts, bucketStarts, bucketCount * sizeof(size_t));
+    memcpy(pool->bucketSizes, bucketSizes, bucketCount * sizeof(size_t));
+    atomic_store_explicit(&pool->nextBucket, 0, memory_order_relaxed);
+    SortPool_run(pool, sort_bucketTask_cstr);
+}
+
+bool sort_radix_cstr(const cstrs self, Allocator *const scratch, const size_t threadCount) {
+    assert(self.data != NULL || self.size == 0);
+    assert(scratch != NULL);
+
+    if (self.size < INSERTION_THRESHOLD) {
+        sort_insertion_cstr(self.data, self.size, 0);
+        return true;
+    }
+
+    Block buffer = Allocator_alloc(scratch, cstr, self.size);
+    if (buffer.data == NULL) {
+        return false;
+    }
+
+    const size_t taskCount = sort_threadCount(self.size, threadCount);
+    if (taskCount == 1) {
+        sort_msd(self.data, buffer.data, self.size, 0);
+        Allocator_free(scratch, buffer);
+        return true;
+    }
+
+    SortTask tasks[MAX_THREADS];
+    SortPool pool;
+    SortPool_start(&pool, tasks, taskCount);
+    sort_parallelMsd(&pool, self.data, buffer.data, self.size, 0);
+    SortPool_stop(&pool);
+
+    Allocator_free(scratch, buffer);
+    return true;
+}
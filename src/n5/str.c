@@ -1,16 +1,164 @@
 #include "n5/str.h"
 
 #include <assert.h>
+#include <string.h>
+
+#include "n5/simd.h"
+#include "n5/utils.h"
 
 void str_reverse(const str self) {
     assert(self.data != NULL);
-    char* start = self.data;
-    char* end = start + (self.size - 1);
-    while (start < end) {
-        char tmp = *start;
-        *(start++) = *end;
-        *(end--) = tmp;
+    n5_simd->reverse(self.data, self.size);
+}
+
+void str_toLower(const str self) {
+    assert(self.data != NULL || self.size == 0);
+    n5_simd->flipCase(self.data, self.size, 'A');
+}
+
+void str_toUpper(const str self) {
+    assert(self.data != NULL || self.size == 0);
+    n5_simd->flipCase(self.data, self.size, 'a');
+}
+
+static inline bool str_isSpace(const char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+cstr cstr_trimStart(const cstr self) {
+    assert(self.data != NULL || self.size == 0);
+    size_t start = 0;
+    while (start < self.size && str_isSpace(self.data[start])) {
+        ++start;
     }
+    return cstr_slice(self, start, self.size - start);
+}
+
+cstr cstr_trimEnd(const cstr self) {
+    assert(self.data != NULL || self.size == 0);
+    size_t end = self.size;
+    while (end > 0 && str_isSpace(self.data[end - 1])) {
+        --end;
+    }
+    return cstr_slice(self, 0, end);
+}
+
+cstr cstr_trim(const cstr self) {
+    return cstr_trimEnd(cstr_trimStart(self));
+}
+
+size_t cstr_findChar(const cstr self, const char character) {
+    assert(self.data != NULL || self.size == 0);
+    return n5_simd->findByte(self.data, self.size, (uint8_t)character);
+}
+
+size_t cstr_countChar(const cstr self, const char character) {
+    assert(self.data != NULL || self.size == 0);
+    return n5_simd->countByte(self.data, self.size, (uint8_t)character);
+}
+
+bool cstr_splitNext(cstr *const self, const char delimiter, cstr *const token) {
+    assert(self != NULL);
+    assert(token != NULL);
+
+    if (self->size == 0) {
+        return false;
+    }
+
+    const size_t found = cstr_findChar(*self, delimiter);
+    *token = (cstr)Slice_from(self->data, found);
+
+    const size_t consumed = n5_min(found + 1, self->size);
+    self->data += consumed;
+    self->size -= consumed;
+    return true;
+}
+
+static inline uint64_t str_load64(const char *const data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static inline uint64_t str_load32(const char *const data) {
+    uint32_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static inline uint8_t str_lower(const uint8_t c) {
+    return ((uint8_t)(c - 'A') < 26) ? (uint8_t)(c | 0x20) : c;
+}
+
+// Lowercases the ASCII letters in a word, 8 bytes at a time: the bottom 7 bits
+//  of each byte are offset so that bit 7 says ">= 'A'" and "> 'Z'" without
+//  carrying into the next byte, and bytes with bit 7 set are never letters.
+static inline uint64_t str_lower64(const uint64_t word) {
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t low = word & (0x7f * ones);
+    const uint64_t fromA = low + (0x80 - 'A') * ones;
+    const uint64_t pastZ = low + (0x80 - 'Z' - 1) * ones;
+    const uint64_t upper = fromA & ~pastZ & ~word & (0x80 * ones);
+    return word | (upper >> 2);
+}
+
+static inline uint64_t str_hash(const cstr self, const bool fold) {
+    assert(self.data != NULL || self.size == 0);
+
+    const uint64_t k = 0x9e3779b97f4a7c15ull;
+    uint64_t hash = self.size * k;
+    const char *const data = self.data;
+    const size_t size = self.size;
+
+    // note: short tails are read as overlapping loads rather than byte by byte.
+    if (size >= 8) {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const uint64_t word = str_load64(data + i);
+            hash = (hash ^ (fold ? str_lower64(word) : word)) * k;
+            hash ^= hash >> 29;
+        }
+        if (i < size) {
+            const uint64_t word = str_load64(data + size - 8);
+            hash = (hash ^ (fold ? str_lower64(word) : word)) * k;
+        }
+    } else if (size >= 4) {
+        const uint64_t word = (str_load32(data) << 32) | str_load32(data + size - 4);
+        hash = (hash ^ (fold ? str_lower64(word) : word)) * k;
+    } else if (size > 0) {
+        const uint64_t word = ((uint64_t)(uint8_t)data[0] << 16)
+            | ((uint64_t)(uint8_t)data[size / 2] << 8)
+            | (uint64_t)(uint8_t)data[size - 1];
+        hash = (hash ^ (fold ? str_lower64(word) : word)) * k;
+    }
+
+    return n5_hash_u64(hash);
+}
+
+uint64_t cstr_hash(const cstr self) {
+    return str_hash(self, false);
+}
+
+uint64_t cstr_hashIgnoreCase(const cstr self) {
+    return str_hash(self, true);
+}
+
+bool cstr_equalsIgnoreCase(const cstr a, const cstr b) {
+    assert(a.data != NULL || a.size == 0);
+    assert(b.data != NULL || b.size == 0);
+    return a.size == b.size && n5_simd->mismatchIgnoreCase(a.data, b.data, a.size) == a.size;
+}
+
+int cstr_compareIgnoreCase(const cstr a, const cstr b) {
+    assert(a.data != NULL || a.size == 0);
+    assert(b.data != NULL || b.size == 0);
+
+    const size_t size = n5_min(a.size, b.size);
+    const size_t i = n5_simd->mismatchIgnoreCase(a.data, b.data, size);
+    if (i < size) {
+        return (str_lower((uint8_t)a.data[i]) < str_lower((uint8_t)b.data[i])) ? -1 : 1;
+    }
+    return (a.size > b.size) - (a.size < b.size);
 }
 
 bool str_tryParse_u64(const cstr self, uint64_t *const val) {
@@ -19,12 +167,15 @@ bool str_tryParse_u64(const cstr self, uint64_t *const val) {
 
     *val = 0;
     for (size_t i = 0; i < self.size; ++i) {
-        if (self.data[i] < '0' || self.data[i] > '9' || *val > (UINT64_MAX / 10)) {
+        if (self.data[i] < '0' || self.data[i] > '9') {
             return false;
         }
 
-        *val *= 10;
-        *val += (self.data[i] - '0');
+        const uint64_t digit = (uint64_t)(self.data[i] - '0');
+        if (*val > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        *val = *val * 10 + digit;
     }
     return true;
 }
@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "n5/alloc.h"
+#include "n5/trace.h"
 #include "n5/utils.h"
 
 #define MIN_CAPACITY 4
@@ -50,10 +51,13 @@ bool String_resize(String *const self, size_t capacity) {
         return true;
     }
 
+    Trace_begin("String_resize");
+
     // note: add 1 to capacity here for null terminator.
     //  - need to also do so when we free self->str.
     Block buffer = Allocator_alloc(self->owner, char, capacity + 1);
     if (buffer.data == NULL) {
+        Trace_end("String_resize");
         return false;
     }
 
@@ -68,6 +72,7 @@ bool String_resize(String *const self, size_t capacity) {
     self->str = newStr;
     self->capacity = capacity;
 
+    Trace_end("String_resize");
     return true;
 }
 
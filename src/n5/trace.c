@@ -0,0 +1,275 @@
+#include "n5/trace.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <threads.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "n5/format.h"
+#include "n5/json.h"
+#include "n5/utils.h"
+
+#define MIN_EVENTS 64
+#define MIN_CALIBRATION_NS 10000000ull
+
+typedef struct Tracer Tracer;
+
+struct Tracer {
+    Allocator* owner;
+    size_t capacity;
+    uint64_t startTicks;
+    uint64_t startNs;
+    // note: measured once per process, on the first export that has events.
+    double nsPerTick;
+    _Atomic(TraceBuffer*) buffers;
+    atomic_uint nextThreadId;
+    atomic_uint generation;
+    atomic_bool enabled;
+};
+
+static Tracer tracer;
+static once_flag tracerCalibrated = ONCE_FLAG_INIT;
+
+static _Thread_local TraceBuffer* threadBuffer = NULL;
+static _Thread_local unsigned threadGeneration = 0;
+static _Thread_local bool threadMuted = false;
+
+static uint64_t Trace_nowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// note: the TSC is far cheaper than a clock call; it's converted to ns at export.
+static inline uint64_t Trace_nowTicks(void) {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return Trace_nowNs();
+#endif
+}
+
+// Times the tick rate against the clock since Trace_init, waiting a little if
+//  that's very short. The TSC rate is fixed, so the result is kept for later traces.
+static void Trace_calibrate(void) {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    uint64_t endNs = Trace_nowNs();
+    while (endNs - tracer.startNs < MIN_CALIBRATION_NS) {
+        endNs = Trace_nowNs();
+    }
+    const uint64_t endTicks = Trace_nowTicks();
+    tracer.nsPerTick = (double)(endNs - tracer.startNs) / (double)n5_max(endTicks - tracer.startTicks, 1);
+#else
+    tracer.nsPerTick = 1.0;
+#endif
+}
+
+bool Trace_init(Allocator *const owner, const size_t eventsPerThread) {
+    assert(owner != NULL);
+
+    if (atomic_load(&tracer.enabled)) {
+        fprintf(stderr, "[Trace] error: tracing is already initialized.\n");
+        return false;
+    }
+
+    tracer.owner = owner;
+    tracer.capacity = n5_nextPow2(n5_max(eventsPerThread, MIN_EVENTS));
+    tracer.startNs = Trace_nowNs();
+    tracer.startTicks = Trace_nowTicks();
+    atomic_store(&tracer.buffers, NULL);
+    atomic_store(&tracer.nextThreadId, 0);
+    atomic_fetch_add(&tracer.generation, 1);
+    atomic_store(&tracer.enabled, true);
+    return true;
+}
+
+void Trace_deinit(void) {
+    if (!atomic_exchange(&tracer.enabled, false)) {
+        return;
+    }
+
+    TraceBuffer* buffer = atomic_exchange(&tracer.buffers, NULL);
+    while (buffer != NULL) {
+        TraceBuffer *const next = buffer->next;
+        Arena_deinit(&buffer->arena);
+        Allocator_destroyItem(tracer.owner, buffer);
+        buffer = next;
+    }
+    threadBuffer = NULL;
+}
+
+static TraceBuffer* Trace_createBuffer(void) {
+    TraceBuffer *const buffer = Allocator_createItem(tracer.owner, TraceBuffer);
+    if (buffer == NULL) {
+        return NULL;
+    }
+    *buffer = (TraceBuffer) { .threadId = atomic_fetch_add(&tracer.nextThreadId, 1) };
+    atomic_init(&buffer->head, 0);
+
+    if (!Arena_init(&buffer->arena, tracer.owner, tracer.capacity * sizeof(TraceEvent))) {
+        goto error;
+    }
+    buffer->events.data = Allocator_alloc(&buffer->arena.base, TraceEvent, tracer.capacity).data;
+    buffer->events.size = tracer.capacity;
+    if (buffer->events.data == NULL) {
+        Arena_deinit(&buffer->arena);
+        goto error;
+    }
+    return buffer;
+
+error:
+    Allocator_destroyItem(tracer.owner, buffer);
+    return NULL;
+}
+
+// note: the allocators are instrumented too, so the thread is muted while its
+//  buffer is allocated rather than recursing.
+static void Trace_registerThread(void) {
+    threadMuted = true;
+
+    TraceBuffer *const buffer = Trace_createBuffer();
+    if (buffer != NULL) {
+        buffer->next = atomic_load(&tracer.buffers);
+        while (!atomic_compare_exchange_weak(&tracer.buffers, &buffer->next, buffer)) {
+        }
+    } else {
+        fprintf(stderr, "[Trace] error: failed to allocate a thread buffer.\n");
+    }
+
+    threadBuffer = buffer;
+    threadGeneration = atomic_load(&tracer.generation);
+    threadMuted = false;
+}
+
+void Trace_record(const TraceKind kind, const char *const name, const int64_t value) {
+    if (!atomic_load_explicit(&tracer.enabled, memory_order_relaxed) || threadMuted) {
+        return;
+    }
+
+    // note: a NULL buffer for the current generation means allocation failed; don't retry.
+    if (threadGeneration != atomic_load_explicit(&tracer.generation, memory_order_relaxed)) {
+        Trace_registerThread();
+    }
+    TraceBuffer *const buffer = threadBuffer;
+    if (buffer == NULL) {
+        return;
+    }
+
+    const size_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    buffer->events.data[head & (buffer->events.size - 1)] = (TraceEvent) {
+        .timestamp = Trace_nowTicks(),
+        .name = name,
+        .value = value,
+        .kind = kind,
+    };
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+// Chrome traces want microseconds; keep the nanoseconds as three decimals.
+static bool Trace_formatMicros(String *const self, const void *const ctx) {
+    const uint64_t ns = *(const uint64_t*)ctx;
+    const uint64_t fraction = ns % 1000;
+    return String_append_u64(self, ns / 1000, false)
+        && String_append_char(self, '.')
+        && String_append_char(self, (char)('0' + fraction / 100))
+        && String_append_char(self, (char)('0' + fraction / 10 % 10))
+        && String_append_char(self, (char)('0' + fraction % 10));
+}
+
+// Names are arbitrary C strings, so they're quoted and escaped as JSON strings.
+static bool Trace_formatName(String *const self, const void *const ctx) {
+    JsonWriter writer = JsonWriter_from(self);
+    return JsonWriter_write_str(&writer, *(const cstr*)ctx);
+}
+
+bool Trace_export(String *const out) {
+    assert(out != NULL);
+
+    if (!atomic_load(&tracer.enabled)) {
+        fprintf(stderr, "[Trace] error: tracing isn't initialized.\n");
+        return false;
+    }
+
+    // note: timestamps only need converting if there are any, so an empty trace
+    //  (e.g. with N5_TRACE compiled out) never waits on the calibration.
+    for (const TraceBuffer* buffer = atomic_load(&tracer.buffers); buffer != NULL; buffer = buffer->next) {
+        if (atomic_load_explicit(&buffer->head, memory_order_acquire) > 0) {
+            call_once(&tracerCalibrated, Trace_calibrate);
+            break;
+        }
+    }
+    const double nsPerTick = tracer.nsPerTick;
+
+    // note: mute this thread so the String_format calls below don't trace into the buffers being read.
+    threadMuted = true;
+
+    String line = String_new(out->owner, 128);
+    bool success = String_append_str(out, cstr_literal("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    bool first = true;
+
+    for (const TraceBuffer* buffer = atomic_load(&tracer.buffers); buffer != NULL && success; buffer = buffer->next) {
+        success &= String_format(
+            &line,
+            cstr_literal("{}\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"n5 thread {}\"}}}}"),
+            FormatArg_str(first ? cstr_literal("") : cstr_literal(",")),
+            FormatArg_u64(buffer->threadId),
+            FormatArg_u64(buffer->threadId)
+        );
+        success &= String_append_str(out, cstr_cast(line.str));
+        first = false;
+
+        // note: after a wrap, drop ends whose begins were overwritten so spans stay nested.
+        const size_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+        const size_t start = (head > buffer->events.size) ? head - buffer->events.size : 0;
+        size_t depth = 0;
+        for (size_t i = start; i < head && success; ++i) {
+            const TraceEvent event = buffer->events.data[i & (buffer->events.size - 1)];
+            if (event.kind == trace_end && depth == 0) {
+                continue;
+            }
+            depth += (event.kind == trace_begin);
+            depth -= (event.kind == trace_end);
+
+            const uint64_t ns = (event.timestamp >= tracer.startTicks)
+                ? (uint64_t)((double)(event.timestamp - tracer.startTicks) * nsPerTick)
+                : 0;
+            const cstr name = Slice_from(event.name, strlen(event.name));
+            if (event.kind == trace_counter) {
+                success &= String_format(
+                    &line,
+                    cstr_literal(",\n{{\"name\":{},\"ph\":\"C\",\"ts\":{},\"pid\":1,\"tid\":{},\"args\":{{\"value\":{}}}}}"),
+                    FormatArg_custom(Trace_formatName, &name),
+                    FormatArg_custom(Trace_formatMicros, &ns),
+                    FormatArg_u64(buffer->threadId),
+                    FormatArg_i64(event.value)
+                );
+            } else {
+                success &= String_format(
+                    &line,
+                    cstr_literal(",\n{{\"name\":{},\"ph\":\"{}\",\"ts\":{},\"pid\":1,\"tid\":{}}}"),
+                    FormatArg_custom(Trace_formatName, &name),
+                    FormatArg_char((event.kind == trace_begin) ? 'B' : 'E'),
+                    FormatArg_custom(Trace_formatMicros, &ns),
+                    FormatArg_u64(buffer->threadId)
+                );
+            }
+            success &= String_append_str(out, cstr_cast(line.str));
+        }
+    }
+
+    success &= String_append_str(out, cstr_literal("\n]}\n"));
+    String_free(&line);
+    threadMuted = false;
+
+    if (!success) {
+        fprintf(stderr, "[Trace] error: failed to build the trace.\n");
+    }
+    return success;
+}
@@ -0,0 +1,169 @@
+#include "n5/vec.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "n5/utils.h"
+
+#define MIN_CAPACITY 4
+
+// note: the item type isn't available here, but its alignment always divides its size
+//  (and never exceeds max_align_t for non-overaligned types).
+static size_t VecRaw_align(const size_t itemSize) {
+    return n5_min(itemSize & (~itemSize + 1), alignof(max_align_t));
+}
+
+static bool VecRaw_realloc(
+    VecRaw *const self,
+    const size_t itemSize,
+    const size_t capacity,
+    const DebugInfo debugInfo
+) {
+    assert(self->owner != NULL);
+
+    const Block current = {
+        .data = self->items.data,
+        .size = self->capacity * itemSize,
+    };
+
+    if (capacity == 0) {
+        if (current.data != NULL) {
+            (*self->owner)->free(self->owner, &(FreeInfo) { .memory = current, .debugInfo = debugInfo });
+        }
+        self->items.data = NULL;
+        self->capacity = 0;
+        return true;
+    }
+
+    if (current.data != NULL && (*self->owner)->resize != NULL && (*self->owner)->resize(
+        self->owner,
+        &(ResizeInfo) { .memory = current, .size = capacity * itemSize, .debugInfo = debugInfo }
+    )) {
+        self->capacity = capacity;
+        return true;
+    }
+
+    const Block memory = (*self->owner)->alloc(self->owner, &(AllocInfo) {
+        .size = capacity * itemSize,
+        .align = VecRaw_align(itemSize),
+        .debugInfo = debugInfo,
+    });
+    if (memory.data == NULL) {
+        return false;
+    }
+
+    if (current.data != NULL) {
+        memcpy(memory.data, current.data, self->items.size * itemSize);
+        (*self->owner)->free(self->owner, &(FreeInfo) { .memory = current, .debugInfo = debugInfo });
+    }
+
+    self->items.data = memory.data;
+    self->capacity = capacity;
+    return true;
+}
+
+void VecRaw_free(VecRaw *const self, const size_t itemSize, const DebugInfo debugInfo) {
+    assert(self != NULL);
+    VecRaw_realloc(self, itemSize, 0, debugInfo);
+    self->items.size = 0;
+}
+
+bool VecRaw_reserve(
+    VecRaw *const self,
+    const size_t itemSize,
+    const size_t minCapacity,
+    const DebugInfo debugInfo
+) {
+    assert(self != NULL);
+
+    if (self->capacity >= minCapacity) {
+        return true;
+    }
+
+    if (minCapacity > SIZE_MAX / itemSize) {
+        return false;
+    }
+
+    size_t capacity = n5_max(self->capacity * 2, MIN_CAPACITY);
+    capacity = n5_max(capacity, minCapacity);
+    return VecRaw_realloc(self, itemSize, capacity, debugInfo);
+}
+
+bool VecRaw_shrinkToFit(VecRaw *const self, const size_t itemSize, const DebugInfo debugInfo) {
+    assert(self != NULL);
+
+    if (self->capacity == self->items.size) {
+        return true;
+    }
+    return VecRaw_realloc(self, itemSize, self->items.size, debugInfo);
+}
+
+bool VecRaw_insertGap(
+    VecRaw *const self,
+    const size_t itemSize,
+    const size_t index,
+    const DebugInfo debugInfo
+) {
+    assert(self != NULL);
+    assert(index <= self->items.size);
+
+    if (!VecRaw_reserve(self, itemSize, self->items.size + 1, debugInfo)) {
+        return false;
+    }
+
+    uint8_t *const at = (uint8_t*)self->items.data + index * itemSize;
+    memmove(at + itemSize, at, (self->items.size - index) * itemSize);
+    ++self->items.size;
+    return true;
+}
+
+void VecRaw_swapToBack(VecRaw *const self, const size_t itemSize, const size_t index) {
+    assert(self != NULL);
+    assert(index < self->items.size);
+
+    const size_t last = self->items.size - 1;
+    if (index == last) {
+        return;
+    }
+
+    uint8_t *const a = (uint8_t*)self->items.data + index * itemSize;
+    uint8_t *const b = (uint8_t*)self->items.data + last * itemSize;
+    for (size_t i = 0; i < itemSize; ++i) {
+        const uint8_t tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+bool VecRaw_extend(
+    VecRaw *const self,
+    const size_t itemSize,
+    const void *const items,
+    const size_t count,
+    const DebugInfo debugInfo
+) {
+    assert(self != NULL);
+
+    if (count == 0) {
+        return true;
+    }
+    assert(items != NULL);
+
+    // edge case: 'items' is a subslice of 'self'
+    intptr_t localOffset = (const uint8_t*)items - (const uint8_t*)self->items.data;
+    if (self->items.data == NULL || localOffset < 0 || (size_t)localOffset >= self->items.size * itemSize) {
+        localOffset = -1;
+    }
+
+    if (!VecRaw_reserve(self, itemSize, self->items.size + count, debugInfo)) {
+        return false;
+    }
+
+    const void *const source = (localOffset >= 0)
+        ? (const uint8_t*)self->items.data + localOffset
+        : items;
+    memcpy((uint8_t*)self->items.data + self->items.size * itemSize, source, count * itemSize);
+    self->items.size += count;
+    return true;
+}
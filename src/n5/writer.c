@@ -0,0 +1,619 @@
+#include "n5/writer.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define WRITER_URING 1
+#else
+#define WRITER_URING 0
+#endif
+
+#include "n5/utils.h"
+
+#define MIN_QUEUE_DEPTH 8
+#define MAX_QUEUE_DEPTH 4096
+#define MAX_IOVECS 1024
+// note: smaller writes are copied into a staging block instead of queued; the
+//  kernel spends ~30ns per iovec, more than copying a short record costs.
+#define COALESCE_MAX 512
+#define STAGING_SIZE (64 * 1024)
+
+static inline AsyncWrite* AsyncWriter_entry(const AsyncWriter *const self, const size_t index) {
+    return &self->entries.data[index & self->mask];
+}
+
+// Returns every buffer the backend has finished with, in queue order.
+static void AsyncWriter_release(AsyncWriter *const self, const size_t completed) {
+    for (; self->reaped < completed; ++self->reaped) {
+        AsyncWrite *const entry = AsyncWriter_entry(self, self->reaped);
+        if (entry->owner != NULL && entry->memory.data != NULL) {
+            Allocator_free(entry->owner, entry->memory);
+        }
+        *entry = (AsyncWrite) { 0 };
+    }
+}
+
+#if WRITER_URING
+
+// The kernel-shared rings, mapped as io_uring_setup describes them.
+struct AsyncRing {
+    int fd;
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe* sqes;
+    size_t sqesSize;
+    uint32_t* sqTail;
+    uint32_t* sqMask;
+    uint32_t* sqArray;
+    uint32_t* cqHead;
+    uint32_t* cqTail;
+    uint32_t* cqMask;
+    struct io_uring_cqe* cqes;
+    uint32_t pending;
+    // note: one per queue entry, so a batch's iovecs are contiguous like its entries.
+    struct iovec* iovecs;
+};
+
+static void AsyncRing_deinit(AsyncRing *const self) {
+    if (self->sqes != NULL) {
+        munmap(self->sqes, self->sqesSize);
+    }
+    if (self->cqRing != NULL && self->cqRing != self->sqRing) {
+        munmap(self->cqRing, self->cqRingSize);
+    }
+    if (self->sqRing != NULL) {
+        munmap(self->sqRing, self->sqRingSize);
+    }
+    if (self->fd >= 0) {
+        close(self->fd);
+    }
+    *self = (AsyncRing) { .fd = -1 };
+}
+
+static bool AsyncRing_init(AsyncRing *const self, const uint32_t entries) {
+    *self = (AsyncRing) { .fd = -1 };
+
+    struct io_uring_params params = { 0 };
+    const long fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+    self->fd = (int)fd;
+
+    self->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    self->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        self->sqRingSize = self->cqRingSize = n5_max(self->sqRingSize, self->cqRingSize);
+    }
+
+    void *const sqRing = mmap(NULL, self->sqRingSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, self->fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        goto error;
+    }
+    self->sqRing = sqRing;
+
+    void* cqRing = sqRing;
+    if (!singleMap) {
+        cqRing = mmap(NULL, self->cqRingSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, self->fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            goto error;
+        }
+    }
+    self->cqRing = cqRing;
+
+    self->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *const sqes = mmap(NULL, self->sqesSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, self->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        goto error;
+    }
+    self->sqes = sqes;
+
+    uint8_t *const sq = sqRing;
+    uint8_t *const cq = cqRing;
+    self->sqTail = (uint32_t*)(sq + params.sq_off.tail);
+    self->sqMask = (uint32_t*)(sq + params.sq_off.ring_mask);
+    self->sqArray = (uint32_t*)(sq + params.sq_off.array);
+    self->cqHead = (uint32_t*)(cq + params.cq_off.head);
+    self->cqTail = (uint32_t*)(cq + params.cq_off.tail);
+    self->cqMask = (uint32_t*)(cq + params.cq_off.ring_mask);
+    self->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+
+error:
+    AsyncRing_deinit(self);
+    return false;
+}
+
+static bool AsyncRing_enter(AsyncRing *const self, const uint32_t minComplete) {
+    for (;;) {
+        const long result = syscall(__NR_io_uring_enter, self->fd, self->pending, minComplete,
+            (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (result >= 0) {
+            self->pending -= (uint32_t)result;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            fprintf(stderr, "[AsyncWriter] error: io_uring_enter failed (%s).\n", strerror(errno));
+            return false;
+        }
+    }
+}
+
+// A batch is tagged with its first entry and its size.
+//  note: only the low bits of the index matter, since entries are looked up by slot.
+static inline uint64_t AsyncRing_tag(const size_t first, const size_t count) {
+    return ((uint64_t)first << 16) | count;
+}
+
+// Queues one writev for the unwritten rest of entries [first, first + count),
+//  which lie back to back in the file and in the queue; nothing reaches the
+//  kernel until AsyncRing_enter.
+static void AsyncWriter_uringPush(AsyncWriter *const self, const size_t first, const size_t count) {
+    AsyncRing *const ring = self->ring;
+    struct iovec *const iovecs = &ring->iovecs[first & self->mask];
+    for (size_t i = 0; i < count; ++i) {
+        const AsyncWrite *const entry = AsyncWriter_entry(self, first + i);
+        iovecs[i] = (struct iovec) {
+            .iov_base = (void*)(entry->data.data + entry->written),
+            .iov_len = entry->data.size - entry->written,
+        };
+    }
+
+    const uint32_t tail = *ring->sqTail;
+    const uint32_t slot = tail & *ring->sqMask;
+    const AsyncWrite *const head = AsyncWriter_entry(self, first);
+
+    struct io_uring_sqe *const sqe = &ring->sqes[slot];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = self->fd;
+    sqe->off = head->offset + head->written;
+    sqe->addr = (uint64_t)(uintptr_t)iovecs;
+    sqe->len = (uint32_t)count;
+    sqe->user_data = AsyncRing_tag(first, count);
+
+    ring->sqArray[slot] = slot;
+    __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++ring->pending;
+}
+
+// Completions can arrive out of order; every batch carries its own file offset,
+//  so a short one is simply resubmitted from the first unfinished entry.
+static void AsyncWriter_uringPoll(AsyncWriter *const self) {
+    AsyncRing *const ring = self->ring;
+    uint32_t head = *ring->cqHead;
+    const uint32_t tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe *const cqe = &ring->cqes[head & *ring->cqMask];
+        const size_t first = (size_t)(cqe->user_data >> 16);
+        const size_t count = (size_t)(cqe->user_data & 0xffff);
+
+        const bool failed = cqe->res < 0 && cqe->res != -EINTR && cqe->res != -EAGAIN;
+        size_t remaining = (cqe->res > 0) ? (size_t)cqe->res : 0;
+        size_t done = 0;
+        for (; !failed && done < count; ++done) {
+            AsyncWrite *const entry = AsyncWriter_entry(self, first + done);
+            const size_t step = n5_min(remaining, entry->data.size - entry->written);
+            entry->written += step;
+            remaining -= step;
+            if (entry->written < entry->data.size) {
+                break;
+            }
+            entry->done = true;
+        }
+        if (done == count) {
+            continue;
+        }
+
+        if (failed || cqe->res == 0) {
+            fprintf(stderr, "[AsyncWriter] error: write failed (%s).\n", failed ? strerror(-cqe->res) : "no progress");
+            atomic_store(&self->failed, true);
+            for (; done < count; ++done) {
+                AsyncWriter_entry(self, first + done)->done = true;
+            }
+        } else {
+            AsyncWriter_uringPush(self, first + done, count - done);
+        }
+    }
+    __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+
+    while (self->completed < self->submitted && AsyncWriter_entry(self, self->completed)->done) {
+        ++self->completed;
+    }
+}
+
+// Sends everything queued as a few big writevs: one per run of entries up to
+//  the end of the queue's storage (or MAX_IOVECS).
+static bool AsyncWriter_uringSubmit(AsyncWriter *const self, const uint32_t minComplete) {
+    while (self->submitted < self->queued) {
+        const size_t first = self->submitted;
+        const size_t contiguous = self->entries.size - (first & self->mask);
+        const size_t count = n5_min(n5_min(self->queued - first, contiguous), (size_t)MAX_IOVECS);
+        AsyncWriter_uringPush(self, first, count);
+        self->submitted += count;
+    }
+
+    if (self->ring->pending == 0 && minComplete == 0) {
+        AsyncWriter_uringPoll(self);
+        return true;
+    }
+    if (!AsyncRing_enter(self->ring, minComplete)) {
+        // note: without a working ring nothing more will complete, so give up on what's in flight.
+        atomic_store(&self->failed, true);
+        self->ring->pending = 0;
+        self->completed = self->submitted;
+        return false;
+    }
+    AsyncWriter_uringPoll(self);
+    return true;
+}
+
+static bool AsyncWriter_uringWait(AsyncWriter *const self, const size_t target) {
+    bool success = AsyncWriter_uringSubmit(self, 0);
+    while (success && self->completed < target) {
+        success = AsyncWriter_uringSubmit(self, 1);
+    }
+    return success;
+}
+#else
+struct AsyncRing {
+    int unused;
+};
+#endif
+
+// The fallback backend: one thread drains [threadCompleted, threadSubmitted)
+//  with writev, appending at the fd's current position.
+static void AsyncWriter_publish(AsyncWriter *const self, const size_t completed) {
+    atomic_store_explicit(&self->threadCompleted, completed, memory_order_release);
+    mtx_lock(&self->lock);
+    cnd_broadcast(&self->progress);
+    mtx_unlock(&self->lock);
+}
+
+static int AsyncWriter_threadMain(void *const arg) {
+    AsyncWriter *const self = arg;
+    struct iovec iovecs[MAX_IOVECS];
+
+    size_t next = atomic_load(&self->threadCompleted);
+    for (;;) {
+        mtx_lock(&self->lock);
+        while (self->running && self->threadSubmitted == next) {
+            cnd_wait(&self->wake, &self->lock);
+        }
+        const size_t end = self->threadSubmitted;
+        const bool running = self->running;
+        mtx_unlock(&self->lock);
+
+        if (!running && end == next) {
+            return 0;
+        }
+
+        for (;;) {
+            // note: skip finished (e.g. empty) buffers so writev never sees an empty batch.
+            while (next < end && AsyncWriter_entry(self, next)->written == AsyncWriter_entry(self, next)->data.size) {
+                ++next;
+            }
+            if (next == end) {
+                break;
+            }
+
+            const size_t count = n5_min(end - next, (size_t)MAX_IOVECS);
+            for (size_t i = 0; i < count; ++i) {
+                const AsyncWrite *const entry = AsyncWriter_entry(self, next + i);
+                iovecs[i] = (struct iovec) {
+                    .iov_base = (void*)(entry->data.data + entry->written),
+                    .iov_len = entry->data.size - entry->written,
+                };
+            }
+
+            const ssize_t result = writev(self->fd, iovecs, (int)count);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                fprintf(stderr, "[AsyncWriter] error: write failed (%s).\n",
+                    (result < 0) ? strerror(errno) : "no progress");
+                atomic_store(&self->failed, true);
+                next += count;
+            } else {
+                size_t remaining = (size_t)result;
+                while (remaining > 0) {
+                    AsyncWrite *const entry = AsyncWriter_entry(self, next);
+                    const size_t step = n5_min(remaining, entry->data.size - entry->written);
+                    entry->written += step;
+                    remaining -= step;
+                    next += entry->written == entry->data.size;
+                }
+            }
+            AsyncWriter_publish(self, next);
+        }
+        AsyncWriter_publish(self, next);
+    }
+}
+
+static void AsyncWriter_threadSubmit(AsyncWriter *const self) {
+    if (self->threadSubmitted == self->queued) {
+        return;
+    }
+    mtx_lock(&self->lock);
+    self->threadSubmitted = self->queued;
+    cnd_signal(&self->wake);
+    mtx_unlock(&self->lock);
+    self->submitted = self->queued;
+}
+
+static void AsyncWriter_threadWait(AsyncWriter *const self, const size_t target) {
+    AsyncWriter_threadSubmit(self);
+    if (atomic_load_explicit(&self->threadCompleted, memory_order_acquire) >= target) {
+        return;
+    }
+    mtx_lock(&self->lock);
+    while (atomic_load_explicit(&self->threadCompleted, memory_order_acquire) < target) {
+        cnd_wait(&self->progress, &self->lock);
+    }
+    mtx_unlock(&self->lock);
+}
+
+static size_t AsyncWriter_completed(AsyncWriter *const self) {
+#if WRITER_URING
+    if (self->backend == async_backend_uring) {
+        return self->completed;
+    }
+#endif
+    return atomic_load_explicit(&self->threadCompleted, memory_order_acquire);
+}
+
+static bool AsyncWriter_startThread(AsyncWriter *const self) {
+    if (mtx_init(&self->lock, mtx_plain) != thrd_success) {
+        return false;
+    }
+    if (cnd_init(&self->wake) != thrd_success) {
+        mtx_destroy(&self->lock);
+        return false;
+    }
+    if (cnd_init(&self->progress) != thrd_success) {
+        cnd_destroy(&self->wake);
+        mtx_destroy(&self->lock);
+        return false;
+    }
+
+    self->running = true;
+    if (thrd_create(&self->thread, AsyncWriter_threadMain, self) != thrd_success) {
+        self->running = false;
+        cnd_destroy(&self->progress);
+        cnd_destroy(&self->wake);
+        mtx_destroy(&self->lock);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncWriter_init(AsyncWriter *const self, Allocator *const owner, const int fd, const size_t queueDepth, const AsyncBackend backend) {
+    assert(self != NULL);
+    assert(owner != NULL);
+    assert(fd >= 0);
+
+    const size_t capacity = n5_nextPow2(n5_clamp(queueDepth, MIN_QUEUE_DEPTH, MAX_QUEUE_DEPTH));
+    *self = (AsyncWriter) {
+        .owner = owner,
+        .fd = fd,
+        .entries = Allocator_createItems(owner, AsyncWrite, capacity),
+    };
+    atomic_init(&self->failed, false);
+    atomic_init(&self->threadCompleted, 0);
+    if (self->entries.data == NULL) {
+        fprintf(stderr, "[AsyncWriter] error: failed to allocate %zu entries.\n", capacity);
+        return false;
+    }
+    memset(self->entries.data, 0, capacity * sizeof(AsyncWrite));
+    self->mask = capacity - 1;
+    self->batchSize = capacity / 4;
+
+    // note: io_uring writes at explicit offsets, which only works for seekable, non-append fds.
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+    const int flags = fcntl(fd, F_GETFL);
+    const bool positional = position >= 0 && flags >= 0 && (flags & O_APPEND) == 0;
+
+    self->backend = async_backend_thread;
+#if WRITER_URING
+    if (backend != async_backend_thread && positional) {
+        AsyncRing *const ring = Allocator_createItem(owner, AsyncRing);
+        struct iovec *const iovecs = Allocator_alloc(owner, struct iovec, capacity).data;
+        if (ring != NULL && iovecs != NULL && AsyncRing_init(ring, (uint32_t)capacity)) {
+            ring->iovecs = iovecs;
+            self->ring = ring;
+            self->offset = (uint64_t)position;
+            self->backend = async_backend_uring;
+        } else {
+            if (iovecs != NULL) {
+                Allocator_free(owner, ((Block) { .data = iovecs, .size = capacity * sizeof(struct iovec) }));
+            }
+            if (ring != NULL) {
+                Allocator_destroyItem(owner, ring);
+            }
+        }
+    }
+#else
+    (void)positional;
+#endif
+
+    if (backend == async_backend_uring && self->backend != async_backend_uring) {
+        fprintf(stderr, "[AsyncWriter] error: io_uring is unavailable for this fd.\n");
+        goto error;
+    }
+
+    if (self->backend == async_backend_thread && !AsyncWriter_startThread(self)) {
+        fprintf(stderr, "[AsyncWriter] error: failed to start the writer thread.\n");
+        goto error;
+    }
+    return true;
+
+error:
+    Allocator_destroyItems(owner, self->entries);
+    *self = (AsyncWriter) { 0 };
+    return false;
+}
+
+void AsyncWriter_deinit(AsyncWriter *const self) {
+    assert(self != NULL);
+
+    AsyncWriter_flush(self);
+
+#if WRITER_URING
+    if (self->ring != NULL) {
+        Allocator_free(self->owner, ((Block) { .data = self->ring->iovecs, .size = self->entries.size * sizeof(struct iovec) }));
+        AsyncRing_deinit(self->ring);
+        Allocator_destroyItem(self->owner, self->ring);
+    }
+#endif
+
+    if (self->running) {
+        mtx_lock(&self->lock);
+        self->running = false;
+        cnd_signal(&self->wake);
+        mtx_unlock(&self->lock);
+        thrd_join(self->thread, NULL);
+        cnd_destroy(&self->progress);
+        cnd_destroy(&self->wake);
+        mtx_destroy(&self->lock);
+    }
+
+    // note: flushed above, so this can only be an empty block left for reuse.
+    if (self->staging.data != NULL) {
+        Allocator_free(self->owner, self->staging);
+    }
+    Allocator_destroyItems(self->owner, self->entries);
+    *self = (AsyncWriter) { 0 };
+}
+
+// Adds one entry to the queue, submitting a batch once enough is queued.
+static void AsyncWriter_queue(AsyncWriter *const self, const cstr data, Allocator *const owner, const Block memory) {
+    // note: make room by waiting for the oldest write, which frees at least one slot.
+    if (self->queued - self->reaped == self->entries.size) {
+#if WRITER_URING
+        if (self->backend == async_backend_uring) {
+            AsyncWriter_uringWait(self, self->reaped + 1);
+        } else
+#endif
+        {
+            AsyncWriter_threadWait(self, self->reaped + 1);
+        }
+        AsyncWriter_release(self, AsyncWriter_completed(self));
+    }
+
+    AsyncWrite *const entry = AsyncWriter_entry(self, self->queued);
+    *entry = (AsyncWrite) {
+        .data = data,
+        .owner = owner,
+        .memory = memory,
+        .offset = self->offset,
+    };
+    self->offset += data.size;
+    ++self->queued;
+
+    const uint64_t unsubmitted = self->offset - AsyncWriter_entry(self, self->submitted)->offset;
+    if (self->queued - self->submitted >= self->batchSize || unsubmitted >= STAGING_SIZE) {
+#if WRITER_URING
+        if (self->backend == async_backend_uring) {
+            AsyncWriter_uringSubmit(self, 0);
+        } else
+#endif
+        {
+            AsyncWriter_threadSubmit(self);
+        }
+    }
+    AsyncWriter_release(self, AsyncWriter_completed(self));
+}
+
+// Queues the staging block, if it holds anything; the writer frees it once written.
+static void AsyncWriter_queueStaging(AsyncWriter *const self) {
+    if (self->stagingSize == 0) {
+        return;
+    }
+    const cstr data = (cstr)Slice_from((const char*)self->staging.data, self->stagingSize);
+    AsyncWriter_queue(self, data, self->owner, self->staging);
+    self->staging = (Block) { 0 };
+    self->stagingSize = 0;
+}
+
+bool AsyncWriter_write(AsyncWriter *const self, const cstr data, Allocator *const owner, const Block memory) {
+    assert(self != NULL);
+    assert(self->entries.data != NULL);
+
+    if (data.size <= COALESCE_MAX) {
+        if (self->stagingSize + data.size > self->staging.size) {
+            AsyncWriter_queueStaging(self);
+        }
+        if (self->staging.data == NULL) {
+            self->staging = Allocator_alloc(self->owner, uint8_t, STAGING_SIZE);
+        }
+        // note: without a staging block the record is just queued on its own.
+        if (self->staging.data != NULL) {
+            memcpy((uint8_t*)self->staging.data + self->stagingSize, data.data, data.size);
+            self->stagingSize += data.size;
+            if (owner != NULL && memory.data != NULL) {
+                Allocator_free(owner, memory);
+            }
+            return !atomic_load(&self->failed);
+        }
+    }
+
+    // note: whatever is staged was written first, so it goes out first.
+    AsyncWriter_queueStaging(self);
+    AsyncWriter_queue(self, data, owner, memory);
+    return !atomic_load(&self->failed);
+}
+
+bool AsyncWriter_writeString(AsyncWriter *const self, String *const string) {
+    assert(self != NULL);
+    assert(string != NULL);
+
+    if (string->str.data == NULL) {
+        return !atomic_load(&self->failed);
+    }
+
+    const cstr data = (cstr)Slice_from(string->str.data, string->str.size);
+    const Block memory = { .data = string->str.data, .size = string->capacity + 1 };
+    Allocator *const owner = string->owner;
+    *string = (String) { .owner = owner };
+    return AsyncWriter_write(self, data, owner, memory);
+}
+
+bool AsyncWriter_flush(AsyncWriter *const self) {
+    assert(self != NULL);
+
+    if (self->entries.data == NULL) {
+        return false;
+    }
+
+    AsyncWriter_queueStaging(self);
+#if WRITER_URING
+    if (self->backend == async_backend_uring) {
+        AsyncWriter_uringWait(self, self->queued);
+        // note: positional writes leave the fd's offset alone, so move it past what we wrote.
+        lseek(self->fd, (off_t)self->offset, SEEK_SET);
+    } else
+#endif
+    {
+        AsyncWriter_threadWait(self, self->queued);
+    }
+    AsyncWriter_release(self, AsyncWriter_completed(self));
+    return !atomic_load(&self->failed);
+}
@@ -1,14 +1,84 @@
 #include <assert.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <threads.h>
 
 #include "n5/alloc.h"
+#include "n5/binary.h"
+#include "n5/csv.h"
+#include "n5/encoding.h"
 #include "n5/format.h"
+#include "n5/hashmap.h"
+#include "n5/io.h"
+#include "n5/jobs.h"
+#include "n5/json.h"
+#include "n5/log.h"
+#include "n5/queue.h"
+#include "n5/radix.h"
 #include "n5/slice.h"
+#include "n5/slotmap.h"
+#include "n5/sort.h"
 #include "n5/str.h"
 #include "n5/string.h"
+#include "n5/trace.h"
 #include "n5/utils.h"
+#include "n5/vec.h"
+#if !defined(_WIN32)
+#include "n5/writer.h"
+#endif
+
+typedef struct Point {
+    int64_t x;
+    int64_t y;
+} Point;
+
+static bool Point_format(String *const self, const void *const ctx) {
+    const Point *const point = ctx;
+    return String_append_char(self, '(')
+        && String_append_i64(self, point->x, false)
+        && String_append_str(self, cstr_literal(", "))
+        && String_append_i64(self, point->y, false)
+        && String_append_char(self, ')');
+}
+
+typedef struct SquareSums {
+    Slice(const int64_t) nums;
+    atomic_llong total;
+} SquareSums;
+
+static void SquareSums_chunk(JobWorker *const worker, void *const ctx, const size_t begin, const size_t end) {
+    SquareSums *const sums = ctx;
+
+    // job-local scratch comes from the worker's arena.
+    Slice(int64_t) squares = Allocator_createItems(&worker->arena.base, int64_t, end - begin);
+    int64_t total = 0;
+    for (size_t i = begin; i < end; ++i) {
+        squares.data[i - begin] = sums->nums.data[i] * sums->nums.data[i];
+        total += squares.data[i - begin];
+    }
+    Allocator_destroyItems(&worker->arena.base, squares);
+
+    atomic_fetch_add(&sums->total, total);
+}
+
+static bool printRoute(void *const ctx, const cstr key, void *const value) {
+    (void)ctx;
+    printf("| %.*s -> %u\n", (int)key.size, key.data, *(const uint32_t*)value);
+    return true;
+}
+
+// Pushes 1..100 through the queue, retrying while it's full.
+static int SpscQueue_produce(void *const ctx) {
+    SpscQueue *const queue = ctx;
+    for (int64_t i = 1; i <= 100; ++i) {
+        while (!SpscQueue_push(queue, &i)) {
+            thrd_yield();
+        }
+    }
+    return 0;
+}
 
 int32_t main(const int32_t argc, const char *const argv[]) {
     printf("Running with %d arg(s):\n", argc);
@@ -145,6 +215,35 @@ int32_t main(const int32_t argc, const char *const argv[]) {
             Slice_compare(cstr_cast(local), literal)
         );
 
+        const cstr text = cstr_literal("the quick brown fox jumps over the lazy dog");
+        printf(
+            "simd level %d - findChar('q'): %zu, countChar('o'): %zu, equals: %d\n",
+            (int)n5_simd->level,
+            cstr_findChar(text, 'q'),
+            cstr_countChar(text, 'o'),
+            Slice_equals(text, cstr_literal("the quick brown fox jumps over the lazy dog"))
+        );
+
+        str header = str_local("  Content-Type \r\n");
+        const cstr name = cstr_trim(cstr_cast(header));
+        printf(
+            "cstr_trim: '%.*s', equalsIgnoreCase: %d, compareIgnoreCase: %d, same hash: %d\n",
+            (int)name.size,
+            name.data,
+            cstr_equalsIgnoreCase(name, cstr_literal("content-type")),
+            cstr_compareIgnoreCase(name, cstr_literal("CONTENT-LENGTH")),
+            cstr_hashIgnoreCase(name) == cstr_hashIgnoreCase(cstr_literal("CONTENT-TYPE"))
+        );
+        str_toUpper(header);
+        printf("str_toUpper: '%.*s', ", (int)name.size, name.data);
+        str_toLower(header);
+        printf("str_toLower: '%.*s'\n", (int)name.size, name.data);
+
+        int32_t filled[5];
+        const int32_t fillValue = -3;
+        Slice_fill(((Slice(int32_t))Slice_fromArray(filled)), fillValue);
+        printf("Slice_fill: %d, %d, %d, %d, %d\n", filled[0], filled[1], filled[2], filled[3], filled[4]);
+
         String dynamicString = String_from(&mainAlloc.base, cstr_literal("Hello"));
         printf(
             "String_from (capacity: %zu, size: %zu): %s\n",
@@ -184,9 +283,579 @@ int32_t main(const int32_t argc, const char *const argv[]) {
             dynamicString.str.data
         );
 
+        const Point points[] = { { 1, 2 }, { -3, 4 }, { 5, -6 } };
+        const int64_t nums[] = { 1, 1, 2, 3, 5, 8 };
+        String_format(
+            &dynamicString,
+            cstr_literal("Custom point {}, points [{}], nums [{}]."),
+            FormatArg_custom(Point_format, &points[0]),
+            FormatArg_slice((Slice(const Point))Slice_fromArray(points), Point_format, cstr_literal(" ")),
+            FormatArg_slice((Slice(const int64_t))Slice_fromArray(nums), Format_i64, cstr_literal(", "))
+        );
+        printf(
+            "String_format custom (capacity: %zu, size: %zu): %s\n",
+            dynamicString.capacity,
+            dynamicString.str.size,
+            dynamicString.str.data
+        );
+
         String_free(&dynamicString);
     }
 
+    printf("\n");
+
+    {
+        Vec(int64_t) nums = Vec_new(&mainAlloc.base);
+        for (int64_t i = 0; i < 10; ++i) {
+            Vec_push(&nums, i * i);
+        }
+        Vec_insert(&nums, 0, -1);
+        const int64_t removed = Vec_swapRemove(&nums, 2);
+        const int64_t popped = Vec_pop(&nums);
+        Vec_extend(&nums, ((Slice(int64_t))Slice_fromArray(((int64_t[]) { 100, 200 }))));
+
+        printf(
+            "Vec (capacity: %zu, size: %zu, removed: %lld, popped: %lld): ",
+            nums.capacity,
+            nums.items.size,
+            (long long)removed,
+            (long long)popped
+        );
+        for (size_t i = 0; i < nums.items.size; ++i) {
+            printf("%lld, ", (long long)nums.items.data[i]);
+        }
+        printf("\n");
+
+        Vec_shrinkToFit(&nums);
+        printf("Vec_shrinkToFit (capacity: %zu)\n", nums.capacity);
+        Vec_free(&nums);
+
+        Arena arena;
+        bool success = Arena_init(&arena, &mainAlloc.base, 256);
+        assert(success);
+
+        Vec(char) chars = Vec_new(&arena.base);
+        for (char c = 'a'; c <= 'z'; ++c) {
+            Vec_push(&chars, c);
+        }
+        printf(
+            "Vec in Arena (capacity: %zu, size: %zu, arena offset: %zu): %.*s\n",
+            chars.capacity,
+            chars.items.size,
+            arena.offset,
+            (int)chars.items.size,
+            chars.items.data
+        );
+        Vec_free(&chars);
+        Arena_deinit(&arena);
+    }
+
+    printf("\n");
+
+    {
+        SlotMap(Point) points = SlotMap_new(&mainAlloc.base);
+        SlotHandle handles[4];
+        for (int64_t i = 0; i < 4; ++i) {
+            bool success = SlotMap_insert(&points, ((Point) { i, i * 10 }), &handles[i]);
+            assert(success);
+        }
+        SlotMap_remove(&points, handles[1]);
+
+        SlotHandle reused;
+        SlotMap_insert(&points, ((Point) { 7, 70 }), &reused);
+        printf(
+            "SlotMap (size: %zu) - slot %u reused (generation %u -> %u), stale handle found: %d\n",
+            points.items.size,
+            reused.index,
+            handles[1].generation,
+            reused.generation,
+            SlotMap_get(&points, handles[1]) != NULL
+        );
+        for (size_t i = 0; i < points.items.size; ++i) {
+            const SlotHandle handle = SlotMap_handleAt(&points, i);
+            printf("| slot %u: (%lld, %lld)\n", handle.index, (long long)points.items.data[i].x, (long long)points.items.data[i].y);
+        }
+        SlotMap_free(&points);
+    }
+
+    printf("\n");
+
+    {
+        RadixTree routes;
+        RadixTree_init(&routes, &mainAlloc.base, sizeof(uint32_t));
+        const cstr paths[] = {
+            cstr_literal("/"), cstr_literal("/api"), cstr_literal("/api/users"),
+            cstr_literal("/api/users/me"), cstr_literal("/api/orders"), cstr_literal("/static"),
+        };
+        for (size_t i = 0; i < n5_arraySize(paths); ++i) {
+            *(uint32_t*)RadixTree_insert(&routes, paths[i]) = (uint32_t)i;
+        }
+        RadixTree_remove(&routes, cstr_literal("/static"));
+
+        size_t matched = 0;
+        const uint32_t *const route = RadixTree_longestPrefix(&routes, cstr_literal("/api/users/42/posts"), &matched);
+        printf("RadixTree (size: %zu) - /api/users/42/posts routes to %u (%zu bytes matched)\n", routes.size, *route, matched);
+        RadixTree_withPrefix(&routes, cstr_literal("/api/u"), printRoute, NULL);
+        RadixTree_deinit(&routes);
+    }
+
+    printf("\n");
+
+    {
+        const cstr message = cstr_literal("n5 encodes \x00\xff!");
+        String encoded = String_new(&mainAlloc.base, 0);
+        Hex_encode(&encoded, message, false);
+        String_append_char(&encoded, ' ');
+        Base64_encode(&encoded, message, base64_standard);
+        printf("Encoded: %.*s\n", (int)encoded.str.size, encoded.str.data);
+
+        char decoded[32];
+        const size_t split = cstr_findChar(cstr_cast(encoded.str), ' ');
+        const DecodeResult hex = Hex_decode(cstr_slice(encoded.str, 0, split), (Block) { decoded, sizeof(decoded) });
+        const bool hexMatches = hex.size == message.size && memcmp(decoded, message.data, message.size) == 0;
+        const DecodeResult base64 = Base64_decode(cstr_slice(encoded.str, split + 1, encoded.str.size - split - 1), (Block) { decoded, sizeof(decoded) }, base64_standard);
+        printf("| round trips: %d %d\n", hexMatches, base64.size == message.size && memcmp(decoded, message.data, message.size) == 0);
+
+        // note: prints an error pointing at the '!'.
+        const DecodeResult bad = Base64_decode(cstr_literal("bjUg!w=="), (Block) { decoded, sizeof(decoded) }, base64_standard);
+        printf("| bad input: error %d at byte %zu after %zu bytes\n", bad.error, bad.offset, bad.size);
+        String_free(&encoded);
+    }
+
+    printf("\n");
+
+    {
+        HashMap counts;
+        HashMap_init(&counts, &mainAlloc.base, hash_key_cstr, sizeof(uint64_t));
+
+        const cstr words[] = {
+            cstr_literal("the"), cstr_literal("quick"), cstr_literal("fox"), cstr_literal("jumps"),
+            cstr_literal("over"), cstr_literal("the"), cstr_literal("lazy"), cstr_literal("fox"),
+        };
+        for (size_t i = 0; i < n5_arraySize(words); ++i) {
+            ++*(uint64_t*)HashMap_insert(&counts, words[i]);
+        }
+        HashMap_remove(&counts, cstr_literal("lazy"));
+
+        printf("HashMap cstr (capacity: %zu, size: %zu):\n", counts.capacity, counts.size);
+        const cstr queries[] = { cstr_literal("the"), cstr_literal("fox"), cstr_literal("lazy") };
+        for (size_t i = 0; i < n5_arraySize(queries); ++i) {
+            const uint64_t* count = HashMap_get(&counts, queries[i]);
+            printf("| %.*s: %lld\n", (int)queries[i].size, queries[i].data, count ? (long long)*count : -1ll);
+        }
+        HashMap_deinit(&counts);
+
+        HashMap squares;
+        HashMap_init(&squares, &mainAlloc.base, hash_key_u64, sizeof(uint64_t));
+        HashMap_reserve(&squares, 100);
+        for (uint64_t i = 0; i < 100; ++i) {
+            *(uint64_t*)HashMap_insert(&squares, i) = i * i;
+        }
+        for (uint64_t i = 0; i < 100; i += 2) {
+            HashMap_remove(&squares, i);
+        }
+        size_t missing = 0;
+        for (uint64_t i = 1; i < 100; i += 2) {
+            const uint64_t* square = HashMap_get(&squares, i);
+            missing += (square == NULL || *square != i * i);
+        }
+        printf(
+            "HashMap u64 (capacity: %zu, size: %zu, missing after removals: %zu)\n",
+            squares.capacity,
+            squares.size,
+            missing
+        );
+        HashMap_deinit(&squares);
+    }
+
+    printf("\n");
+
+    {
+        int64_t nums[] = { 42, -7, 1000000000000, 0, -9000000000, 3, 42, -1 };
+        sort_radix_i64((i64s)Slice_fromArray(nums), &mainAlloc.base, 1);
+        printf("sort_radix_i64: ");
+        for (size_t i = 0; i < n5_arraySize(nums); ++i) {
+            printf("%lld, ", (long long)nums[i]);
+        }
+        printf("\n");
+
+        cstr names[] = {
+            cstr_literal("banana"), cstr_literal("apple"), cstr_literal("app"), cstr_literal(""),
+            cstr_literal("cherry"), cstr_literal("apples"), cstr_literal("b"), cstr_literal("banana"),
+        };
+        sort_radix_cstr((cstrs)Slice_fromArray(names), &mainAlloc.base, 1);
+        printf("sort_radix_cstr: ");
+        for (size_t i = 0; i < n5_arraySize(names); ++i) {
+            printf("'%.*s', ", (int)names[i].size, names[i].data);
+        }
+        printf("\n");
+    }
+
+    printf("\n");
+
+    {
+        const char path[] = "n5_io_test.txt";
+        FILE* file = fopen(path, "wb");
+        assert(file != NULL);
+        fputs("first line\na line that is longer than the reader's buffer, so it straddles refills and has to grow it\n\nlast line, no newline", file);
+        fclose(file);
+
+        const cstr view = n5_file_map(path, file_advice_sequential | file_advice_willneed);
+        printf("n5_file_map (size: %zu, lines: %zu):\n", view.size, cstr_countChar(view, '\n') + 1);
+        cstr rest = view;
+        cstr line;
+        while (cstr_splitNext(&rest, '\n', &line)) {
+            printf("| '%.*s'\n", (int)line.size, line.data);
+        }
+        n5_file_unmap(view);
+
+        file = fopen(path, "rb");
+        assert(file != NULL);
+
+        LineReader reader;
+        bool success = LineReader_init(&reader, &mainAlloc.base, file, 16, '\n');
+        assert(success);
+
+        printf("LineReader (initial buffer: %zu):\n", reader.buffer.size);
+        while (LineReader_next(&reader, &line)) {
+            printf("| '%.*s' (buffer: %zu)\n", (int)line.size, line.data, reader.buffer.size);
+        }
+
+        LineReader_deinit(&reader);
+        fclose(file);
+        remove(path);
+    }
+
+    printf("\n");
+
+    {
+        // note: TestAlloc isn't thread-safe, but JobSystem only uses its owner in init/deinit.
+        JobSystem jobs;
+        bool success = JobSystem_init(&jobs, &mainAlloc.base, 4, 64 * 1024);
+        assert(success);
+
+        int64_t nums[1000];
+        for (size_t i = 0; i < n5_arraySize(nums); ++i) {
+            nums[i] = (int64_t)i;
+        }
+
+        SquareSums sums = { .nums = Slice_fromArray(nums) };
+        atomic_init(&sums.total, 0);
+        JobSystem_parallelForSlice(&jobs, sums.nums, 64, SquareSums_chunk, &sums);
+        JobSystem_resetArenas(&jobs);
+        printf(
+            "JobSystem (%zu workers) - parallel sum of squares: %lld\n",
+            jobs.workers.size,
+            (long long)atomic_load(&sums.total)
+        );
+
+        JobSystem_deinit(&jobs);
+    }
+
+    printf("\n");
+
+    {
+        SpscQueue spsc;
+        bool success = SpscQueue_init(&spsc, &mainAlloc.base, 8, sizeof(int64_t));
+        assert(success);
+
+        thrd_t producer;
+        success = thrd_create(&producer, SpscQueue_produce, &spsc) == thrd_success;
+        assert(success);
+        int64_t total = 0;
+        for (size_t received = 0; received < 100;) {
+            int64_t batch[4];
+            const size_t count = SpscQueue_popBatch(&spsc, batch, n5_arraySize(batch));
+            for (size_t i = 0; i < count; ++i) {
+                total += batch[i];
+            }
+            received += count;
+            if (count == 0) {
+                thrd_yield();
+            }
+        }
+        thrd_join(producer, NULL);
+        printf("SpscQueue (capacity: %zu) - sum of 1..100 from another thread: %lld\n", spsc.mask + 1, (long long)total);
+        SpscQueue_deinit(&spsc);
+
+        MpmcQueue mpmc;
+        success = MpmcQueue_init(&mpmc, &mainAlloc.base, 5, sizeof(Point));
+        assert(success);
+        const Point points[] = { { 1, 2 }, { 3, 4 }, { 5, 6 }, { 7, 8 }, { 9, 10 }, { 11, 12 }, { 13, 14 }, { 15, 16 }, { 17, 18 } };
+        const size_t pushed = MpmcQueue_pushSlice(&mpmc, ((Slice(const Point))Slice_fromArray(points)));
+        Point first;
+        MpmcQueue_pop(&mpmc, &first);
+        printf(
+            "MpmcQueue (capacity: %zu) - pushed %zu of %zu, first (%lld, %lld), %zu left\n",
+            mpmc.mask + 1,
+            pushed,
+            n5_arraySize(points),
+            (long long)first.x,
+            (long long)first.y,
+            MpmcQueue_size(&mpmc)
+        );
+        MpmcQueue_deinit(&mpmc);
+    }
+
+    printf("\n");
+
+    {
+        // note: TestAlloc isn't thread-safe, so the consumer thread gets its own allocator.
+        Allocator stdAlloc = StdAlloc_init();
+
+        Logger logger;
+        bool success = Logger_init(&logger, &stdAlloc, stdout, log_overflow_count);
+        assert(success);
+
+        LogProducer producer;
+        success = LogProducer_init(&producer, &logger, &mainAlloc.base, 4096);
+        assert(success);
+
+        printf("Logger (ring capacity: %zu):\n", producer.mask + 1);
+        for (int64_t i = 0; i < 4; ++i) {
+            char name[] = "record #";
+            Log_write(
+                &producer,
+                cstr_literal("| Log_write {}{}: {} {}"),
+                FormatArg_str(cstr_literal(name)),
+                FormatArg_i64(i),
+                FormatArg_f64(i * 0.5),
+                FormatArg_bool(i % 2 == 0)
+            );
+            // the payload is copied, so the caller's buffer may be reused immediately.
+            name[0] = 'X';
+        }
+
+        LogProducer_deinit(&producer);
+        Logger_deinit(&logger);
+    }
+
+    printf("\n");
+
+    {
+        String buffer = String_new(&mainAlloc.base, 16);
+        BinWriter writer = BinWriter_fromString(&buffer);
+        uint64_t ids[] = { 1, 127, 128, 300, 1ull << 40 };
+        bool success = BinWriter_write_u32(&writer, 0x4e35)
+            && BinWriter_write_varI64(&writer, -42)
+            && BinWriter_write_f64(&writer, 3.5)
+            && BinWriter_write_blob(&writer, cstr_literal("payload"))
+            && BinWriter_write_varU64(&writer, n5_arraySize(ids))
+            && BinWriter_write_varU64s(&writer, (u64s)Slice_fromArray(ids));
+        assert(success);
+        printf("BinWriter - %zu bytes:", buffer.str.size);
+        for (size_t i = 0; i < buffer.str.size; ++i) {
+            printf(" %02x", (uint8_t)buffer.str.data[i]);
+        }
+        printf("\n");
+
+        BinReader reader = BinReader_from(BinWriter_view(&writer));
+        uint32_t magic;
+        int64_t delta;
+        double ratio;
+        cstr blob;
+        uint64_t count;
+        uint64_t decoded[n5_arraySize(ids)];
+        success = BinReader_read_u32(&reader, &magic)
+            && BinReader_read_varI64(&reader, &delta)
+            && BinReader_read_f64(&reader, &ratio)
+            && BinReader_read_blob(&reader, &blob)
+            && BinReader_read_varU64(&reader, &count)
+            && count == n5_arraySize(decoded)
+            && BinReader_read_varU64s(&reader, (u64s)Slice_fromArray(decoded));
+        assert(success);
+        printf(
+            "BinReader - magic: %x, delta: %lld, ratio: %.1f, blob: '%.*s' (in place: %s), ids:",
+            magic,
+            (long long)delta,
+            ratio,
+            (int)blob.size,
+            blob.data,
+            (blob.data >= buffer.str.data && blob.data < buffer.str.data + buffer.str.size) ? "yes" : "no"
+        );
+        for (size_t i = 0; i < count; ++i) {
+            printf(" %llu", (unsigned long long)decoded[i]);
+        }
+        printf("\n");
+
+        // truncated input fails cleanly instead of reading past the end.
+        BinReader truncated = BinReader_from(cstr_slice(BinWriter_view(&writer), 0, 6));
+        printf("BinReader - truncated read succeeds: %s\n",
+            (BinReader_read_u32(&truncated, &magic) && BinReader_read_f64(&truncated, &ratio)) ? "yes" : "no");
+
+        String_free(&buffer);
+    }
+
+    printf("\n");
+
+    {
+        String text = String_new(&mainAlloc.base, 16);
+        JsonWriter writer = JsonWriter_from(&text);
+        bool success = JsonWriter_beginObject(&writer)
+            && JsonWriter_key(&writer, cstr_literal("name"))
+            && JsonWriter_write_str(&writer, cstr_literal("n5 \"json\""))
+            && JsonWriter_key(&writer, cstr_literal("ratio"))
+            && JsonWriter_write_f64(&writer, 0.05)
+            && JsonWriter_key(&writer, cstr_literal("ids"))
+            && JsonWriter_beginArray(&writer)
+            && JsonWriter_write_i64(&writer, -1)
+            && JsonWriter_write_u64(&writer, UINT64_MAX)
+            && JsonWriter_write_null(&writer)
+            && JsonWriter_endArray(&writer)
+            && JsonWriter_key(&writer, cstr_literal("ok"))
+            && JsonWriter_write_bool(&writer, true)
+            && JsonWriter_endObject(&writer);
+        assert(success);
+        printf("JsonWriter - %.*s\n", (int)text.str.size, text.str.data);
+
+        Arena arena;
+        success = Arena_init(&arena, &mainAlloc.base, JsonDoc_arenaSize(text.str.size));
+        assert(success);
+        JsonDoc doc;
+        success = JsonDoc_parse(&doc, &arena, cstr_cast(text.str));
+        assert(success);
+
+        const JsonNode *const root = JsonDoc_root(&doc);
+        const cstr name = JsonDoc_string(&doc, JsonDoc_find(&doc, root, cstr_literal("name")));
+        const JsonNode *const ids = JsonDoc_find(&doc, root, cstr_literal("ids"));
+        printf(
+            "JsonDoc - %zu nodes, name: '%.*s' (escaped: %s), ratio: %g, ids[1]: %llu, ids count: %u\n",
+            doc.count,
+            (int)name.size,
+            name.data,
+            JsonDoc_find(&doc, root, cstr_literal("name"))->unescaped ? "yes" : "no",
+            JsonDoc_find(&doc, root, cstr_literal("ratio"))->f64,
+            (unsigned long long)JsonDoc_at(&doc, ids, 1)->u64,
+            ids->count
+        );
+
+        // note: errors report the byte offset of the offending token.
+        printf("JsonDoc - parsing '[1, 2,]' succeeds: %s\n",
+            JsonDoc_parse(&doc, &arena, cstr_literal("[1, 2,]")) ? "yes" : "no");
+
+        Arena_deinit(&arena);
+        String_free(&text);
+    }
+
+    printf("\n");
+
+    {
+        // note: the quoted field with a newline straddles the two chunks.
+        const cstr input = cstr_literal("id,name,delta\r\n1,\"Smith, \"\"J\"\"\",-4\r\n2,\"two\nlines\",17\r\n3,plain,x\r\n");
+        const size_t split = 40;
+
+        Arena arena;
+        bool success = Arena_init(&arena, &mainAlloc.base, 256);
+        assert(success);
+        CsvReader reader;
+        success = CsvReader_init(&reader, &mainAlloc.base, &arena, ',', true);
+        assert(success);
+
+        printf("CsvReader - %zu bytes in chunks of %zu and %zu:\n", input.size, split, input.size - split);
+        for (size_t offset = 0; offset < input.size; offset += split) {
+            const size_t size = n5_min(split, input.size - offset);
+            CsvReader_feed(&reader, cstr_slice(input, offset, size), offset + size == input.size);
+
+            CsvRecord record;
+            while (CsvReader_next(&reader, &record)) {
+                int64_t delta;
+                printf("| %zu fields:", record.fields.size);
+                for (size_t i = 0; i < record.fields.size; ++i) {
+                    printf(" [%.*s]", (int)record.fields.data[i].size, record.fields.data[i].data);
+                }
+                if (CsvRecord_tryParse_i64(&record, 2, &delta)) {
+                    printf(" (delta %lld)", (long long)delta);
+                }
+                printf("\n");
+            }
+        }
+
+        CsvReader_deinit(&reader);
+        Arena_deinit(&arena);
+    }
+
+    printf("\n");
+
+    {
+        // note: trace buffers are allocated from whichever thread traces, so use a thread-safe owner.
+        Allocator stdAlloc = StdAlloc_init();
+        bool success = Trace_init(&stdAlloc, 256);
+        assert(success);
+
+        Trace_scope("tests.format") {
+            String string = String_new(&mainAlloc.base, 4);
+            for (int64_t i = 0; i < 3; ++i) {
+                String_format(&string, cstr_literal("{} squared is {}"), FormatArg_i64(i), FormatArg_i64(i * i));
+                Trace_counter("tests.size", string.str.size);
+            }
+            String_free(&string);
+        }
+
+        String trace = String_new(&stdAlloc, 256);
+        success = Trace_export(&trace);
+        assert(success);
+
+        // note: the export has one JSON line per event plus a line each for the header and footer.
+        printf(
+            "Trace (%s): %zu bytes of Chrome trace JSON, %zu lines\n",
+#if defined(N5_TRACE)
+            "enabled",
+#else
+            "compiled out",
+#endif
+            trace.str.size,
+            cstr_countChar(cstr_cast(trace.str), '\n')
+        );
+
+        String_free(&trace);
+        Trace_deinit();
+    }
+
+#if !defined(_WIN32)
+    printf("\n");
+
+    {
+        // note: buffers are released on this thread, so TestAlloc is fine even for the thread backend.
+        FILE *const file = tmpfile();
+        assert(file != NULL);
+
+        AsyncWriter writer;
+        bool success = AsyncWriter_init(&writer, &mainAlloc.base, fileno(file), 8, async_backend_auto);
+        assert(success);
+
+        for (uint64_t i = 0; i < 20; ++i) {
+            String line = String_new(&mainAlloc.base, 16);
+            String_append_str(&line, cstr_literal("| record "));
+            String_append_u64(&line, i, false);
+            String_append_char(&line, '\n');
+            success = AsyncWriter_writeString(&writer, &line);
+            assert(success);
+        }
+        success = AsyncWriter_write(&writer, cstr_literal("| borrowed tail\n"), NULL, (Block) { 0 });
+        assert(success);
+        success = AsyncWriter_flush(&writer);
+        assert(success);
+
+        printf(
+            "AsyncWriter (%s backend, queue depth: %zu):\n",
+            (writer.backend == async_backend_uring) ? "io_uring" : "thread",
+            writer.entries.size
+        );
+        AsyncWriter_deinit(&writer);
+
+        rewind(file);
+        char buffer[64];
+        size_t lines = 0;
+        while (fgets(buffer, sizeof(buffer), file) != NULL) {
+            if (lines++ % 5 == 0) {
+                fputs(buffer, stdout);
+            }
+        }
+        printf("(%zu lines written)\n", lines);
+        fclose(file);
+    }
+#endif
+
     TestAlloc_deinit(&mainAlloc);
 
     return 0;